@@ -0,0 +1,43 @@
+#include "bench.h"
+#include "uri_parser.h"
+
+#include <string>
+
+int main()
+{
+    namespace qi = boost::spirit::qi;
+
+    const std::string input("http://user@www.makefile.com:8080/search?q=spirit");
+    const char *first = input.data();
+    const char *last = first + input.size();
+
+    uri::uri_t uri;
+
+    uri::uri_parser<const char *> plain(uri);
+    bench::run("uri_parser, no cache", 500000, [&] {
+        const char *cur = first;
+        bench::do_not_optimize(qi::parse(cur, last, plain));
+    }, input.size());
+
+    uri::authority_cache cache;
+    uri::uri_parser<const char *> cached(uri, &cache);
+    bench::run("uri_parser, authority_cache hit", 500000, [&] {
+        const char *cur = first;
+        bench::do_not_optimize(qi::parse(cur, last, cached));
+    }, input.size());
+    std::printf("hits %llu misses %llu\n",
+                static_cast<unsigned long long>(cache.hits()),
+                static_cast<unsigned long long>(cache.misses()));
+
+    const std::string ipv6("http://[2001:db8:85a3::8a2e:370:7334]:443/");
+    bench::run("uri_parser, IPv6 literal, no cache", 500000, [&] {
+        const char *cur = ipv6.data();
+        bench::do_not_optimize(qi::parse(cur, ipv6.data() + ipv6.size(), plain));
+    }, ipv6.size());
+    bench::run("uri_parser, IPv6 literal, authority_cache hit", 500000, [&] {
+        const char *cur = ipv6.data();
+        bench::do_not_optimize(qi::parse(cur, ipv6.data() + ipv6.size(), cached));
+    }, ipv6.size());
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+#ifndef __bench_h__
+#define __bench_h__
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+namespace bench
+{
+    // Keeps the optimiser from discarding a result we only compute for timing.
+    template <typename T>
+    inline void do_not_optimize(const T &value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * Run fn() iterations times and report the mean cost per call (and per
+     * byte, when bytes is the amount of input a single call consumes).
+     */
+    template <typename Fn>
+    inline double run(const char *name, std::size_t iterations, Fn fn, std::size_t bytes = 0)
+    {
+        typedef std::chrono::steady_clock clock;
+
+        // warm up caches and any lazily built state
+        for (std::size_t i = 0; i < iterations / 10 + 1; ++i) {
+            fn();
+        }
+
+        clock::time_point start = clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            fn();
+        }
+        clock::time_point stop = clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+        if (bytes) {
+            std::printf("%-48s %10.1f ns/op %8.2f ns/byte\n", name, ns, ns / bytes);
+        }
+        else {
+            std::printf("%-48s %10.1f ns/op\n", name, ns);
+        }
+        return ns;
+    }
+} // namespace bench
+
+#endif // __bench_h__
@@ -0,0 +1,71 @@
+#include "bench.h"
+#include "byte_range.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Splitting the value with a stream, as a Range header is often read.
+static std::size_t stream_ranges(const std::string &value, std::vector<std::pair<long long, long long> > &out)
+{
+    out.clear();
+    if (value.compare(0, 6, "bytes=") != 0) {
+        return 0;
+    }
+    std::istringstream in(value.substr(6));
+    std::string spec;
+    while (std::getline(in, spec, ',')) {
+        std::istringstream range(spec);
+        long long first = -1, last = -1;
+        char dash;
+        if (spec[0] == '-') {
+            range >> dash >> last;
+        }
+        else {
+            range >> first >> dash;
+            if (!(range >> last)) {
+                last = -1;
+            }
+        }
+        out.push_back(std::make_pair(first, last));
+    }
+    return out.size();
+}
+
+int main()
+{
+    const char *values[] = {
+        "bytes=0-1023",
+        "bytes=1048576-2097151",
+        "bytes=0-1023,2048-",
+        "bytes=-500",
+        "bytes=0-99,200-299,400-499,600-699,800-899,1000-1099,1200-1299,1400-1499"
+    };
+    const std::size_t count = sizeof(values) / sizeof(values[0]);
+    std::vector<std::string> strings(values, values + count);
+
+    std::vector<std::pair<long long, long long> > pairs;
+    bench::run("istringstream", 20000, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            bench::do_not_optimize(stream_ranges(strings[i], pairs));
+        }
+    });
+
+    http11::byte_ranges_t ranges;
+    bench::run("parse_byte_ranges", 20000, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            http11::parse_byte_ranges(strings[i], ranges);
+            bench::do_not_optimize(ranges);
+        }
+    });
+
+    bench::run("parse_byte_ranges + resolve", 20000, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            http11::parse_byte_ranges(strings[i], ranges);
+            ranges.resolve(1 << 30, 80);
+            bench::do_not_optimize(ranges);
+        }
+    });
+
+    return 0;
+}
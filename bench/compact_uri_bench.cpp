@@ -0,0 +1,62 @@
+#include "bench.h"
+#include "compact_uri.h"
+#include "uri_parser.h"
+
+#include <string>
+#include <vector>
+
+// What keeping a URI used to take: the components as strings.
+struct string_uri
+{
+    std::string scheme, user_info, host, port, path, query, fragment;
+
+    explicit string_uri(const uri::uri_t &it) :
+        scheme(it.scheme.raw()), user_info(it.user_info.raw()), host(it.host.raw()), port(it.port.raw()),
+        path(it.path.raw()), query(it.query.raw()), fragment(it.fragment.raw())
+    { }
+};
+
+int main()
+{
+    const char *inputs[] = {
+        "http://www.makefile.com/index.html",
+        "https://user@www.makefile.com:8443/api/v1/users/42/posts?sort=desc&page=3#comments",
+    };
+
+    std::printf("sizeof(uri_t) %zu, sizeof(string_uri) %zu, sizeof(compact_uri) %zu\n",
+                sizeof(uri::uri_t), sizeof(string_uri), sizeof(uri::compact_uri));
+
+    uri::uri_t uri;
+    uri::uri_parser<const char *> grammar(uri);
+    for (std::size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        const std::string input(inputs[i]);
+        const char *first = input.data();
+        boost::spirit::qi::parse(first, first + input.size(), grammar);
+        std::printf("%s (%zu bytes)\n", inputs[i], input.size());
+
+        bench::run("  keep as strings", 1000000, [&] {
+            string_uri kept(uri);
+            bench::do_not_optimize(kept);
+        });
+        bench::run("  keep as compact_uri", 1000000, [&] {
+            uri::compact_uri kept(uri);
+            bench::do_not_optimize(kept);
+        });
+
+        string_uri strings(uri);
+        uri::compact_uri compact(uri);
+        bench::run("  copy strings", 1000000, [&] {
+            string_uri copy(strings);
+            bench::do_not_optimize(copy);
+        });
+        bench::run("  copy compact_uri", 1000000, [&] {
+            uri::compact_uri copy(compact);
+            bench::do_not_optimize(copy);
+        });
+        bench::run("  compact_uri::view", 1000000, [&] {
+            bench::do_not_optimize(compact.view());
+        });
+    }
+
+    return 0;
+}
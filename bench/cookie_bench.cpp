@@ -0,0 +1,93 @@
+#include "bench.h"
+#include "cookie.h"
+
+#include <cstdlib>
+#include <map>
+#include <string>
+
+// The map the header is split into today: every cookie copied.
+static void split_to_map(const std::string &value, std::map<std::string, std::string> &out)
+{
+    out.clear();
+    std::string::size_type pos = 0;
+    while (pos < value.size()) {
+        std::string::size_type end = value.find(';', pos);
+        if (end == std::string::npos) {
+            end = value.size();
+        }
+        std::string pair = value.substr(pos, end - pos);
+        std::string::size_type eq = pair.find('=');
+        if (eq != std::string::npos) {
+            std::string::size_type name = pair.find_first_not_of(' ');
+            out.insert(std::make_pair(pair.substr(name, eq - name), pair.substr(eq + 1)));
+        }
+        pos = end + 1;
+    }
+}
+
+int main()
+{
+    // A 6KB Cookie header of analytics and preference cookies, the
+    // session cookies somewhere in the middle.
+    std::srand(50);
+    std::string value;
+    for (int i = 0; i < 120; ++i) {
+        if (i == 60) {
+            value += "session=8c3f0e1b2a4d5c6e7f8091a2b3c4d5e6; ";
+        }
+        if (i == 75) {
+            value += "csrf=\"Zm9vYmFyYmF6cXV4\"; ";
+        }
+        value += "_ga_" + std::to_string(i) + "=GA1.2." + std::to_string(std::rand()) + "."
+               + std::string(std::rand() % 30, 'x') + "; ";
+    }
+    value += "lang=en";
+    std::printf("Cookie header: %zu bytes\n", value.size());
+
+    std::map<std::string, std::string> map;
+    bench::run("split into std::map, two lookups", 2000, [&] {
+        split_to_map(value, map);
+        bench::do_not_optimize(map["session"]);
+        bench::do_not_optimize(map["csrf"]);
+    }, value.size());
+
+    bench::run("cookie_iterator, whole header", 2000, [&] {
+        std::size_t n = 0;
+        for (const http11::cookie_t &c : http11::cookies(value)) {
+            n += c.value.size();
+        }
+        bench::do_not_optimize(n);
+    }, value.size());
+
+    boost::string_ref names[] = { "session", "csrf" };
+    boost::string_ref found[2];
+    bench::run("find_cookies, session and csrf", 2000, [&] {
+        bench::do_not_optimize(http11::find_cookies(value, names, found, 2));
+    }, value.size());
+
+    // The ';' scan on its own against memchr.
+    const char *last = value.data() + value.size();
+    bench::run("';' boundaries, scan::semicolon", 2000, [&] {
+        std::size_t n = 0;
+        for (const char *p = value.data(); p != last; ++p, ++n) {
+            p = http11::scan::semicolon(p, last);
+            if (p == last) {
+                break;
+            }
+        }
+        bench::do_not_optimize(n);
+    }, value.size());
+
+    bench::run("';' boundaries, memchr", 2000, [&] {
+        std::size_t n = 0;
+        for (const char *p = value.data(); p != last; ++p, ++n) {
+            p = static_cast<const char *>(std::memchr(p, ';', last - p));
+            if (!p) {
+                break;
+            }
+        }
+        bench::do_not_optimize(n);
+    }, value.size());
+
+    return 0;
+}
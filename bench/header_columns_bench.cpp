@@ -0,0 +1,55 @@
+#include "bench.h"
+#include "header_columns.h"
+#include "http11_parser.h"
+
+#include <string>
+
+int main()
+{
+    const std::string request(
+        "GET /search?q=spirit+parsers&page=3 HTTP/1.1\r\n"
+        "Host: www.makefile.com\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:49.0) Gecko/20100101 Firefox/49.0\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+        "Accept-Language: en-US,en;q=0.5\r\n"
+        "Accept-Encoding: gzip, deflate, br\r\n"
+        "Referer: http://www.makefile.com/\r\n"
+        "Cookie: session_id=4f9c2a1be0d34c58; theme=dark; tz=America%2FNew_York\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n");
+
+    // A batch of requests back to back, as read from a capture.
+    std::string batch;
+    for (int i = 0; i < 1000; ++i) {
+        batch += request;
+    }
+    const char *last = batch.data() + batch.size();
+
+    http11::request_t req;
+    http11::request_parser<const char *> grammar(req);
+    bench::run("request_parser, map of all headers, x1000", 20, [&] {
+        const char *first = batch.data();
+        while (first != last) {
+            req.clear();
+            boost::spirit::qi::parse(first, last, grammar);
+            bench::do_not_optimize(req.headers["Host"]);
+            first += 2;
+        }
+    }, batch.size());
+
+    http11::header_columns columns;
+    columns.add("Host");
+    columns.add("User-Agent");
+    columns.add("Referer");
+    columns.reserve(1000);
+    bench::run("header_columns, 3 columns, x1000", 200, [&] {
+        columns.clear();
+        const char *first = batch.data();
+        while (first != last && columns.parse(batch.data(), first, last)) {
+            first += 2;
+        }
+        bench::do_not_optimize(columns.offsets(0)[999]);
+    }, batch.size());
+
+    return 0;
+}
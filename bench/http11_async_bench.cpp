@@ -0,0 +1,93 @@
+#include "bench.h"
+#include "http11_async.h"
+
+#include <string>
+
+#include <unistd.h>
+
+namespace
+{
+    const std::string request(
+        "GET /search?q=spirit+parsers&page=3 HTTP/1.1\r\n"
+        "Host: www.makefile.com\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:49.0) Gecko/20100101 Firefox/49.0\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+        "Accept-Language: en-US,en;q=0.5\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n");
+
+    const std::size_t batch = 100;
+
+    // Parse batch pipelined requests arriving chunk bytes at a time.
+    void from_memory(const std::string &input, std::size_t chunk)
+    {
+        http11::memory_source source(input.data(), input.data() + input.size(), chunk);
+        http11::async_request_reader<http11::memory_source> reader(source);
+        http11::request_t req;
+        for (std::size_t i = 0; i < batch; ++i) {
+            http11::task<http11::read_status_t> t = reader.read(req);
+            t.start();
+            bench::do_not_optimize(t.result());
+        }
+    }
+}
+
+int main()
+{
+    std::string input;
+    for (std::size_t i = 0; i < batch; ++i) {
+        input += request;
+    }
+
+    // Per request figures: each run parses batch requests.
+    char name[64];
+    std::size_t chunks[] = { input.size(), 4096, 512, 64 };
+    for (std::size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i) {
+        std::snprintf(name, sizeof(name), "memory_source, %zu byte reads (x%zu)", chunks[i], batch);
+        bench::run(name, 2000, [&] { from_memory(input, chunks[i]); }, input.size());
+    }
+
+    // The request is written to a pipe and read back through io_loop, one
+    // request per wake-up: the latency a server would see for a request
+    // arriving on an idle connection.
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        return 1;
+    }
+    http11::io_loop loop;
+    http11::pipe_source source(fds[0], loop);
+    http11::async_request_reader<http11::pipe_source> reader(source);
+    http11::request_t req;
+    bench::run("pipe_source, write + wake-up + parse", 100000, [&] {
+        http11::task<http11::read_status_t> t = reader.read(req);
+        t.start();
+        if (::write(fds[1], request.data(), request.size()) != static_cast<ssize_t>(request.size())) {
+            return;
+        }
+        while (!t.done()) {
+            loop.run_once();
+        }
+        bench::do_not_optimize(t.result());
+    }, request.size());
+
+    // The same without the coroutine front end: write, read into a buffer,
+    // parse.
+    std::string buf(4096, '\0');
+    http11::request_t plain_req;
+    http11::request_parser<const char *> grammar(plain_req);
+    bench::run("pipe, blocking read + request_parser", 100000, [&] {
+        if (::write(fds[1], request.data(), request.size()) != static_cast<ssize_t>(request.size())) {
+            return;
+        }
+        ssize_t n;
+        do {
+            n = ::read(fds[0], &buf[0], buf.size());
+        } while (n < 0);
+        plain_req.clear();
+        const char *first = buf.data();
+        const char *last = buf.data() + n;
+        bench::do_not_optimize(boost::spirit::qi::parse(first, last, grammar));
+    }, request.size());
+
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include "bench.h"
+#include "http11_parser.h"
+#include "http11_writer.h"
+
+#include <string>
+
+int main()
+{
+    const std::string request(
+        "GET /search?q=spirit+parsers&page=3 HTTP/1.1\r\n"
+        "Host: www.makefile.com\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:49.0) Gecko/20100101 Firefox/49.0\r\n"
+        "Accept: */*\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n");
+
+    http11::request_t req;
+    http11::request_parser<const char *> grammar(req);
+    const char *first = request.data();
+    boost::spirit::qi::parse(first, request.data() + request.size(), grammar);
+
+    bench::run("request_t::to_string", 200000, [&] {
+        bench::do_not_optimize(req.to_string());
+    });
+
+    char buf[1024];
+    bench::run("write, buffer_writer", 1000000, [&] {
+        http11::buffer_writer out(buf, sizeof(buf));
+        http11::write(out, req);
+        bench::do_not_optimize(out.size());
+    }, request.size());
+
+    iovec iov[32];
+    bench::run("write, iovec_writer over the source", 1000000, [&] {
+        http11::iovec_writer out(iov, 32, request.data(), request.data() + request.size());
+        http11::write(out, req);
+        bench::do_not_optimize(out.count());
+    }, request.size());
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "bench.h"
+#include "http_date.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// bench::run reports per batch; the figure that matters is per date.
+static const std::size_t count = 1024;
+
+static void per_date(double ns)
+{
+    std::printf("%-48s %10.1f ns/date\n", "", ns / count);
+}
+
+int main()
+{
+    // If-Modified-Since values: distinct ones, and the one a client
+    // repeats for every conditional request of the same resource.
+    std::srand(48);
+    std::vector<std::string> dates;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::time_t t = static_cast<std::time_t>(std::rand()) % 2000000000;
+        std::tm utc;
+        gmtime_r(&t, &utc);
+        char value[64];
+        std::strftime(value, sizeof(value), "%a, %d %b %Y %H:%M:%S GMT", &utc);
+        dates.push_back(value);
+    }
+    std::vector<std::string> same(count, dates[0]);
+
+    per_date(bench::run("strptime + timegm", 200, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            std::tm tm = std::tm();
+            strptime(dates[i].c_str(), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+            bench::do_not_optimize(timegm(&tm));
+        }
+    }));
+
+    http11::http_date<const char *> grammar;
+    per_date(bench::run("http_date grammar", 200, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            const char *first = dates[i].data();
+            std::time_t t = 0;
+            boost::spirit::qi::parse(first, first + dates[i].size(), grammar, t);
+            bench::do_not_optimize(t);
+        }
+    }));
+
+    per_date(bench::run("parse_http_date, distinct", 200, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            std::time_t t = 0;
+            http11::parse_http_date(dates[i], t);
+            bench::do_not_optimize(t);
+        }
+    }));
+
+    per_date(bench::run("parse_http_date, repeated", 200, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            std::time_t t = 0;
+            http11::parse_http_date(same[i], t);
+            bench::do_not_optimize(t);
+        }
+    }));
+
+    return 0;
+}
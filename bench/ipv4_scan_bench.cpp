@@ -0,0 +1,76 @@
+#include "bench.h"
+#include "ipv4_address.h"
+#include "ipv4_scan.h"
+
+#include <arpa/inet.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// bench::run reports per batch; the figure that matters is per address.
+static const std::size_t count = 4096;
+
+static void per_address(double ns)
+{
+    std::printf("%-48s %10.1f ns/address\n", "", ns / count);
+}
+
+int main()
+{
+    // A log's worth of client addresses, lengths spread from 7 to 15 bytes.
+    std::srand(44);
+    std::vector<std::string> addresses;
+    std::string lines;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::string a;
+        for (int octet = 0; octet < 4; ++octet) {
+            int width = std::rand() % 3;
+            a += (octet ? "." : "") + std::to_string(width == 0 ? std::rand() % 10 : width == 1 ? 10 + std::rand() % 90 : 100 + std::rand() % 156);
+        }
+        addresses.push_back(a);
+        lines += a + '\n';
+    }
+    std::vector<boost::string_ref> spans(addresses.begin(), addresses.end());
+    std::vector<uint32_t> addrs(count);
+    std::vector<uint64_t> valid((count + 63) / 64);
+    std::printf("%zu addresses, %zu bytes\n", count, lines.size());
+
+    uri::ipv4_address<const char *> grammar;
+    per_address(bench::run("ipv4_address grammar", 200, [&] {
+        std::string parsed;
+        for (std::size_t i = 0; i < count; ++i) {
+            const char *first = spans[i].data();
+            parsed.clear();
+            boost::spirit::qi::parse(first, first + spans[i].size(), grammar, parsed);
+            bench::do_not_optimize(parsed);
+        }
+    }));
+
+    per_address(bench::run("inet_pton", 200, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            in_addr a;
+            inet_pton(AF_INET, addresses[i].c_str(), &a);
+            bench::do_not_optimize(a);
+        }
+    }));
+
+    per_address(bench::run("scan::ipv4 (scalar)", 200, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            const char *first = spans[i].data();
+            uri::scan::ipv4(first, first + spans[i].size(), addrs[i]);
+        }
+        bench::do_not_optimize(addrs[0]);
+    }));
+
+    per_address(bench::run("parse_ipv4 spans", 200, [&] {
+        bench::do_not_optimize(uri::parse_ipv4(spans.data(), count, addrs.data(), valid.data()));
+    }));
+
+    per_address(bench::run("parse_ipv4 delimited buffer", 200, [&] {
+        const char *first = lines.data();
+        bench::do_not_optimize(uri::parse_ipv4(first, first + lines.size(), '\n', addrs.data(), valid.data(), count));
+    }));
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "bench.h"
+#include "parser_pool.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Have threads workers each check a grammar out of the pool and return it
+// requests times, parsing a request with it when parse is set, and report
+// the total rate. Without parsing this is the checkout/return path alone.
+double run_threads(http11::request_pool &pool, const std::string &input, int threads, std::size_t requests, bool parse)
+{
+    typedef std::chrono::steady_clock clock;
+
+    std::vector<std::thread> workers;
+    clock::time_point start = clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([&pool, &input, requests, parse] {
+            for (std::size_t i = 0; i < requests; ++i) {
+                http11::request_pool::lease parser = pool.checkout();
+                if (parse) {
+                    const char *first = input.data();
+                    bench::do_not_optimize(parser.parse(first, input.data() + input.size()));
+                }
+                else {
+                    bench::do_not_optimize(parser.result().method.size());
+                }
+            }
+        }));
+    }
+    for (int t = 0; t < threads; ++t) {
+        workers[t].join();
+    }
+    clock::time_point stop = clock::now();
+
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    return threads * requests / seconds;
+}
+
+int main()
+{
+    namespace qi = boost::spirit::qi;
+
+    const std::string input(
+        "GET /search?q=spirit HTTP/1.1\r\n"
+        "Host: www.makefile.com\r\n"
+        "User-Agent: bench/1.0\r\n"
+        "Accept: */*\r\n");
+    const char *last = input.data() + input.size();
+
+    http11::request_t req;
+    bench::run("request_parser built per request", 2000, [&] {
+        const char *first = input.data();
+        http11::request_parser<const char *> grammar(req);
+        bench::do_not_optimize(qi::parse(first, last, grammar));
+    }, input.size());
+
+    http11::request_pool pool;
+    bench::run("request_pool checkout per request", 200000, [&] {
+        const char *first = input.data();
+        http11::request_pool::lease parser = pool.checkout();
+        bench::do_not_optimize(parser.parse(first, last));
+    }, input.size());
+
+    bench::run("request_pool checkout and return", 2000000, [&] {
+        http11::request_pool::lease parser = pool.checkout();
+        bench::do_not_optimize(parser.result().method.size());
+    });
+
+    std::printf("\n%8s %16s %16s %16s %16s\n", "threads", "checkouts/s", "per thread", "requests/s", "per thread");
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        double checkouts = run_threads(pool, input, threads, 4000000 / threads, false);
+        double rate = run_threads(pool, input, threads, 400000 / threads, true);
+        std::printf("%8d %16.0f %16.0f %16.0f %16.0f\n", threads, checkouts, checkouts / threads, rate, rate / threads);
+    }
+    std::printf("grammars built: %zu, hardware threads: %u\n", pool.size(), std::thread::hardware_concurrency());
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "bench.h"
+#include "cidr_address.h"
+#include "prefix_table.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// The usual first attempt: a hash table per prefix length, longest first.
+struct hash_per_length
+{
+    std::unordered_map<uint32_t, uint32_t> by_length[33];
+    std::vector<unsigned> lengths;  // present, longest first
+
+    void add(uint32_t address, unsigned length, uint32_t value)
+    {
+        by_length[length][address] = value;
+    }
+
+    void build()
+    {
+        lengths.clear();
+        for (int length = 32; length >= 0; --length) {
+            if (!by_length[length].empty()) {
+                lengths.push_back(length);
+            }
+        }
+    }
+
+    uint32_t match(uint32_t address) const
+    {
+        for (std::size_t i = 0; i < lengths.size(); ++i) {
+            unsigned length = lengths[i];
+            uint32_t mask = length ? ~uint32_t(0) << (32 - length) : 0;
+            std::unordered_map<uint32_t, uint32_t>::const_iterator found = by_length[length].find(address & mask);
+            if (found != by_length[length].end()) {
+                return found->second;
+            }
+        }
+        return uri::prefix_table::no_match;
+    }
+};
+
+// Prefix lengths roughly as in a full BGP table: mostly /24, then /22,
+// /23, /20 and /21, a few short ones.
+unsigned random_length()
+{
+    int r = std::rand() % 100;
+    return r < 58 ? 24 : r < 70 ? 22 : r < 79 ? 23 : r < 85 ? 21 : r < 90 ? 20
+         : r < 93 ? 19 : r < 96 ? 16 : r < 98 ? 17 + std::rand() % 2 : 8 + std::rand() % 8;
+}
+
+int main()
+{
+    const std::size_t count = 100000;
+    const std::size_t lookups = 1 << 16;
+
+    // Prefixes as text, the way allow / deny lists arrive.
+    std::srand(45);
+    std::vector<std::string> lines;
+    for (std::size_t i = 0; i < count; ++i) {
+        uint32_t address = (1 + std::rand() % 223) << 24 | (std::rand() & 0xffffff);
+        lines.push_back(std::to_string(address >> 24) + "." + std::to_string(address >> 16 & 0xff) + "."
+                        + std::to_string(address >> 8 & 0xff) + "." + std::to_string(address & 0xff)
+                        + "/" + std::to_string(random_length()));
+    }
+
+    typedef std::chrono::steady_clock clock;
+    clock::time_point start = clock::now();
+    uri::cidr_address<const char *> grammar;
+    std::vector<uri::cidr_t> prefixes(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const char *first = lines[i].data();
+        boost::spirit::qi::parse(first, first + lines[i].size(), grammar, prefixes[i]);
+    }
+    clock::time_point parsed = clock::now();
+
+    uri::prefix_table table;
+    for (std::size_t i = 0; i < count; ++i) {
+        table.add(prefixes[i], static_cast<uint32_t>(i));
+    }
+    table.build();
+    clock::time_point built = clock::now();
+
+    hash_per_length hashes;
+    for (std::size_t i = 0; i < count; ++i) {
+        hashes.add(prefixes[i].ipv4(), prefixes[i].length, static_cast<uint32_t>(i));
+    }
+    hashes.build();
+
+    std::printf("%zu IPv4 prefixes: parsed in %.1f ms, built in %.1f ms, %zu KB\n", table.size(),
+                std::chrono::duration<double, std::milli>(parsed - start).count(),
+                std::chrono::duration<double, std::milli>(built - parsed).count(), table.bytes() / 1024);
+
+    // Half the lookups land inside a listed prefix.
+    std::vector<uint32_t> addresses(lookups);
+    for (std::size_t i = 0; i < lookups; ++i) {
+        addresses[i] = i % 2 ? prefixes[std::rand() % count].ipv4() | (std::rand() & 0xff)
+                             : static_cast<uint32_t>(std::rand()) << 1 ^ std::rand();
+    }
+    std::size_t hits = 0;
+    for (std::size_t i = 0; i < lookups; ++i) {
+        uint32_t found = table.match(addresses[i]);
+        if (found != hashes.match(addresses[i])) {
+            std::printf("mismatch\n");
+            return 1;
+        }
+        hits += found != uri::prefix_table::no_match;
+    }
+    std::printf("%zu of %zu lookups match\n", hits, lookups);
+
+    std::size_t i = 0;
+    bench::run("prefix_table::match (IPv4)", 10000000, [&] {
+        bench::do_not_optimize(table.match(addresses[i++ & (lookups - 1)]));
+    });
+    i = 0;
+    bench::run("prefix_table::match (IPv4, 256 hot addresses)", 10000000, [&] {
+        bench::do_not_optimize(table.match(addresses[i++ & 255]));
+    });
+    i = 0;
+    bench::run("hash per prefix length (IPv4)", 1000000, [&] {
+        bench::do_not_optimize(hashes.match(addresses[i++ & (lookups - 1)]));
+    });
+
+    // IPv6: allocations are /32 to /48.
+    uri::prefix_table table6;
+    std::vector<uri::cidr_t> prefixes6(count / 5);
+    for (std::size_t j = 0; j < prefixes6.size(); ++j) {
+        uint8_t bytes[16] = { 0x20, static_cast<uint8_t>(std::rand() % 16) };
+        for (int b = 2; b < 8; ++b) {
+            bytes[b] = static_cast<uint8_t>(std::rand());
+        }
+        prefixes6[j].assign(uri::cidr_t::family_ipv6, bytes, 32 + std::rand() % 17);
+        table6.add(prefixes6[j], static_cast<uint32_t>(j));
+    }
+    start = clock::now();
+    table6.build();
+    built = clock::now();
+    std::printf("%zu IPv6 prefixes: built in %.1f ms, %zu KB\n", table6.size(),
+                std::chrono::duration<double, std::milli>(built - start).count(), table6.bytes() / 1024);
+
+    std::vector<std::vector<uint8_t> > addresses6(lookups, std::vector<uint8_t>(16));
+    for (std::size_t j = 0; j < lookups; ++j) {
+        std::memcpy(addresses6[j].data(), prefixes6[std::rand() % prefixes6.size()].bytes, 16);
+        addresses6[j][15] = static_cast<uint8_t>(std::rand());
+        if (j % 2) {
+            addresses6[j][5] ^= 0x10;
+        }
+    }
+    i = 0;
+    bench::run("prefix_table::match (IPv6)", 10000000, [&] {
+        const uint8_t (&a)[16] = *reinterpret_cast<const uint8_t (*)[16]>(addresses6[i++ & (lookups - 1)].data());
+        bench::do_not_optimize(table6.match(a));
+    });
+    i = 0;
+    bench::run("prefix_table::match (IPv6, 256 hot addresses)", 10000000, [&] {
+        const uint8_t (&a)[16] = *reinterpret_cast<const uint8_t (*)[16]>(addresses6[i++ & 255].data());
+        bench::do_not_optimize(table6.match(a));
+    });
+
+    return 0;
+}
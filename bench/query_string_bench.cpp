@@ -0,0 +1,56 @@
+#include "bench.h"
+#include "query_string.h"
+
+#include <map>
+#include <string>
+
+int main()
+{
+    const std::string query(
+        "utm_source=newsletter&utm_medium=email&utm_campaign=october%202016"
+        "&q=spirit+parsers&page=3&per_page=50&sort=updated&order=desc"
+        "&session_id=4f9c2a1be0d34c58&lang=en-US&tz=America%2FNew_York");
+
+    // Old approach: split and decode every pair into a map, then look up.
+    std::size_t found = 0;
+    bench::run("split + decode into std::map", 200000, [&] {
+        std::map<std::string, std::string> params;
+        std::string::size_type pos = 0;
+        while (pos <= query.size()) {
+            std::string::size_type amp = query.find('&', pos);
+            if (amp == std::string::npos) {
+                amp = query.size();
+            }
+            std::string::size_type eq = query.find('=', pos);
+            if (eq > amp) {
+                eq = amp;
+            }
+            std::string key, value;
+            uri::percent_decode(query.data() + pos, query.data() + eq, key, true);
+            if (eq < amp) {
+                uri::percent_decode(query.data() + eq + 1, query.data() + amp, value, true);
+            }
+            params[key] = value;
+            pos = amp + 1;
+        }
+        found += params.count("session_id") + params.count("lang");
+        bench::do_not_optimize(found);
+    }, query.size());
+
+    uri::query_string qs(query.data(), query.data() + query.size(), uri::query_string::plus_as_space);
+    boost::string_ref keys[] = { "session_id", "lang" };
+    uri::query_param_t params[2];
+    bench::run("query_string::find (2 keys, lazy)", 200000, [&] {
+        found += qs.find(keys, 2, params);
+        bench::do_not_optimize(params);
+    }, query.size());
+
+    std::string scratch;
+    bench::run("query_string iterate + decode every value", 200000, [&] {
+        for (uri::query_string::const_iterator i = qs.begin(); i != qs.end(); ++i) {
+            bench::do_not_optimize(qs.decode(i->value, scratch).size());
+        }
+    }, query.size());
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "bench.h"
+#include "http11_parser.h"
+
+#include <string>
+
+int main()
+{
+    const std::string request(
+        "GET /search?q=spirit+parsers&page=3 HTTP/1.1\r\n"
+        "Host: www.makefile.com\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:49.0) Gecko/20100101 Firefox/49.0\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+        "Accept-Language: en-US,en;q=0.5\r\n"
+        "Accept-Encoding: gzip, deflate, br\r\n"
+        "Cookie: session_id=4f9c2a1be0d34c58; theme=dark; tz=America%2FNew_York\r\n"
+        "Connection: keep-alive\r\n");
+
+    http11::request_t req;
+
+    http11::request_parser<std::string::const_iterator> by_iterator(req);
+    bench::run("request_parser<std::string::const_iterator>", 100000, [&] {
+        req.clear();
+        std::string::const_iterator first = request.begin();
+        bench::do_not_optimize(boost::spirit::qi::parse(first, request.end(), by_iterator));
+    }, request.size());
+
+    http11::request_parser<const char *> by_pointer(req);
+    bench::run("request_parser<const char *>", 100000, [&] {
+        req.clear();
+        const char *first = request.data();
+        bench::do_not_optimize(boost::spirit::qi::parse(first, request.data() + request.size(), by_pointer));
+    }, request.size());
+
+    // The request line on its own.
+    const std::string line("GET /search?q=spirit+parsers&page=3 HTTP/1.1\r\n");
+    bench::run("request line, const char *", 1000000, [&] {
+        const char *first = line.data();
+        bench::do_not_optimize(boost::spirit::qi::parse(first, line.data() + line.size(), by_pointer));
+    }, line.size());
+
+    // HTTP-Version on its own: the old string rule, the general rule and
+    // the eight byte fast path.
+    namespace qi = boost::spirit::qi;
+    const std::string version("HTTP/1.1\r\n");
+    qi::rule<const char *, std::string()> version_string =
+        qi::lit("HTTP/") >> +qi::digit >> qi::char_('.') >> +qi::digit;
+    bench::run("version, +digit '.' +digit into std::string", 1000000, [&] {
+        const char *first = version.data();
+        std::string v;
+        qi::parse(first, version.data() + version.size(), version_string, v);
+        bench::do_not_optimize(v);
+    }, 8);
+    qi::rule<const char *, http11::version_t()> version_general =
+        http11::literal_parser("HTTP/") >> qi::uint_parser<uint8_t>() >> '.' >> qi::uint_parser<uint8_t>();
+    bench::run("version, general rule into version_t", 1000000, [&] {
+        const char *first = version.data();
+        http11::version_t v;
+        qi::parse(first, version.data() + version.size(), version_general, v);
+        bench::do_not_optimize(v);
+    }, 8);
+    bench::run("version, scan::common_version", 1000000, [&] {
+        const char *first = version.data();
+        http11::version_t v;
+        http11::scan::common_version(first, version.data() + version.size(), v);
+        bench::do_not_optimize(v);
+    }, 8);
+
+    // The header value scan on its own.
+    const std::string value(
+        "Mozilla/5.0 (X11; Linux x86_64; rv:49.0) Gecko/20100101 Firefox/49.0\r\n");
+    bench::run("scan::field_value, generic", 1000000, [&] {
+        bench::do_not_optimize(http11::scan::field_value(value.begin(), value.end()));
+    }, value.size());
+    bench::run("scan::field_value, const char *", 1000000, [&] {
+        bench::do_not_optimize(http11::scan::field_value(value.data(), value.data() + value.size()));
+    }, value.size());
+
+    return 0;
+}
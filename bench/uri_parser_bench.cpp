@@ -0,0 +1,34 @@
+#include "bench.h"
+#include "uri_parser.h"
+
+#include <string>
+
+int main()
+{
+    namespace qi = boost::spirit::qi;
+
+    // The request-target forms of RFC 7230 section 5.3, plus a relative
+    // reference that only looks like it could start a scheme.
+    const char *targets[][2] = {
+        { "origin-form",    "/api/v1/users/42/posts?sort=desc&page=3" },
+        { "absolute-form",  "http://www.makefile.com:8080/api/v1/users/42?sort=desc" },
+        { "authority-form", "www.makefile.com:443" },
+        { "asterisk-form",  "*" },
+        { "relative path",  "users/42/posts?sort=desc" },
+    };
+
+    uri::uri_t uri;
+    uri::uri_parser<const char *> grammar(uri);
+
+    for (std::size_t i = 0; i < sizeof(targets) / sizeof(targets[0]); ++i) {
+        const std::string input(targets[i][1]);
+        const char *last = input.data() + input.size();
+        std::string name = std::string("uri_parser, ") + targets[i][0];
+        bench::run(name.c_str(), 500000, [&] {
+            const char *first = input.data();
+            bench::do_not_optimize(qi::parse(first, last, grammar));
+        }, input.size());
+    }
+
+    return 0;
+}
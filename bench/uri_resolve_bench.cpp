@@ -0,0 +1,60 @@
+#include "bench.h"
+#include "uri_resolve.h"
+
+#include <string>
+#include <vector>
+
+typedef std::string::const_iterator iterator_t;
+
+static bool parse(uri::uri_parser<iterator_t> &grammar, uri::uri_t &uri, const std::string &text)
+{
+    uri = uri::uri_t();
+    iterator_t begin = text.begin();
+    return boost::spirit::qi::parse(begin, text.end(), grammar) && begin == text.end();
+}
+
+int main()
+{
+    const char *hrefs[] = {
+        "g", "./g", "g/", "/g", "//g", "?y", "g?y", "#s", "g#s", "../g",
+        "../../g", "/./g", "g;x=1/../y", "style/site.css", "/images/logo.png",
+        "../articles/2016/10/spirit.html?ref=nav#top", "https://makefile.com/",
+    };
+    const std::size_t count = sizeof(hrefs) / sizeof(hrefs[0]);
+
+    uri::uri_t base;
+    uri::uri_parser<iterator_t> base_grammar(base);
+    std::string base_text("http://a/b/c/d;p?q");
+    parse(base_grammar, base, base_text);
+
+    std::vector<std::string> texts(hrefs, hrefs + count);
+    std::vector<uri::uri_t> refs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        uri::uri_parser<iterator_t> grammar(refs[i]);
+        parse(grammar, refs[i], texts[i]);
+    }
+
+    std::string out;
+    std::size_t i = 0;
+    bench::run("resolve (parsed components, reused buffer)", 1000000, [&] {
+        uri::resolve(base, refs[i], out);
+        bench::do_not_optimize(out.data());
+        i = (i + 1) % count;
+    });
+
+    // What callers did before: glue the base directory and the href together
+    // and run the whole string through the parser again.
+    uri::uri_t reparsed;
+    uri::uri_parser<iterator_t> reparse_grammar(reparsed);
+    std::string joined;
+    i = 0;
+    bench::run("concatenate + re-parse", 1000000, [&] {
+        joined.assign("http://a/b/c/");
+        joined += texts[i];
+        parse(reparse_grammar, reparsed, joined);
+        bench::do_not_optimize(reparsed);
+        i = (i + 1) % count;
+    });
+
+    return 0;
+}
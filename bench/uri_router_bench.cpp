@@ -0,0 +1,63 @@
+#include "bench.h"
+#include "uri_router.h"
+
+#include <cstdio>
+#include <regex>
+#include <string>
+#include <vector>
+
+int main()
+{
+    // A few thousand routes: per resource a collection, an item and a
+    // nested item.
+    uri::router routes;
+    std::vector<std::regex> regexes;
+    char pattern[128];
+    for (int i = 0; i < 1000; ++i) {
+        std::sprintf(pattern, "/api/v1/resource%d", i);
+        routes.add(pattern);
+        regexes.push_back(std::regex(pattern));
+
+        std::sprintf(pattern, "/api/v1/resource%d/{id}", i);
+        routes.add(pattern);
+        std::sprintf(pattern, "/api/v1/resource%d/([^/]+)", i);
+        regexes.push_back(std::regex(pattern));
+
+        std::sprintf(pattern, "/api/v1/resource%d/{id}/items/{item}", i);
+        routes.add(pattern);
+        std::sprintf(pattern, "/api/v1/resource%d/([^/]+)/items/([^/]+)", i);
+        regexes.push_back(std::regex(pattern));
+    }
+    std::printf("%zu routes\n", routes.size());
+
+    const std::string early("/api/v1/resource3/1234/items/99");
+    const std::string late("/api/v1/resource997/1234/items/99");
+
+    bench::run("router, early route", 1000000, [&] {
+        bench::do_not_optimize(routes.match(boost::string_ref(early)));
+    }, early.size());
+    bench::run("router, late route", 1000000, [&] {
+        bench::do_not_optimize(routes.match(boost::string_ref(late)));
+    }, late.size());
+
+    // The regex chain being replaced: first match wins.
+    std::smatch m;
+    bench::run("std::regex chain, early route", 2000, [&] {
+        for (std::size_t i = 0; i < regexes.size(); ++i) {
+            if (std::regex_match(early, m, regexes[i])) {
+                break;
+            }
+        }
+        bench::do_not_optimize(m);
+    }, early.size());
+    bench::run("std::regex chain, late route", 20, [&] {
+        for (std::size_t i = 0; i < regexes.size(); ++i) {
+            if (std::regex_match(late, m, regexes[i])) {
+                break;
+            }
+        }
+        bench::do_not_optimize(m);
+    }, late.size());
+
+    return 0;
+}
@@ -0,0 +1,196 @@
+#ifndef __reference_parser_h__
+#define __reference_parser_h__
+
+#include <cstddef>
+#include <cstring>
+
+/**
+ * A conventional hand written HTTP/1.x request parser and RFC 3986 URI
+ * splitter, used only as the reference side of the differential comparison.
+ *
+ * It follows the shape of picohttpparser (one pass over a caller buffer,
+ * spans instead of copies, "bytes consumed / -1 malformed / -2 incomplete"
+ * return convention) so that a vendored copy of that or any similar parser
+ * can be dropped in behind the same functions. The grammar it accepts is
+ * RFC 7230 section 3 as written, with no Spirit involved, which is what
+ * makes it useful as a second opinion.
+ */
+namespace reference
+{
+    struct span_t
+    {
+        const char *data;
+        std::size_t size;
+
+        span_t() : data(0), size(0) { }
+        span_t(const char *d, std::size_t n) : data(d), size(n) { }
+    };
+
+    struct header_t
+    {
+        span_t name;
+        span_t value;
+    };
+
+    struct request_t
+    {
+        enum { max_headers = 64 };
+
+        span_t method;
+        span_t target;
+        int major_version;
+        int minor_version;
+        header_t headers[max_headers];
+        std::size_t num_headers;
+    };
+
+    namespace detail
+    {
+        // RFC 7230 tchar
+        inline bool is_tchar(unsigned char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                || (c != 0 && std::strchr("!#$%&'*+-.^_`|~", c) != 0);
+        }
+
+        inline bool is_vchar(unsigned char c)
+        {
+            return c > 0x20 && c != 0x7f;
+        }
+
+        // field-value characters: VCHAR, obs-text, SP, HTAB
+        inline bool is_field_char(unsigned char c)
+        {
+            return is_vchar(c) || c == ' ' || c == '\t';
+        }
+    } // namespace detail
+
+    /**
+     * Parse the request line and header block in [buf, buf + len). Returns
+     * the number of bytes up to and including the blank line that ends the
+     * header block, -1 if the request is malformed or has more than
+     * max_headers headers, or -2 if the buffer ends first.
+     */
+    inline int parse_request(const char *buf, std::size_t len, request_t &req)
+    {
+        using namespace detail;
+
+        const char *p = buf;
+        const char *end = buf + len;
+        req.num_headers = 0;
+
+        // method
+        const char *start = p;
+        while (p != end && is_tchar(*p)) ++p;
+        if (p == end) return -2;
+        if (p == start || *p != ' ') return -1;
+        req.method = span_t(start, p - start);
+        ++p;
+
+        // request-target
+        start = p;
+        while (p != end && is_vchar(*p)) ++p;
+        if (p == end) return -2;
+        if (p == start || *p != ' ') return -1;
+        req.target = span_t(start, p - start);
+        ++p;
+
+        // HTTP-version CRLF
+        if (end - p < 10) return -2;
+        if (std::memcmp(p, "HTTP/", 5) != 0) return -1;
+        if (p[5] < '0' || p[5] > '9' || p[6] != '.' || p[7] < '0' || p[7] > '9') return -1;
+        req.major_version = p[5] - '0';
+        req.minor_version = p[7] - '0';
+        if (p[8] != '\r' || p[9] != '\n') return -1;
+        p += 10;
+
+        // header-field CRLF ... CRLF
+        for (;;) {
+            if (end - p < 2) return -2;
+            if (p[0] == '\r' && p[1] == '\n') {
+                return static_cast<int>(p + 2 - buf);
+            }
+            if (req.num_headers == request_t::max_headers) return -1;
+
+            header_t &h = req.headers[req.num_headers];
+
+            start = p;
+            while (p != end && is_tchar(*p)) ++p;
+            if (p == end) return -2;
+            if (p == start || *p != ':') return -1;
+            h.name = span_t(start, p - start);
+            ++p;
+
+            while (p != end && (*p == ' ' || *p == '\t')) ++p;
+            start = p;
+            while (p != end && is_field_char(*p)) ++p;
+            if (end - p < 2) return -2;
+            if (p[0] != '\r' || p[1] != '\n') return -1;
+
+            const char *value_end = p;
+            while (value_end != start && (value_end[-1] == ' ' || value_end[-1] == '\t')) --value_end;
+            h.value = span_t(start, value_end - start);
+            ++req.num_headers;
+            p += 2;
+        }
+    }
+
+    struct uri_parts_t
+    {
+        span_t scheme, authority, path, query, fragment;
+        bool has_scheme, has_authority, has_query, has_fragment;
+    };
+
+    /**
+     * Split a URI reference into its components with the regular expression
+     * of RFC 3986 appendix B:
+     *
+     *     ^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?
+     *
+     * Like the RFC's expression this splits, it does not validate.
+     */
+    inline void split_uri(span_t uri, uri_parts_t &out)
+    {
+        const char *p = uri.data;
+        const char *end = uri.data + uri.size;
+        out = uri_parts_t();
+
+        const char *start = p;
+        while (p != end && !std::strchr(":/?#", *p)) ++p;
+        if (p != end && p != start && *p == ':') {
+            out.scheme = span_t(start, p - start);
+            out.has_scheme = true;
+            ++p;
+        }
+        else {
+            p = start;
+        }
+
+        if (end - p >= 2 && p[0] == '/' && p[1] == '/') {
+            p += 2;
+            start = p;
+            while (p != end && !std::strchr("/?#", *p)) ++p;
+            out.authority = span_t(start, p - start);
+            out.has_authority = true;
+        }
+
+        start = p;
+        while (p != end && *p != '?' && *p != '#') ++p;
+        out.path = span_t(start, p - start);
+
+        if (p != end && *p == '?') {
+            start = ++p;
+            while (p != end && *p != '#') ++p;
+            out.query = span_t(start, p - start);
+            out.has_query = true;
+        }
+
+        if (p != end && *p == '#') {
+            ++p;
+            out.fragment = span_t(p, end - p);
+            out.has_fragment = true;
+        }
+    }
+} // namespace reference
+
+#endif // __reference_parser_h__
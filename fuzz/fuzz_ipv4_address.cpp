@@ -0,0 +1,36 @@
+#include "fuzz_target.h"
+#include "ipv4_address.h"
+
+#include <cstdlib>
+
+void fuzz::run_one(const char *data, std::size_t size)
+{
+    static uri::ipv4_address<const char *> grammar;
+
+    const char *first = data;
+    const char *last = data + size;
+    std::string parsed;
+    bool ok = boost::spirit::qi::parse(first, last, grammar, parsed);
+
+    if (!ok) {
+        return;
+    }
+
+    check(parsed == std::string(data, first), "ipv4: attribute is not the matched text");
+    check(first == last || *first < '0' || *first > '9', "ipv4: followed by a digit");
+
+    // four dot separated octets of one to three digits, none above 255
+    int octets = 0;
+    std::string::size_type pos = 0;
+    while (pos <= parsed.size()) {
+        std::string::size_type dot = parsed.find('.', pos);
+        if (dot == std::string::npos) {
+            dot = parsed.size();
+        }
+        check(dot - pos >= 1 && dot - pos <= 3, "ipv4: octet length");
+        check(std::atoi(parsed.substr(pos, dot - pos).c_str()) <= 255, "ipv4: octet value");
+        ++octets;
+        pos = dot + 1;
+    }
+    check(octets == 4, "ipv4: octet count");
+}
@@ -0,0 +1,23 @@
+#include "fuzz_target.h"
+#include "ipv6_address.h"
+
+void fuzz::run_one(const char *data, std::size_t size)
+{
+    static uri::ipv6_address<const char *> grammar;
+
+    const char *first = data;
+    const char *last = data + size;
+    std::string parsed;
+    bool ok = boost::spirit::qi::parse(first, last, grammar, parsed);
+
+    if (!ok) {
+        return;
+    }
+
+    check(parsed == std::string(data, first), "ipv6: attribute is not the matched text");
+    check(parsed.size() <= 45, "ipv6: longer than any valid address");
+
+    std::string::size_type elision = parsed.find("::");
+    check(elision == std::string::npos || parsed.find("::", elision + 1) == std::string::npos,
+          "ipv6: more than one '::'");
+}
@@ -0,0 +1,21 @@
+#include "fuzz_target.h"
+#include "percent_encoded_char.h"
+#include "percent_decode.h"
+
+void fuzz::run_one(const char *data, std::size_t size)
+{
+    static uri::percent_encoded_char<const char *> grammar;
+
+    const char *first = data;
+    const char *last = data + size;
+    char decoded = 0;
+    bool ok = boost::spirit::qi::parse(first, last, grammar, decoded);
+
+    if (!ok) {
+        return;
+    }
+
+    check(first == data + 3, "percent: consumed other than three bytes");
+    check(static_cast<unsigned char>(decoded) == uri::hex_value(data[1]) * 16 + uri::hex_value(data[2]),
+          "percent: wrong value");
+}
@@ -0,0 +1,25 @@
+#include "fuzz_target.h"
+#include "http11_parser.h"
+
+void fuzz::run_one(const char *data, std::size_t size)
+{
+    static http11::request_t req;
+    static http11::request_parser<const char *> grammar(req);
+    req = http11::request_t();
+
+    const char *first = data;
+    const char *last = data + size;
+    bool ok = boost::spirit::qi::parse(first, last, grammar);
+
+    check(first >= data && first <= last, "request: iterator left the input");
+    if (!ok) {
+        return;
+    }
+
+    check(!req.method.empty() && req.method.size() <= 20, "request: method length");
+    check(within(req.uri.path.raw(), data, first), "request: uri path");
+    check(within(req.uri.authority.raw(), data, first), "request: uri authority");
+    for (http11::header_container_t::const_iterator i = req.headers.begin(); i != req.headers.end(); ++i) {
+        check(!i->first.empty() && !i->second.empty(), "request: empty header key or value");
+    }
+}
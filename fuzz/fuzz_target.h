@@ -0,0 +1,41 @@
+#ifndef __fuzz_target_h__
+#define __fuzz_target_h__
+
+#include <boost/utility/string_ref.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace fuzz
+{
+    /**
+     * Implemented once per fuzz target: parse a single input and abort() if
+     * the result breaks one of the target's invariants.
+     */
+    void run_one(const char *data, std::size_t size);
+
+    inline void check(bool condition, const char *what)
+    {
+        if (!condition) {
+            std::fprintf(stderr, "invariant violated: %s\n", what);
+            std::abort();
+        }
+    }
+
+    // A parsed span must point into the input (empty spans may be null).
+    inline bool within(boost::string_ref s, const char *first, const char *last)
+    {
+        return s.empty() || (s.data() >= first && s.data() + s.size() <= last);
+    }
+} // namespace fuzz
+
+// libFuzzer / AFL entry point; the standalone driver calls it as well.
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, std::size_t size)
+{
+    fuzz::run_one(reinterpret_cast<const char *>(data), size);
+    return 0;
+}
+
+#endif // __fuzz_target_h__
@@ -0,0 +1,51 @@
+#include "fuzz_target.h"
+#include "uri_parser.h"
+
+namespace
+{
+    void check_component(const uri::component_t &c, const char *first, const char *last, const char *what)
+    {
+        fuzz::check(c.defined() || c.empty(), what);
+        fuzz::check(fuzz::within(c.raw(), first, last), what);
+        fuzz::check(c.decoded().size() <= c.raw().size(), what);
+    }
+
+    // port_number is the value of the port digits, which never overflow.
+    void check_port(const uri::uri_t &uri)
+    {
+        unsigned long value = 0;
+        boost::string_ref digits = uri.port.raw();
+        for (std::size_t i = 0; i < digits.size(); ++i) {
+            fuzz::check(digits[i] >= '0' && digits[i] <= '9', "uri: port digits");
+            value = value * 10 + (digits[i] - '0');
+            fuzz::check(value <= 65535, "uri: port overflow");
+        }
+        fuzz::check(value == uri.port_number, "uri: port_number");
+    }
+}
+
+void fuzz::run_one(const char *data, std::size_t size)
+{
+    static uri::uri_t uri;
+    static uri::uri_parser<const char *> grammar(uri);
+    uri = uri::uri_t();
+
+    const char *first = data;
+    const char *last = data + size;
+    bool ok = boost::spirit::qi::parse(first, last, grammar);
+
+    check(first >= data && first <= last, "uri: iterator left the input");
+    if (!ok) {
+        return;
+    }
+
+    check_component(uri.scheme,    data, first, "uri: scheme");
+    check_component(uri.authority, data, first, "uri: authority");
+    check_component(uri.user_info, data, first, "uri: user_info");
+    check_component(uri.host,      data, first, "uri: host");
+    check_component(uri.port,      data, first, "uri: port");
+    check_component(uri.path,      data, first, "uri: path");
+    check_component(uri.query,     data, first, "uri: query");
+    check_component(uri.fragment,  data, first, "uri: fragment");
+    check_port(uri);
+}
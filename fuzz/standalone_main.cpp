@@ -0,0 +1,188 @@
+/**
+ * Driver for the fuzz targets when the build has no libFuzzer.
+ *
+ * Runs every file named on the command line through LLVMFuzzerTestOneInput
+ * (directories are read one level deep), or stdin when nothing is named, so
+ * AFL can drive it with "@@". With --scaling each input is also "pumped": a
+ * slice of it is repeated to grow the input 16 fold, and an input whose parse
+ * time grows clearly faster than its length is reported as superlinear.
+ */
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, std::size_t size);
+
+namespace
+{
+    // Parse time may grow by this much per 16x growth of the input before it
+    // counts as superlinear; linear is 16, quadratic 256.
+    const double max_growth = 48.0;
+
+    // Inputs are pumped to at least this many bytes before timing, so fixed
+    // costs do not hide the slope.
+    const std::size_t pump_base = 512;
+
+    // Times below this are noise, whatever their ratio.
+    const double min_interesting_ns = 20000.0;
+
+    void run(const std::string &input)
+    {
+        LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t *>(input.data()), input.size());
+    }
+
+    // Best of three batches, in ns per parse.
+    double measure(const std::string &input)
+    {
+        typedef std::chrono::steady_clock clock;
+
+        std::size_t reps = std::max<std::size_t>(1, 65536 / (input.size() + 1));
+        double best = 0;
+        for (int batch = 0; batch < 3; ++batch) {
+            clock::time_point start = clock::now();
+            for (std::size_t i = 0; i < reps; ++i) {
+                run(input);
+            }
+            double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / reps;
+            if (batch == 0 || ns < best) {
+                best = ns;
+            }
+        }
+        return best;
+    }
+
+    std::string pump(const std::string &input, std::size_t first, std::size_t last, std::size_t times)
+    {
+        std::string out(input, 0, first);
+        for (std::size_t i = 0; i < times; ++i) {
+            out.append(input, first, last - first);
+        }
+        out.append(input, last, std::string::npos);
+        return out;
+    }
+
+    // Returns false if pumping any slice of input shows superlinear growth.
+    bool check_scaling(const std::string &name, const std::string &input)
+    {
+        if (input.empty()) {
+            return true;
+        }
+
+        std::size_t n = input.size();
+        std::size_t slices[][2] = {
+            { 0, n },                // the whole input
+            { 0, 1 },                // its first byte
+            { n - 1, n },            // its last byte
+            { n / 3, n - n / 3 },    // its middle
+        };
+
+        bool linear = true;
+        for (std::size_t s = 0; s < sizeof(slices) / sizeof(slices[0]); ++s) {
+            std::size_t first = slices[s][0];
+            std::size_t last = slices[s][1];
+            if (first >= last) {
+                continue;
+            }
+
+            std::size_t times = (pump_base + (last - first) - 1) / (last - first);
+            std::string small = pump(input, first, last, times);
+            std::string large = pump(input, first, last, times * 16);
+
+            double t_small = measure(small);
+            double t_large = measure(large);
+            if (t_large < min_interesting_ns) {
+                continue;
+            }
+
+            double growth = t_large / t_small;
+            if (growth > max_growth) {
+                std::printf("SUPERLINEAR %s: slice [%zu,%zu) %zu -> %zu bytes, %.0f -> %.0f ns (x%.1f, ~n^%.2f)\n",
+                            name.c_str(), first, last, small.size(), large.size(),
+                            t_small, t_large, growth, std::log(growth) / std::log(16.0));
+                linear = false;
+            }
+        }
+        return linear;
+    }
+
+    bool read_file(const std::string &path, std::string &out)
+    {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        if (!in) {
+            return false;
+        }
+        out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    void collect(const std::string &path, std::vector<std::string> &files)
+    {
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+            files.push_back(path);
+            return;
+        }
+
+        DIR *dir = opendir(path.c_str());
+        if (!dir) {
+            return;
+        }
+        while (struct dirent *entry = readdir(dir)) {
+            std::string child = path + "/" + entry->d_name;
+            if (entry->d_name[0] != '.' && stat(child.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+                files.push_back(child);
+            }
+        }
+        closedir(dir);
+        std::sort(files.begin(), files.end());
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool scaling = false;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--scaling") == 0) {
+            scaling = true;
+        }
+        else {
+            collect(argv[i], files);
+        }
+    }
+
+    if (files.empty()) {
+        std::string input((std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>());
+        run(input);
+        return (scaling && !check_scaling("<stdin>", input)) ? 1 : 0;
+    }
+
+    int superlinear = 0;
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        std::string input;
+        if (!read_file(files[i], input)) {
+            std::fprintf(stderr, "cannot read %s\n", files[i].c_str());
+            return 2;
+        }
+        run(input);
+        if (scaling && !check_scaling(files[i], input)) {
+            ++superlinear;
+        }
+    }
+
+    std::printf("%zu inputs, %d superlinear\n", files.size(), superlinear);
+    return superlinear ? 1 : 0;
+}
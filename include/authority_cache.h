@@ -0,0 +1,211 @@
+#ifndef __uri_authority_cache_h__
+#define __uri_authority_cache_h__
+
+#include "uri.h"
+
+#include <cstddef>
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+
+namespace uri
+{
+    /**
+     * Bounded cache of parsed authorities keyed by their raw bytes.
+     *
+     * Traffic tends to go to a handful of hosts, so uri_parser can be given
+     * a cache (see its constructor) and then resolves an authority it has
+     * seen before with one hash and one memcmp instead of running the
+     * user_info / ipv4 / ipv6 / reg_name grammar again. An entry only holds
+     * the key bytes, the offsets of user_info, host and port within it, the
+     * host kind and the port number, so a hit points the components of the
+     * uri_t straight into the current input, exactly as a parse would.
+     *
+     * The table is a fixed number of slots allocated up front; a lookup
+     * probes a few neighbouring slots and an insert into a full
+     * neighbourhood replaces the home slot. Authorities longer than max_key
+     * bytes are never cached.
+     *
+     * Not thread safe; use one cache per thread, eg authority_cache::local().
+     */
+    class authority_cache
+    {
+    public:
+        enum
+        {
+            max_key = 64,  // longest authority that is cached
+            probes  = 4    // slots looked at per lookup
+        };
+
+        /**
+         * slots is rounded up to a power of two.
+         */
+        explicit authority_cache(std::size_t slots = 1024) :
+            hits_(0), misses_(0)
+        {
+            std::size_t n = probes;
+            while (n < slots) {
+                n <<= 1;
+            }
+            slots_.resize(n);
+            mask_ = n - 1;
+        }
+
+        /**
+         * The cache of the calling thread.
+         */
+        static authority_cache &local()
+        {
+            static thread_local authority_cache cache;
+            return cache;
+        }
+
+        /**
+         * Characters that can appear in an authority. The parser caches the
+         * longest run of them, and only when the grammar matched all of it.
+         */
+        static bool authority_char(char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                || (c != 0 && std::strchr("-._~!$&'()*+,;=:@[]%", c) != 0);
+        }
+
+        /**
+         * When [first, first + size) is cached, point the authority
+         * components of it at it and return true.
+         */
+        bool lookup(const char *first, std::size_t size, uri_t &it)
+        {
+            const slot_t *slot = find(first, size, hash(first, size));
+            if (!slot) {
+                ++misses_;
+                return false;
+            }
+
+            ++hits_;
+            it.clear_authority();
+            it.authority.assign(first, first + size);
+            assign(it.user_info, first, slot->user_info);
+            assign(it.host, first, slot->host);
+            assign(it.port, first, slot->port);
+            it.host_kind = static_cast<host_kind_t>(slot->host_kind);
+            it.port_number = slot->port_number;
+            return true;
+        }
+
+        /**
+         * Remember the authority components of it, which were just parsed
+         * from [first, first + size).
+         */
+        void insert(const char *first, std::size_t size, const uri_t &it)
+        {
+            if (size == 0 || size > max_key) {
+                return;
+            }
+
+            uint32_t h = hash(first, size);
+            slot_t *slot = &slots_[h & mask_];
+            for (std::size_t i = 0; i < probes; ++i) {
+                slot_t &candidate = slots_[(h + i) & mask_];
+                if (candidate.size == 0) {
+                    slot = &candidate;
+                    break;
+                }
+            }
+
+            slot->hash = h;
+            slot->size = static_cast<uint8_t>(size);
+            std::memcpy(slot->key, first, size);
+            slot->user_info = span(first, it.user_info);
+            slot->host = span(first, it.host);
+            slot->port = span(first, it.port);
+            slot->host_kind = static_cast<uint8_t>(it.host_kind);
+            slot->port_number = it.port_number;
+        }
+
+        void clear()
+        {
+            slots_.assign(slots_.size(), slot_t());
+        }
+
+        std::size_t size() const { return slots_.size(); }
+
+        uint64_t hits() const { return hits_; }
+        uint64_t misses() const { return misses_; }
+
+        void reset_counters()
+        {
+            hits_ = misses_ = 0;
+        }
+
+    private:
+        // A component as an offset into the key; size undefined_size when
+        // the component was not present.
+        struct span_t
+        {
+            enum { undefined_size = 0xff };
+
+            uint8_t offset;
+            uint8_t size;
+
+            span_t() : offset(0), size(undefined_size) { }
+        };
+
+        struct slot_t
+        {
+            uint32_t hash;
+            uint8_t size;  // 0 for an empty slot
+            uint8_t host_kind;
+            uint16_t port_number;
+            span_t user_info, host, port;
+            char key[max_key];
+
+            slot_t() : hash(0), size(0), host_kind(host_none), port_number(0) { }
+        };
+
+        // FNV-1a
+        static uint32_t hash(const char *first, std::size_t size)
+        {
+            uint32_t h = 2166136261u;
+            for (std::size_t i = 0; i < size; ++i) {
+                h = (h ^ static_cast<unsigned char>(first[i])) * 16777619u;
+            }
+            return h;
+        }
+
+        const slot_t *find(const char *first, std::size_t size, uint32_t h) const
+        {
+            for (std::size_t i = 0; i < probes; ++i) {
+                const slot_t &slot = slots_[(h + i) & mask_];
+                if (slot.hash == h && slot.size == size && std::memcmp(slot.key, first, size) == 0) {
+                    return &slot;
+                }
+            }
+            return 0;
+        }
+
+        static span_t span(const char *first, const component_t &c)
+        {
+            span_t s;
+            if (c.defined()) {
+                s.offset = static_cast<uint8_t>(c.empty() ? 0 : c.raw().data() - first);
+                s.size = static_cast<uint8_t>(c.raw().size());
+            }
+            return s;
+        }
+
+        static void assign(component_t &c, const char *first, span_t s)
+        {
+            if (s.size != span_t::undefined_size) {
+                c.assign(first + s.offset, first + s.offset + s.size);
+            }
+        }
+
+        std::vector<slot_t> slots_;
+        std::size_t mask_;
+        uint64_t hits_;
+        uint64_t misses_;
+    };
+} // namespace uri
+
+#endif // __uri_authority_cache_h__
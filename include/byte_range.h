@@ -0,0 +1,223 @@
+#ifndef __http11_byte_range_h__
+#define __http11_byte_range_h__
+
+#include <boost/config/warning_disable.hpp>
+#include <boost/spirit/include/qi.hpp>
+#include <boost/spirit/include/phoenix_core.hpp>
+#include <boost/spirit/include/phoenix_operator.hpp>
+#include <boost/spirit/include/phoenix_function.hpp>
+#include <boost/container/small_vector.hpp>
+#include <boost/utility/string_ref.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdint.h>
+
+namespace http11
+{
+    namespace qi = boost::spirit::qi;
+    namespace phoenix = boost::phoenix;
+
+    /**
+     * One byte-range-spec, inclusive. As parsed, "500-" has last == open
+     * and the suffix form "-500" has first == open and last the suffix
+     * length; byte_ranges_t::resolve turns both into absolute offsets.
+     */
+    struct byte_range_t
+    {
+        static constexpr uint64_t open = UINT64_MAX;
+
+        uint64_t first;
+        uint64_t last;
+
+        bool suffix() const { return first == open; }
+        uint64_t size() const { return last - first + 1; }  // once resolved
+
+        bool operator==(const byte_range_t &rhs) const { return first == rhs.first && last == rhs.last; }
+    };
+
+    /**
+     * The ranges of a Range header, in request order. Up to inline_ranges
+     * are held without allocating.
+     */
+    class byte_ranges_t
+    {
+    public:
+        enum { inline_ranges = 8 };
+
+        typedef boost::container::small_vector<byte_range_t, inline_ranges> container_t;
+        typedef container_t::const_iterator const_iterator;
+
+        std::size_t size() const { return ranges_.size(); }
+        bool empty() const { return ranges_.empty(); }
+        const byte_range_t &operator[](std::size_t i) const { return ranges_[i]; }
+        const_iterator begin() const { return ranges_.begin(); }
+        const_iterator end() const { return ranges_.end(); }
+
+        void clear() { ranges_.clear(); }
+        void push_back(const byte_range_t &range) { ranges_.push_back(range); }
+
+        /**
+         * Make the ranges absolute offsets into a representation of length
+         * bytes: suffixes and open ends are filled in, ends past the last
+         * byte clipped, and unsatisfiable ranges dropped. What is left is
+         * sorted and coalesced, as RFC 7233 section 4.1 allows, where ranges
+         * overlap or are less than gap bytes apart (eg the part header
+         * overhead of a multipart/byteranges reply). False when nothing is
+         * satisfiable: a 416.
+         */
+        bool resolve(uint64_t length, uint64_t gap = 0)
+        {
+            container_t::iterator out = ranges_.begin();
+            for (container_t::iterator r = ranges_.begin(); r != ranges_.end(); ++r) {
+                byte_range_t range = *r;
+                if (range.suffix()) {
+                    if (range.last == 0 || length == 0) {
+                        continue;
+                    }
+                    range.first = range.last < length ? length - range.last : 0;
+                    range.last = length - 1;
+                }
+                else if (range.first >= length) {
+                    continue;
+                }
+                else if (range.last >= length) {
+                    range.last = length - 1;
+                }
+                *out++ = range;
+            }
+            ranges_.erase(out, ranges_.end());
+            if (ranges_.empty()) {
+                return false;
+            }
+
+            std::sort(ranges_.begin(), ranges_.end(),
+                      [](const byte_range_t &a, const byte_range_t &b) { return a.first < b.first; });
+            out = ranges_.begin();
+            for (container_t::iterator r = ranges_.begin() + 1; r != ranges_.end(); ++r) {
+                // last < length, so neither sum wraps
+                if (r->first <= out->last + 1 || r->first - out->last - 1 < gap) {
+                    out->last = std::max(out->last, r->last);
+                }
+                else {
+                    *++out = *r;
+                }
+            }
+            ranges_.erase(out + 1, ranges_.end());
+            return true;
+        }
+
+    private:
+        container_t ranges_;
+    };
+
+    namespace detail
+    {
+        struct add_byte_range_impl
+        {
+            typedef bool result_type;
+
+            bool operator()(byte_ranges_t &ranges, uint64_t first, uint64_t last, std::size_t max) const
+            {
+                if (ranges.size() >= max) {
+                    return false;
+                }
+                byte_range_t range = { first, last };
+                ranges.push_back(range);
+                return true;
+            }
+        };
+    } // namespace detail
+
+    /**
+     * Parser for a Range header value (RFC 7233 section 3.1) into ranges:
+     *
+     *     bytes=0-1023,2048-
+     *     bytes=-500
+     *
+     * Positions are 64 bit; one that overflows, or a range whose last is
+     * before its first, fails the parse, and the header is to be ignored.
+     * So does a list of more than max_ranges ranges, which bounds the
+     * work a hostile many-range request can ask for.
+     */
+    template <typename Iterator>
+    struct byte_range_parser : qi::grammar<Iterator>
+    {
+        byte_range_parser(byte_ranges_t &it, std::size_t max_ranges);
+
+        std::size_t max_ranges;
+
+        qi::rule<Iterator> ows;
+        qi::rule<Iterator, qi::locals<uint64_t, uint64_t> > byte_range_spec;
+        qi::rule<Iterator> suffix_byte_range_spec, byte_range, start;
+    }; // struct byte_range_parser
+
+    template <typename Iterator>
+    byte_range_parser<Iterator>::byte_range_parser(byte_ranges_t &it, std::size_t max_ranges) :
+        byte_range_parser::base_type(start), max_ranges(max_ranges)
+    {
+        using qi::char_;
+        using qi::lit;
+        using qi::eps;
+        using qi::no_case;
+        using qi::_1;
+        using qi::_a;
+        using qi::_b;
+        using qi::_pass;
+        using phoenix::ref;
+
+        phoenix::function<detail::add_byte_range_impl> add_;
+        qi::uint_parser<uint64_t, 10, 1, -1> position;  // fails on overflow
+        const uint64_t open = byte_range_t::open;
+
+        ows                    = *char_(" \t");
+
+        byte_range_spec        = position[_a = _1, _b = open, _pass = _a != open] >> '-' >> -position[_b = _1]
+                               >> eps[_pass = _a <= _b && add_(ref(it), _a, _b, ref(this->max_ranges))]
+                               ;
+        suffix_byte_range_spec = '-' >> position[_pass = add_(ref(it), open, _1, ref(this->max_ranges))];
+        byte_range             = byte_range_spec | suffix_byte_range_spec;
+
+        // 1#byte_range, with the empty elements the list rule tolerates
+        start                  = no_case[lit("bytes")] >> '='
+                               >> *(lit(',') >> ows) >> byte_range
+                               >> *(ows >> ',' >> -(ows >> byte_range))
+                               ;
+
+        byte_range_spec.name("byte_range_spec");
+        suffix_byte_range_spec.name("suffix_byte_range_spec");
+        start.name("start");
+    }
+
+    /**
+     * Parse a Range header value, ignoring trailing whitespace, into out.
+     * False when the header should be ignored (malformed, another unit, or
+     * more than max_ranges ranges); the whole representation is sent then.
+     *
+     * Example:
+     *     http11::byte_ranges_t ranges;
+     *     if (http11::parse_byte_ranges(req.headers["Range"], ranges)) {
+     *         if (!ranges.resolve(file_size, 80)) { ... 416 }
+     *     }
+     */
+    inline bool parse_byte_ranges(boost::string_ref value, byte_ranges_t &out, std::size_t max_ranges = 16)
+    {
+        static thread_local byte_ranges_t parsed;
+        static thread_local byte_range_parser<const char *> grammar(parsed, max_ranges);
+
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+            value.remove_suffix(1);
+        }
+        parsed.clear();
+        grammar.max_ranges = max_ranges;
+        const char *first = value.data();
+        const char *last = first + value.size();
+        if (!qi::parse(first, last, grammar) || first != last) {
+            return false;
+        }
+        out = parsed;
+        return true;
+    }
+} // namespace http11
+
+#endif // __http11_byte_range_h__
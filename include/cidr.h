@@ -0,0 +1,227 @@
+#ifndef __cidr_h__
+#define __cidr_h__
+
+#include "ipv4_scan.h"
+
+#include <cstring>
+#include <stdint.h>
+
+namespace uri
+{
+    /**
+     * An IPv4 or IPv6 address in binary, network order (IPv4 in the first
+     * four bytes).
+     */
+    struct ip_address_t
+    {
+        enum family_t
+        {
+            family_none,
+            family_ipv4,
+            family_ipv6
+        };
+
+        family_t family;
+        uint8_t bytes[16];
+
+        ip_address_t() : family(family_none), bytes() { }
+
+        void assign(uint32_t ipv4)
+        {
+            family = family_ipv4;
+            std::memset(bytes, 0, sizeof(bytes));
+            bytes[0] = static_cast<uint8_t>(ipv4 >> 24);
+            bytes[1] = static_cast<uint8_t>(ipv4 >> 16);
+            bytes[2] = static_cast<uint8_t>(ipv4 >> 8);
+            bytes[3] = static_cast<uint8_t>(ipv4);
+        }
+
+        void assign(const uint8_t (&ipv6)[16])
+        {
+            family = family_ipv6;
+            std::memcpy(bytes, ipv6, sizeof(bytes));
+        }
+
+        /**
+         * The IPv4 address in host order, as parse_ipv4 gives it.
+         */
+        uint32_t ipv4() const
+        {
+            return static_cast<uint32_t>(bytes[0]) << 24 | bytes[1] << 16 | bytes[2] << 8 | bytes[3];
+        }
+
+        friend bool operator==(const ip_address_t &lhs, const ip_address_t &rhs)
+        {
+            return lhs.family == rhs.family && std::memcmp(lhs.bytes, rhs.bytes, sizeof(lhs.bytes)) == 0;
+        }
+
+        friend bool operator!=(const ip_address_t &lhs, const ip_address_t &rhs) { return !(lhs == rhs); }
+    };
+
+    /**
+     * An address prefix, eg 10.0.0.0/8 or 2001:db8::/32: the address and
+     * the prefix length. Bits past the prefix are always zero.
+     */
+    struct cidr_t : ip_address_t
+    {
+        unsigned length;
+
+        cidr_t() : length(0) { }
+
+        /**
+         * Set the prefix, clearing the bits past it; false when length is
+         * longer than the address.
+         */
+        bool assign(family_t f, const uint8_t *address, unsigned prefix_length)
+        {
+            unsigned size = f == family_ipv4 ? 4 : 16;
+            if (prefix_length > size * 8) {
+                return false;
+            }
+            family = f;
+            length = prefix_length;
+            std::memset(bytes, 0, sizeof(bytes));
+            std::memcpy(bytes, address, size);
+            for (unsigned bit = prefix_length; bit < size * 8; ++bit) {
+                bytes[bit / 8] &= ~(0x80 >> (bit % 8));
+            }
+            return true;
+        }
+
+        bool assign(uint32_t ipv4, unsigned prefix_length)
+        {
+            uint8_t address[4] = {
+                static_cast<uint8_t>(ipv4 >> 24), static_cast<uint8_t>(ipv4 >> 16),
+                static_cast<uint8_t>(ipv4 >> 8), static_cast<uint8_t>(ipv4)
+            };
+            return assign(family_ipv4, address, prefix_length);
+        }
+
+        friend bool operator==(const cidr_t &lhs, const cidr_t &rhs)
+        {
+            return static_cast<const ip_address_t &>(lhs) == rhs && lhs.length == rhs.length;
+        }
+
+        friend bool operator!=(const cidr_t &lhs, const cidr_t &rhs) { return !(lhs == rhs); }
+    };
+
+    /**
+     * Parse exactly [first, last) as an IPv6 address (RFC 4291 text form:
+     * eight h16 groups, or fewer around one "::", the last two optionally
+     * written as an IPv4 address) into 16 bytes, network order.
+     */
+    inline bool parse_ipv6(const char *first, const char *last, uint8_t (&out)[16])
+    {
+        uint16_t groups[8];
+        int count = 0;
+        int gap = -1;  // groups before the "::"
+
+        const char *cur = first;
+        if (cur != last && *cur == ':') {
+            if (last - cur < 2 || cur[1] != ':') {
+                return false;
+            }
+            gap = 0;
+            cur += 2;
+        }
+
+        while (cur != last) {
+            const char *group = cur;
+            unsigned value = 0;
+            for (; cur != last && cur - group <= 4; ++cur) {
+                char c = *cur;
+                unsigned digit = c >= '0' && c <= '9' ? c - '0'
+                               : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                               : c >= 'A' && c <= 'F' ? c - 'A' + 10
+                               : 16;
+                if (digit == 16) {
+                    break;
+                }
+                value = value << 4 | digit;
+            }
+
+            if (cur != last && *cur == '.') {
+                // ls32 as an IPv4 address, which ends the address
+                uint32_t ipv4;
+                if (count > 6 || !scan::ipv4(group, last, ipv4) || group != last) {
+                    return false;
+                }
+                groups[count++] = static_cast<uint16_t>(ipv4 >> 16);
+                groups[count++] = static_cast<uint16_t>(ipv4);
+                break;
+            }
+            if (cur == group || cur - group > 4 || count == 8) {
+                return false;
+            }
+            groups[count++] = static_cast<uint16_t>(value);
+
+            if (cur == last) {
+                break;
+            }
+            if (*cur++ != ':' || cur == last) {
+                return false;
+            }
+            if (*cur == ':') {
+                if (gap >= 0) {
+                    return false;
+                }
+                gap = count;
+                ++cur;
+            }
+        }
+
+        // "::" stands for at least one group.
+        if (gap < 0 ? count != 8 : count > 7) {
+            return false;
+        }
+
+        std::memset(out, 0, sizeof(out));
+        int tail = gap < 0 ? 0 : count - gap;
+        for (int i = 0; i < count; ++i) {
+            int at = gap >= 0 && i >= gap ? 8 - tail + (i - gap) : i;
+            out[2 * at] = static_cast<uint8_t>(groups[i] >> 8);
+            out[2 * at + 1] = static_cast<uint8_t>(groups[i]);
+        }
+        return true;
+    }
+
+    namespace detail
+    {
+        /**
+         * Semantic action storing the address matched by raw[] in address,
+         * for grammars that keep addresses in binary; false, to bind to
+         * _pass, when the text does not convert. Use it on
+         * raw[ipv6.ipv6_attr] rather than raw[ipv6], whose std::string
+         * attribute would be filled (and allocate) under raw[]. Like
+         * assign_component_impl, it requires contiguous iterators.
+         */
+        struct assign_address_impl
+        {
+            typedef bool result_type;
+
+            template <typename Range>
+            bool operator()(ip_address_t &address, ip_address_t::family_t family, const Range &r) const
+            {
+                const char *first = &*r.begin();
+                const char *last = first + (r.end() - r.begin());
+                if (family == ip_address_t::family_ipv4) {
+                    uint32_t ipv4;
+                    if (!parse_ipv4(first, last, ipv4)) {
+                        return false;
+                    }
+                    address.assign(ipv4);
+                }
+                else {
+                    uint8_t ipv6[16];
+                    if (!parse_ipv6(first, last, ipv6)) {
+                        return false;
+                    }
+                    address.assign(ipv6);
+                }
+                return true;
+            }
+        };
+    } // namespace detail
+} // namespace uri
+
+#endif // __cidr_h__
@@ -0,0 +1,91 @@
+#ifndef __cidr_address_h__
+#define __cidr_address_h__
+
+#include <boost/config/warning_disable.hpp>
+#include <boost/spirit/include/qi.hpp>
+#include <boost/spirit/include/phoenix_core.hpp>
+#include <boost/spirit/include/phoenix_operator.hpp>
+#include <boost/spirit/include/phoenix_function.hpp>
+
+#include "cidr.h"
+#include "ipv4_address.h"
+#include "ipv6_address.h"
+
+namespace uri
+{
+    namespace qi = boost::spirit::qi;
+    namespace ascii = boost::spirit::ascii;
+    namespace phoenix = boost::phoenix;
+
+    namespace detail
+    {
+        // Convert the text an address grammar matched; false fails the
+        // parse when the prefix length is too long for the family.
+        struct cidr_assign_impl
+        {
+            typedef bool result_type;
+
+            template <typename Range>
+            bool operator()(cidr_t &out, cidr_t::family_t family, const Range &r, unsigned length) const
+            {
+                const char *first = &*r.begin();
+                const char *last = first + (r.end() - r.begin());
+                if (family == cidr_t::family_ipv4) {
+                    uint32_t address;
+                    return parse_ipv4(first, last, address) && out.assign(address, length);
+                }
+                uint8_t address[16];
+                return parse_ipv6(first, last, address) && out.assign(family, address, length);
+            }
+        };
+    } // namespace detail
+
+    /**
+     * Parser for an address prefix in CIDR notation, ipv4_address "/" 0-32
+     * or ipv6_address "/" 0-128, into a cidr_t. The prefix length is one to
+     * three digits; address bits past it are cleared, so "10.1.2.3/8"
+     * gives 10.0.0.0/8.
+     *
+     * Iterator must point into contiguous memory.
+     */
+    template <typename Iterator>
+    struct cidr_address : qi::grammar<Iterator, cidr_t()>
+    {
+        cidr_address();
+
+        ipv4_address<Iterator> ipv4;
+        ipv6_address<Iterator> ipv6;
+        qi::rule<Iterator, cidr_t()> ipv4_cidr, ipv6_cidr;
+        qi::rule<Iterator, cidr_t()> start;
+    }; // struct cidr_address
+
+    template <typename Iterator>
+    cidr_address<Iterator>::cidr_address() :
+        cidr_address::base_type(start)
+    {
+        using qi::raw;
+        using qi::_val;
+        using qi::_1;
+        using qi::_2;
+        using qi::_pass;
+        using ascii::digit;
+
+        phoenix::function<detail::cidr_assign_impl> assign_;
+        qi::uint_parser<unsigned, 10, 1, 3> length;
+
+        // The rules without text attributes, as for assign_address_impl.
+        ipv4_cidr = (raw[ipv4.ipv4_attr] >> '/' >> length >> !digit)
+                    [_pass = assign_(_val, cidr_t::family_ipv4, _1, _2)];
+
+        ipv6_cidr = (raw[ipv6.ipv6_attr] >> '/' >> length >> !digit)
+                    [_pass = assign_(_val, cidr_t::family_ipv6, _1, _2)];
+
+        start     = ipv4_cidr | ipv6_cidr;
+
+        ipv4_cidr.name("ipv4_cidr");
+        ipv6_cidr.name("ipv6_cidr");
+        start.name("start");
+    }
+} // namespace uri
+
+#endif // __cidr_address_h__
@@ -0,0 +1,353 @@
+#ifndef __uri_compact_uri_h__
+#define __uri_compact_uri_h__
+
+#include "uri.h"
+
+#include <boost/utility/string_ref.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <stdint.h>
+
+namespace uri
+{
+    /**
+     * An owning copy of a parsed URI in a single buffer.
+     *
+     * uri_t only points into the parsed input, so keeping a URI around
+     * (a cache entry, a queued job) used to mean keeping the input too, or
+     * copying each component into a string of its own. compact_uri holds
+     * the recomposed URI text (see uri::write) and, per component, a 16 bit
+     * offset and size into it. Texts of up to inline_capacity bytes live
+     * inside the object; longer ones take exactly one heap block. Copying
+     * is a memcpy (plus that one block), moving never allocates.
+     *
+     * view() hands back a uri_t whose components point into the buffer, so
+     * the compact form converts both ways without parsing.
+     *
+     * Example:
+     *     uri::compact_uri kept(parsed);   // parsed is a uri_t
+     *     queue.push_back(std::move(kept));
+     *     uri::uri_t uri = queue.front().view();
+     */
+    class compact_uri
+    {
+    public:
+        enum component_id_t
+        {
+            scheme_id,
+            authority_id,
+            user_info_id,
+            host_id,
+            port_id,
+            path_id,
+            query_id,
+            fragment_id,
+            component_count
+        };
+
+        enum
+        {
+            inline_capacity = 56,  // longest text stored without allocating
+            max_size = 0xfffe      // longest text at all
+        };
+
+        compact_uri() :
+            size_(0), port_number_(0), host_kind_(host_none), heap_(false)
+        {
+            undefine_all();
+        }
+
+        /**
+         * Copy it; throws std::length_error when the recomposed text is
+         * longer than max_size.
+         */
+        explicit compact_uri(const uri_t &it) :
+            size_(0), port_number_(0), host_kind_(host_none), heap_(false)
+        {
+            build(it);
+        }
+
+        compact_uri(const compact_uri &rhs) :
+            heap_(false)
+        {
+            copy(rhs);
+        }
+
+        compact_uri(compact_uri &&rhs) noexcept :
+            heap_(false)
+        {
+            steal(rhs);
+        }
+
+        ~compact_uri()
+        {
+            release();
+        }
+
+        compact_uri &operator=(const compact_uri &rhs)
+        {
+            if (this != &rhs) {
+                *this = compact_uri(rhs);
+            }
+            return *this;
+        }
+
+        compact_uri &operator=(compact_uri &&rhs) noexcept
+        {
+            if (this != &rhs) {
+                release();
+                steal(rhs);
+            }
+            return *this;
+        }
+
+        /**
+         * Replace the copy; it may be a view() of this one.
+         */
+        void assign(const uri_t &it)
+        {
+            *this = compact_uri(it);
+        }
+
+        /**
+         * A uri_t over this copy; valid while it is neither changed nor
+         * destroyed.
+         */
+        uri_t view() const
+        {
+            uri_t it;
+            view(it);
+            return it;
+        }
+
+        void view(uri_t &it) const
+        {
+            it.clear();
+            set(it.scheme, scheme_id);
+            set(it.authority, authority_id);
+            set(it.user_info, user_info_id);
+            set(it.host, host_id);
+            set(it.port, port_id);
+            set(it.path, path_id);
+            set(it.query, query_id);
+            set(it.fragment, fragment_id);
+            it.host_kind = static_cast<host_kind_t>(host_kind_);
+            it.port_number = port_number_;
+        }
+
+        /**
+         * The whole URI as text.
+         */
+        boost::string_ref str() const { return boost::string_ref(data(), size_); }
+
+        bool defined(component_id_t id) const { return size_of_[id] != undefined; }
+
+        /**
+         * The raw bytes of a component, empty when it is not defined.
+         */
+        boost::string_ref raw(component_id_t id) const
+        {
+            return defined(id) ? boost::string_ref(data() + offset_[id], size_of_[id]) : boost::string_ref();
+        }
+
+        host_kind_t host_kind() const { return static_cast<host_kind_t>(host_kind_); }
+        uint16_t port_number() const { return port_number_; }
+
+        /**
+         * Whether the text lives on the heap rather than inside the object.
+         */
+        bool allocated() const { return heap_; }
+
+        friend bool operator==(const compact_uri &lhs, const compact_uri &rhs)
+        {
+            return lhs.size_ == rhs.size_ && lhs.host_kind_ == rhs.host_kind_
+                && std::memcmp(lhs.offset_, rhs.offset_, sizeof(lhs.offset_)) == 0
+                && std::memcmp(lhs.size_of_, rhs.size_of_, sizeof(lhs.size_of_)) == 0
+                && std::memcmp(lhs.data(), rhs.data(), lhs.size_) == 0;
+        }
+
+        friend bool operator!=(const compact_uri &lhs, const compact_uri &rhs) { return !(lhs == rhs); }
+
+    private:
+        enum { undefined = 0xffff };
+
+        // Recompose it into this object, which holds no heap block.
+        void build(const uri_t &it)
+        {
+            std::size_t size = text_size(it);
+            if (size > max_size) {
+                throw std::length_error("compact_uri: uri too long");
+            }
+
+            char *out = size > inline_capacity ? (storage_.heap = new char[size]) : storage_.inline_buf;
+            heap_ = size > inline_capacity;
+            size_ = static_cast<uint16_t>(size);
+            host_kind_ = static_cast<uint8_t>(it.host_kind);
+            port_number_ = it.port_number;
+            undefine_all();
+
+            // The same recomposition as uri::write, noting where each
+            // component lands.
+            std::size_t pos = 0;
+            if (it.scheme.defined()) {
+                put(out, pos, scheme_id, it.scheme.raw());
+                out[pos++] = ':';
+            }
+            if (it.authority.defined() || it.host.defined()) {
+                out[pos++] = '/';
+                out[pos++] = '/';
+                std::size_t authority = pos;
+                if (it.user_info.defined()) {
+                    put(out, pos, user_info_id, it.user_info.raw());
+                    out[pos++] = '@';
+                }
+                bool literal = is_literal(it.host_kind);
+                if (literal) {
+                    out[pos++] = '[';
+                }
+                put(out, pos, host_id, it.host.raw());
+                if (literal) {
+                    out[pos++] = ']';
+                }
+                if (it.port.defined()) {
+                    out[pos++] = ':';
+                    put(out, pos, port_id, it.port.raw());
+                }
+                offset_[authority_id] = static_cast<uint16_t>(authority);
+                size_of_[authority_id] = static_cast<uint16_t>(pos - authority);
+            }
+            if (it.path.defined()) {
+                put(out, pos, path_id, it.path.raw());
+            }
+            if (it.query.defined()) {
+                out[pos++] = '?';
+                put(out, pos, query_id, it.query.raw());
+            }
+            if (it.fragment.defined()) {
+                out[pos++] = '#';
+                put(out, pos, fragment_id, it.fragment.raw());
+            }
+        }
+
+        static bool is_literal(host_kind_t kind)
+        {
+            return kind == host_ipv6 || kind == host_ipv_future;
+        }
+
+        static std::size_t text_size(const uri_t &it)
+        {
+            std::size_t size = it.path.raw().size();
+            if (it.scheme.defined()) {
+                size += it.scheme.raw().size() + 1;
+            }
+            if (it.authority.defined() || it.host.defined()) {
+                size += 2 + it.host.raw().size() + (is_literal(it.host_kind) ? 2 : 0);
+                if (it.user_info.defined()) {
+                    size += it.user_info.raw().size() + 1;
+                }
+                if (it.port.defined()) {
+                    size += it.port.raw().size() + 1;
+                }
+            }
+            if (it.query.defined()) {
+                size += it.query.raw().size() + 1;
+            }
+            if (it.fragment.defined()) {
+                size += it.fragment.raw().size() + 1;
+            }
+            return size;
+        }
+
+        void put(char *out, std::size_t &pos, component_id_t id, boost::string_ref raw)
+        {
+            if (!raw.empty()) {
+                std::memcpy(out + pos, raw.data(), raw.size());
+            }
+            offset_[id] = static_cast<uint16_t>(pos);
+            size_of_[id] = static_cast<uint16_t>(raw.size());
+            pos += raw.size();
+        }
+
+        void set(component_t &c, component_id_t id) const
+        {
+            if (defined(id)) {
+                const char *first = data() + offset_[id];
+                c.assign(first, first + size_of_[id]);
+            }
+        }
+
+        const char *data() const { return heap_ ? storage_.heap : storage_.inline_buf; }
+
+        void undefine_all()
+        {
+            for (std::size_t i = 0; i < component_count; ++i) {
+                offset_[i] = 0;
+                size_of_[i] = undefined;
+            }
+        }
+
+        void release()
+        {
+            if (heap_) {
+                delete[] storage_.heap;
+                heap_ = false;
+            }
+        }
+
+        // *this holds no heap block.
+        void copy(const compact_uri &rhs)
+        {
+            std::memcpy(offset_, rhs.offset_, sizeof(offset_));
+            std::memcpy(size_of_, rhs.size_of_, sizeof(size_of_));
+            size_ = rhs.size_;
+            port_number_ = rhs.port_number_;
+            host_kind_ = rhs.host_kind_;
+            if (rhs.heap_) {
+                storage_.heap = new char[size_];
+                std::memcpy(storage_.heap, rhs.storage_.heap, size_);
+                heap_ = true;
+            }
+            else {
+                std::memcpy(storage_.inline_buf, rhs.storage_.inline_buf, size_);
+            }
+        }
+
+        // *this holds no heap block; rhs is left empty.
+        void steal(compact_uri &rhs)
+        {
+            std::memcpy(offset_, rhs.offset_, sizeof(offset_));
+            std::memcpy(size_of_, rhs.size_of_, sizeof(size_of_));
+            size_ = rhs.size_;
+            port_number_ = rhs.port_number_;
+            host_kind_ = rhs.host_kind_;
+            heap_ = rhs.heap_;
+            if (heap_) {
+                storage_.heap = rhs.storage_.heap;
+            }
+            else {
+                std::memcpy(storage_.inline_buf, rhs.storage_.inline_buf, size_);
+            }
+            rhs.heap_ = false;
+            rhs.size_ = 0;
+            rhs.host_kind_ = host_none;
+            rhs.port_number_ = 0;
+            rhs.undefine_all();
+        }
+
+        uint16_t offset_[component_count];
+        uint16_t size_of_[component_count];  // undefined when not present
+        uint16_t size_;
+        uint16_t port_number_;
+        uint8_t host_kind_;
+        bool heap_;
+        union
+        {
+            char *heap;
+            char inline_buf[inline_capacity];
+        } storage_;
+    };
+} // namespace uri
+
+#endif // __uri_compact_uri_h__
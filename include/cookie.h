@@ -0,0 +1,252 @@
+#ifndef __http11_cookie_h__
+#define __http11_cookie_h__
+
+#include <boost/range/iterator_range.hpp>
+#include <boost/utility/string_ref.hpp>
+
+#include "http11_scan.h"
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+
+#if defined(__SSE2__)
+#define COOKIE_SCAN_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace http11
+{
+    /**
+     * One cookie-pair of a Cookie header, pointing into the header value.
+     */
+    struct cookie_t
+    {
+        boost::string_ref name;
+        boost::string_ref value;  // without the DQUOTEs of a quoted value
+    };
+
+    namespace scan
+    {
+        /**
+         * The first ';' in [first, last), or last: the end of a cookie-pair.
+         * Thirty-two bytes are compared at a time; inlined, this walks a
+         * header's cookie-pairs faster than a memchr call per pair.
+         */
+        inline const char *semicolon(const char *first, const char *last)
+        {
+#ifdef COOKIE_SCAN_SSE2
+            const __m128i semicolons = _mm_set1_epi8(';');
+            while (last - first >= 32) {
+                __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(first)), semicolons);
+                __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(first + 16)), semicolons);
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(a))
+                              | static_cast<unsigned>(_mm_movemask_epi8(b)) << 16;
+                if (mask) {
+                    return first + __builtin_ctz(mask);
+                }
+                first += 32;
+            }
+            while (last - first >= 16) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, semicolons)));
+                if (mask) {
+                    return first + __builtin_ctz(mask);
+                }
+                first += 16;
+            }
+#endif
+            while (first != last && *first != ';') {
+                ++first;
+            }
+            return first;
+        }
+    } // namespace scan
+
+    /**
+     * Walks the cookie-pairs of a Cookie header value ("a=1; b=2") without
+     * copying: each is found when the iterator reaches it, so a walk that
+     * stops early never looks at the rest of the header.
+     *
+     * Parsing is as lenient as browsers are in what they send: whitespace
+     * around names and values is dropped, a value wrapped in DQUOTEs loses
+     * them, and empty elements and elements without '=' are skipped. Names
+     * are not unescaped or validated.
+     *
+     * Example:
+     *     for (const http11::cookie_t &c : http11::cookies(value)) { ... }
+     */
+    class cookie_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef cookie_t value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const cookie_t *pointer;
+        typedef const cookie_t &reference;
+
+        cookie_iterator() : cur_(0), last_(0), done_(true) { }
+
+        explicit cookie_iterator(boost::string_ref value) :
+            cur_(value.data()), last_(value.data() + value.size()), done_(false)
+        {
+            advance();
+        }
+
+        reference operator*() const { return cookie_; }
+        pointer operator->() const { return &cookie_; }
+
+        cookie_iterator &operator++()
+        {
+            advance();
+            return *this;
+        }
+
+        cookie_iterator operator++(int)
+        {
+            cookie_iterator prev = *this;
+            advance();
+            return prev;
+        }
+
+        bool operator==(const cookie_iterator &rhs) const
+        {
+            return done_ == rhs.done_ && (done_ || cur_ == rhs.cur_);
+        }
+
+        bool operator!=(const cookie_iterator &rhs) const { return !(*this == rhs); }
+
+    private:
+        static bool ows(char c) { return c == ' ' || c == '\t'; }
+
+        void advance()
+        {
+            while (cur_ != last_) {
+                const char *first = cur_;
+                const char *end = scan::semicolon(first, last_);
+                cur_ = end == last_ ? last_ : end + 1;
+                if (pair(first, end)) {
+                    return;
+                }
+            }
+            done_ = true;
+        }
+
+        bool pair(const char *first, const char *last)
+        {
+            const char *eq = static_cast<const char *>(std::memchr(first, '=', last - first));
+            if (!eq) {
+                return false;
+            }
+            const char *name = first;
+            const char *name_end = eq;
+            while (name != name_end && ows(*name)) {
+                ++name;
+            }
+            while (name_end != name && ows(name_end[-1])) {
+                --name_end;
+            }
+            if (name == name_end) {
+                return false;
+            }
+            const char *value = eq + 1;
+            while (value != last && ows(*value)) {
+                ++value;
+            }
+            while (last != value && ows(last[-1])) {
+                --last;
+            }
+            if (last - value >= 2 && *value == '"' && last[-1] == '"') {
+                ++value;
+                --last;
+            }
+            cookie_.name = boost::string_ref(name, name_end - name);
+            cookie_.value = boost::string_ref(value, last - value);
+            return true;
+        }
+
+        const char *cur_;
+        const char *last_;
+        bool done_;
+        cookie_t cookie_;
+    };
+
+    inline boost::iterator_range<cookie_iterator> cookies(boost::string_ref value)
+    {
+        return boost::iterator_range<cookie_iterator>(cookie_iterator(value), cookie_iterator());
+    }
+
+    /**
+     * Look up count cookie names across one or more Cookie header values,
+     * eg those cookie_headers() finds: values[i] gets the value of the
+     * first cookie called names[i], or a null string_ref (data() == 0)
+     * when there is none. Names compare case sensitively, and a name given
+     * twice is resolved in both places. The walk stops as soon as every
+     * name is found. Returns the number found.
+     */
+    inline std::size_t find_cookies(const boost::string_ref *headers, std::size_t header_count,
+                                    const boost::string_ref *names, boost::string_ref *values, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            values[i] = boost::string_ref();
+        }
+        std::size_t found = 0;
+        for (std::size_t h = 0; h < header_count && found < count; ++h) {
+            for (cookie_iterator c(headers[h]), end; c != end; ++c) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    if (!values[i].data() && c->name == names[i]) {
+                        values[i] = c->value;
+                        if (++found == count) {
+                            return found;
+                        }
+                    }
+                }
+            }
+        }
+        return found;
+    }
+
+    inline std::size_t find_cookies(boost::string_ref header, const boost::string_ref *names,
+                                    boost::string_ref *values, std::size_t count)
+    {
+        return find_cookies(&header, 1, names, values, count);
+    }
+
+    inline bool find_cookie(boost::string_ref header, boost::string_ref name, boost::string_ref &value)
+    {
+        return find_cookies(&header, 1, &name, &value, 1) == 1;
+    }
+
+    /**
+     * The values of every Cookie header line of a request head, in order,
+     * read from the raw bytes at first. header_container_t keeps only the
+     * first of repeated headers, and a client (or an HTTP/2 gateway, which
+     * receives cookies as separate fields) may send several. Lines are
+     * matched as request_parser and header_columns match them; the name
+     * ignoring case. Returns the number of values, at most max, stored in
+     * out.
+     *
+     * Example:
+     *     boost::string_ref values[8];
+     *     std::size_t n = http11::cookie_headers(head, head_end, values, 8);
+     *     http11::find_cookies(values, n, names, found, 2);
+     */
+    inline std::size_t cookie_headers(const char *first, const char *last, boost::string_ref *out, std::size_t max)
+    {
+        const char *cur = first;
+        if (!scan::request_line(cur, last)) {
+            return 0;
+        }
+
+        std::size_t count = 0;
+        boost::string_ref key, value;
+        while (count < max && scan::header_line(cur, last, key, value)) {
+            if (scan::same_key(key, "cookie")) {
+                out[count++] = value;
+            }
+        }
+        return count;
+    }
+} // namespace http11
+
+#endif // __http11_cookie_h__
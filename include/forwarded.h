@@ -0,0 +1,345 @@
+#ifndef __http11_forwarded_h__
+#define __http11_forwarded_h__
+
+#include <boost/config/warning_disable.hpp>
+#include <boost/spirit/include/qi.hpp>
+#include <boost/spirit/include/phoenix_core.hpp>
+#include <boost/spirit/include/phoenix_operator.hpp>
+#include <boost/spirit/include/phoenix_function.hpp>
+#include <boost/utility/string_ref.hpp>
+
+#include "cidr.h"
+#include "http11_scan.h"
+#include "ipv4_address.h"
+#include "ipv6_address.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdint.h>
+
+namespace http11
+{
+    namespace qi = boost::spirit::qi;
+    namespace ascii = boost::spirit::ascii;
+    namespace phoenix = boost::phoenix;
+
+    /**
+     * One hop of an X-Forwarded-For or Forwarded list.
+     */
+    struct forwarded_node_t
+    {
+        enum kind_t
+        {
+            node_none,        // a Forwarded element without for=
+            node_address,
+            node_unknown,     // "unknown"
+            node_obfuscated   // "_hidden", RFC 7239 section 6.3
+        };
+
+        kind_t kind;
+        uri::ip_address_t address;  // for node_address
+        uint16_t port;              // 0 when there is none, or it is obfuscated
+
+        forwarded_node_t() : kind(node_none), port(0) { }
+    };
+
+    /**
+     * Which header a list comes from.
+     */
+    enum forwarded_header_t
+    {
+        x_forwarded_for,  // "192.0.2.60, [2001:db8::1]:4711, 10.0.0.1"
+        forwarded         // RFC 7239: "for=192.0.2.60;proto=http, for=\"[2001:db8::1]:4711\""
+    };
+
+    /**
+     * Parser for a single element of either list, into node. Elements are
+     * found by forwarded_list below; this only matches one of them.
+     *
+     * An X-Forwarded-For element is an address as proxies write them: an
+     * ipv4_address, a bare ipv6_address, either in the RFC 7239 node form
+     * ("1.2.3.4:80", "[2001:db8::1]:80") or "unknown".
+     *
+     * A Forwarded element is a list of ';' separated token=value pairs, of
+     * which only for= is interpreted. Its value is a node (RFC 7239
+     * section 6): an ipv4_address, "[" ipv6_address "]", "unknown" or an
+     * obfuscated "_name", with an optional ":" port; it must be quoted
+     * when it holds a ':' or '[' (IPv6 or a port), as those are not token
+     * characters.
+     */
+    template <typename Iterator>
+    struct forwarded_parser : qi::grammar<Iterator>
+    {
+        forwarded_parser(forwarded_node_t &node, forwarded_header_t header);
+
+        uri::ipv4_address<Iterator> ipv4;
+        uri::ipv6_address<Iterator> ipv6;
+
+        qi::rule<Iterator> ows, tchar, token, quoted_string;
+        qi::rule<Iterator> ipv4_node, ipv6_node, obfuscated, unknown, node_port;
+        qi::rule<Iterator> xff_node, xff_element;
+        qi::rule<Iterator> node, for_value, pair, forwarded_element;
+        qi::rule<Iterator> start;
+    }; // struct forwarded_parser
+
+    template <typename Iterator>
+    forwarded_parser<Iterator>::forwarded_parser(forwarded_node_t &it, forwarded_header_t header) :
+        forwarded_parser::base_type(start)
+    {
+        using qi::char_;
+        using qi::lit;
+        using qi::raw;
+        using qi::no_case;
+        using qi::_1;
+        using qi::_pass;
+        using ascii::alnum;
+        using phoenix::ref;
+
+        phoenix::function<uri::detail::assign_address_impl> address_;
+        qi::uint_parser<unsigned, 10, 1, 5> port;
+
+        ows               = *char_(" \t");
+        tchar             = alnum | char_("!#$%&'*+.^_`|~-");
+        token             = +tchar;
+        quoted_string     = '"' >> *(('\\' >> char_) | (char_ - '"' - '\\')) >> '"';
+
+        ipv4_node         = raw[ipv4][_pass = address_(ref(it.address), uri::ip_address_t::family_ipv4, _1),
+                                      ref(it.kind) = forwarded_node_t::node_address];
+        ipv6_node         = raw[ipv6.ipv6_attr][_pass = address_(ref(it.address), uri::ip_address_t::family_ipv6, _1),
+                                                ref(it.kind) = forwarded_node_t::node_address];
+        unknown           = no_case[lit("unknown")][ref(it.kind) = forwarded_node_t::node_unknown];
+        obfuscated        = (lit('_') >> +(alnum | char_("._-")))[ref(it.kind) = forwarded_node_t::node_obfuscated];
+        node_port         = ':' >> (port[_pass = _1 <= 65535u, ref(it.port) = _1]
+                                    | lit('_') >> +(alnum | char_("._-")));
+
+        xff_node          = ipv4_node >> -node_port
+                          | '[' >> ipv6_node >> ']' >> -node_port
+                          | ipv6_node
+                          | unknown
+                          ;
+        xff_element       = ows >> xff_node >> ows;
+
+        node              = (ipv4_node | '[' >> ipv6_node >> ']' | unknown | obfuscated) >> -node_port;
+        for_value         = '"' >> node >> '"'
+                          | ipv4_node | unknown | obfuscated
+                          ;
+        pair              = no_case[lit("for")] >> '=' >> for_value
+                          | !(no_case[lit("for")] >> '=') >> token >> '=' >> (token | quoted_string)
+                          ;
+        forwarded_element = ows >> pair % (ows >> ';' >> ows) >> ows;
+
+        if (header == x_forwarded_for) {
+            start = xff_element;
+        }
+        else {
+            start = forwarded_element;
+        }
+
+        xff_element.name("xff_element");
+        forwarded_element.name("forwarded_element");
+        start.name("start");
+    }
+
+    /**
+     * Reads an X-Forwarded-For or Forwarded header value, eg the value span
+     * request_parser gives for it, from the right: the last element was
+     * added by the proxy nearest to us, the first (in principle) names the
+     * client. Elements are parsed into binary addresses without allocating.
+     *
+     * Each proxy appends the address it received the request from, so
+     * with trusted proxies in front of us the trusted rightmost elements
+     * were written by them, and the last of those, the trusted-th from the
+     * right, is the client as the outermost trusted proxy saw it. Anything
+     * further left was supplied by the client itself and can be forged.
+     *
+     * Empty list elements are ignored, as the list ABNF asks. Elements are
+     * separated by ',', outside quoted strings for Forwarded. A proxy may
+     * add its hop as a header line of its own; header_container_t keeps
+     * only the first line, the one the client sent, so read every line
+     * with forwarded_headers and pass them all to client().
+     *
+     * Example:
+     *     boost::string_ref values[8];
+     *     std::size_t n = http11::forwarded_headers(head, head_end, http11::x_forwarded_for, values, 8);
+     *     http11::forwarded_list xff(http11::x_forwarded_for);
+     *     http11::forwarded_node_t client;
+     *     if (xff.client(values, n, 1, client)  // one proxy in front
+     *         && client.kind == http11::forwarded_node_t::node_address) { ... }
+     *
+     * With only the parsed request at hand, look the header up with
+     * headers.find(), not operator[], which would add it when missing.
+     */
+    class forwarded_list
+    {
+    public:
+        explicit forwarded_list(forwarded_header_t header) :
+            header_(header), grammar_(node_, header)
+        { }
+
+        forwarded_list(const forwarded_list &) = delete;
+        forwarded_list &operator=(const forwarded_list &) = delete;
+
+        /**
+         * Parse up to max elements from the right into out, out[0] being
+         * the rightmost. Stops at the first malformed element. Returns the
+         * number of elements parsed.
+         */
+        std::size_t parse(boost::string_ref value, forwarded_node_t *out, std::size_t max)
+        {
+            const char *first = value.data();
+            const char *cur = first + value.size();
+            std::size_t count = 0;
+            while (count < max && cur != first) {
+                const char *element;
+                if (!previous(first, cur, element)) {
+                    break;
+                }
+                if (!parse_element(element, cur, out[count])) {
+                    break;
+                }
+                ++count;
+                cur = element == first ? first : element - 1;
+            }
+            return count;
+        }
+
+        /**
+         * The client as the trusted proxies in front of us saw it: the
+         * trusted-th element from the right, never one further left. False
+         * when trusted is 0 (no element can be believed), when the list is
+         * shorter than trusted, or when any of those elements is malformed;
+         * the connection's peer address is then the best there is.
+         */
+        bool client(boost::string_ref value, std::size_t trusted, forwarded_node_t &out)
+        {
+            return client(&value, 1, trusted, out);
+        }
+
+        /**
+         * As above, over the count lines of a header in the order they came,
+         * eg from forwarded_headers: the elements are counted from the right
+         * of the last line leftwards, across the lines.
+         */
+        bool client(const boost::string_ref *values, std::size_t count, std::size_t trusted, forwarded_node_t &out)
+        {
+            if (trusted == 0) {
+                return false;
+            }
+            const char *first = 0;
+            const char *cur = 0;
+            for (std::size_t i = 0; i < trusted; ++i) {
+                const char *element;
+                while (cur == first || !previous(first, cur, element)) {
+                    if (count == 0) {
+                        return false;
+                    }
+                    --count;
+                    first = values[count].data();
+                    cur = first + values[count].size();
+                }
+                if (!parse_element(element, cur, out)) {
+                    return false;
+                }
+                cur = element == first ? first : element - 1;
+            }
+            return true;
+        }
+
+    private:
+        // The start of the last non-empty element of [first, last), which
+        // becomes its end; false when there is none.
+        bool previous(const char *first, const char *&last, const char *&element) const
+        {
+            for (;;) {
+                const char *cur = last;
+                bool quoted = false;
+                while (cur != first) {
+                    char c = cur[-1];
+                    if (header_ == forwarded && c == '"' && !escaped(first, cur - 1)) {
+                        quoted = !quoted;
+                    }
+                    else if (c == ',' && !quoted) {
+                        break;
+                    }
+                    --cur;
+                }
+                if (!blank(cur, last)) {
+                    element = cur;
+                    return true;
+                }
+                if (cur == first) {
+                    return false;
+                }
+                last = cur - 1;
+            }
+        }
+
+        // Whether the quote at p follows an odd number of backslashes.
+        static bool escaped(const char *first, const char *p)
+        {
+            std::size_t backslashes = 0;
+            while (p != first && p[-1] == '\\') {
+                --p;
+                ++backslashes;
+            }
+            return backslashes % 2 == 1;
+        }
+
+        static bool blank(const char *first, const char *last)
+        {
+            for (; first != last; ++first) {
+                if (*first != ' ' && *first != '\t') {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool parse_element(const char *first, const char *last, forwarded_node_t &out)
+        {
+            node_ = forwarded_node_t();
+            if (!qi::parse(first, last, grammar_) || first != last) {
+                return false;
+            }
+            out = node_;
+            return true;
+        }
+
+        forwarded_header_t header_;
+        forwarded_node_t node_;
+        forwarded_parser<const char *> grammar_;
+    };
+
+    /**
+     * The values of every X-Forwarded-For, or every Forwarded, header line
+     * of a request head, in order, read from the raw bytes at first. Lines
+     * are matched as cookie_headers matches them. When there are more than
+     * max, the last max are kept, as those hold the hops nearest to us.
+     * Returns the number of values stored in out.
+     */
+    inline std::size_t forwarded_headers(const char *first, const char *last, forwarded_header_t header,
+                                         boost::string_ref *out, std::size_t max)
+    {
+        const char *cur = first;
+        if (max == 0 || !scan::request_line(cur, last)) {
+            return 0;
+        }
+
+        const char *name = header == x_forwarded_for ? "x-forwarded-for" : "forwarded";
+        std::size_t count = 0;
+        boost::string_ref key, value;
+        while (scan::header_line(cur, last, key, value)) {
+            if (!scan::same_key(key, name)) {
+                continue;
+            }
+            if (count == max) {
+                std::copy(out + 1, out + max, out);
+                --count;
+            }
+            out[count++] = value;
+        }
+        return count;
+    }
+} // namespace http11
+
+#endif // __http11_forwarded_h__
@@ -0,0 +1,189 @@
+#ifndef __http11_header_columns_h__
+#define __http11_header_columns_h__
+
+#include <boost/utility/string_ref.hpp>
+
+#include "http11_scan.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace http11
+{
+    /**
+     * Columnar extraction of a few headers from many requests.
+     *
+     * For analytics that only look at, say, Host and User-Agent, building a
+     * request_t per request is mostly wasted. Register the wanted header
+     * names with add(), then parse() request heads one after another: each
+     * adds a row, and each column gets the (offset, length) of its header's
+     * value in that request, relative to a base pointer the caller chooses
+     * (typically the start of the buffer holding a batch of requests). Other
+     * headers are only scanned, never copied.
+     *
+     * parse() accepts the same heads as request_parser, except that the
+     * request line is only checked to be printable. It stops before the
+     * blank line and, like the header map, keeps the first of repeated
+     * headers; names are matched ignoring case.
+     *
+     * Example:
+     *     http11::header_columns columns;
+     *     std::size_t host = columns.add("Host");
+     *     while (columns.parse(buf, first, last)) { skip_blank_line(first); }
+     *     for (std::size_t row = 0; row < columns.rows(); ++row) {
+     *         count(columns.value(buf, row, host));
+     *     }
+     */
+    class header_columns
+    {
+    public:
+        typedef uint32_t offset_t;
+
+        enum { npos = 0xffffffff };  // offset of a header that was not present
+
+        header_columns() : rows_(0) { }
+
+        /**
+         * Register a header; returns its column number. Adding a name twice
+         * returns the existing column.
+         */
+        std::size_t add(const std::string &name)
+        {
+            for (std::size_t i = 0; i < names_.size(); ++i) {
+                if (same_name(names_[i], name.data(), name.size())) {
+                    return i;
+                }
+            }
+            names_.push_back(name);
+            offsets_.push_back(std::vector<offset_t>(rows_, static_cast<offset_t>(npos)));
+            lengths_.push_back(std::vector<offset_t>(rows_, 0));
+            return names_.size() - 1;
+        }
+
+        std::size_t columns() const { return names_.size(); }
+        std::size_t rows() const { return rows_; }
+
+        const std::string &name(std::size_t column) const { return names_[column]; }
+
+        /**
+         * The column's offsets and lengths, one per row.
+         */
+        const std::vector<offset_t> &offsets(std::size_t column) const { return offsets_[column]; }
+        const std::vector<offset_t> &lengths(std::size_t column) const { return lengths_[column]; }
+
+        bool defined(std::size_t row, std::size_t column) const
+        {
+            return offsets_[column][row] != npos;
+        }
+
+        /**
+         * The value of column in row, given the base passed to parse(); an
+         * empty string_ref when the header was not present.
+         */
+        boost::string_ref value(const char *base, std::size_t row, std::size_t column) const
+        {
+            if (!defined(row, column)) {
+                return boost::string_ref();
+            }
+            return boost::string_ref(base + offsets_[column][row], lengths_[column][row]);
+        }
+
+        void reserve(std::size_t rows)
+        {
+            for (std::size_t i = 0; i < names_.size(); ++i) {
+                offsets_[i].reserve(rows);
+                lengths_[i].reserve(rows);
+            }
+        }
+
+        /**
+         * Drop all rows, keeping the columns and the memory.
+         */
+        void clear()
+        {
+            for (std::size_t i = 0; i < names_.size(); ++i) {
+                offsets_[i].clear();
+                lengths_[i].clear();
+            }
+            rows_ = 0;
+        }
+
+        /**
+         * Parse one request head at first, adding a row; first is left
+         * before the blank line. On failure no row is added and first is
+         * left where the head stopped matching. Offsets must fit offset_t.
+         */
+        bool parse(const char *base, const char *&first, const char *last)
+        {
+            if (static_cast<std::size_t>(last - base) >= npos) {
+                return false;
+            }
+
+            const char *cur = first;
+            if (!scan::request_line(cur, last)) {
+                first = cur;
+                return false;
+            }
+
+            for (std::size_t i = 0; i < names_.size(); ++i) {
+                offsets_[i].push_back(static_cast<offset_t>(npos));
+                lengths_[i].push_back(0);
+            }
+            ++rows_;
+
+            // *(header >> crlf), see request_parser.
+            boost::string_ref key, value;
+            for (;;) {
+                const char *line = cur;
+                if (!scan::header_line(cur, last, key, value)) {
+                    first = line;
+                    return true;
+                }
+                store(key.data(), key.size(), value.data() - base, value.size());
+            }
+        }
+
+    private:
+        static bool same_name(const std::string &name, const char *key, std::size_t size)
+        {
+            if (name.size() != size) {
+                return false;
+            }
+            for (std::size_t i = 0; i < size; ++i) {
+                if (lower(name[i]) != lower(key[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Names come from the caller and may hold any byte, so only
+        // letters are folded.
+        static char lower(char c)
+        {
+            return c >= 'A' && c <= 'Z' ? c | 0x20 : c;
+        }
+
+        void store(const char *key, std::size_t size, std::size_t offset, std::size_t length)
+        {
+            for (std::size_t i = 0; i < names_.size(); ++i) {
+                if (same_name(names_[i], key, size)) {
+                    if (offsets_[i].back() == npos) {
+                        offsets_[i].back() = static_cast<offset_t>(offset);
+                        lengths_[i].back() = static_cast<offset_t>(length);
+                    }
+                    return;
+                }
+            }
+        }
+
+        std::vector<std::string> names_;
+        std::vector<std::vector<offset_t> > offsets_;
+        std::vector<std::vector<offset_t> > lengths_;
+        std::size_t rows_;
+    };
+} // namespace http11
+
+#endif // __http11_header_columns_h__
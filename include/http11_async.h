@@ -0,0 +1,440 @@
+#ifndef __http11_async_h__
+#define __http11_async_h__
+
+/**
+ * Coroutine front end for the request parser (C++20).
+ *
+ * async_request_reader pulls bytes from an asynchronous source straight into
+ * its own buffer and hands each complete request head to request_parser.
+ * While a head is incomplete it suspends on the source; the search for the
+ * blank line ending the head resumes where it stopped, so no byte is looked
+ * at twice and the grammar runs exactly once per request, over the bytes as
+ * they were read (no gather copy).
+ *
+ * A source is any type with
+ *
+ *     awaitable read_some(char *buf, std::size_t size);
+ *
+ * whose co_await yields the number of bytes read (an ssize_t), 0 at the
+ * end of the stream or -1 on a read error. memory_source and pipe_source
+ * (with io_loop) are provided.
+ */
+
+#include "http11_parser.h"
+
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace http11
+{
+    /**
+     * A lazily started coroutine producing a T. co_await it from another
+     * coroutine, or start() it and check done() / result() when driving it
+     * from plain code (eg, alongside io_loop::run()).
+     */
+    template <typename T>
+    class task
+    {
+    public:
+        struct promise_type
+        {
+            T value;
+            std::exception_ptr error;
+            std::coroutine_handle<> continuation;
+
+            task get_return_object()
+            {
+                return task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept { return std::suspend_always(); }
+
+            // Hand control back to whoever awaited us, if anyone.
+            struct final_awaiter
+            {
+                bool await_ready() noexcept { return false; }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept
+                {
+                    std::coroutine_handle<> next = h.promise().continuation;
+                    return next ? next : std::noop_coroutine();
+                }
+
+                void await_resume() noexcept { }
+            };
+
+            final_awaiter final_suspend() noexcept { return final_awaiter(); }
+
+            void return_value(T v) { value = std::move(v); }
+            void unhandled_exception() { error = std::current_exception(); }
+        };
+
+        task(task &&rhs) noexcept : handle_(rhs.handle_) { rhs.handle_ = 0; }
+
+        ~task()
+        {
+            if (handle_) {
+                handle_.destroy();
+            }
+        }
+
+        task(const task &) = delete;
+        task &operator=(const task &) = delete;
+
+        void start() { handle_.resume(); }
+        bool done() const { return handle_.done(); }
+
+        T &result()
+        {
+            if (handle_.promise().error) {
+                std::rethrow_exception(handle_.promise().error);
+            }
+            return handle_.promise().value;
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            handle_.promise().continuation = awaiting;
+            return handle_;
+        }
+
+        T await_resume() { return std::move(result()); }
+
+    private:
+        explicit task(std::coroutine_handle<promise_type> h) : handle_(h) { }
+
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    /**
+     * Source over bytes in memory, handed out at most chunk bytes per read.
+     * Reads never suspend.
+     */
+    class memory_source
+    {
+    public:
+        memory_source(const char *first, const char *last, std::size_t chunk = static_cast<std::size_t>(-1)) :
+            cur_(first), last_(last), chunk_(chunk)
+        { }
+
+        struct read_awaiter
+        {
+            std::size_t n;
+
+            bool await_ready() const noexcept { return true; }
+            void await_suspend(std::coroutine_handle<>) const noexcept { }
+            ssize_t await_resume() const noexcept { return static_cast<ssize_t>(n); }
+        };
+
+        read_awaiter read_some(char *buf, std::size_t size)
+        {
+            std::size_t n = static_cast<std::size_t>(last_ - cur_);
+            n = n < size ? n : size;
+            n = n < chunk_ ? n : chunk_;
+            std::memcpy(buf, cur_, n);
+            cur_ += n;
+            read_awaiter a = { n };
+            return a;
+        }
+
+    private:
+        const char *cur_;
+        const char *last_;
+        std::size_t chunk_;
+    };
+
+    /**
+     * Minimal single threaded readiness loop: coroutines waiting for a file
+     * descriptor to become readable are resumed by run_once() / run().
+     */
+    class io_loop
+    {
+    public:
+        void wait_readable(int fd, std::coroutine_handle<> h)
+        {
+            waiting_.push_back(std::make_pair(fd, h));
+        }
+
+        bool idle() const { return waiting_.empty(); }
+
+        /**
+         * Wait up to timeout_ms for any descriptor to become readable and
+         * resume its coroutines. Returns the number resumed.
+         */
+        std::size_t run_once(int timeout_ms = -1)
+        {
+            if (waiting_.empty()) {
+                return 0;
+            }
+
+            std::vector<pollfd> fds(waiting_.size());
+            for (std::size_t i = 0; i < waiting_.size(); ++i) {
+                fds[i].fd = waiting_[i].first;
+                fds[i].events = POLLIN;
+                fds[i].revents = 0;
+            }
+            if (::poll(&fds[0], fds.size(), timeout_ms) <= 0) {
+                return 0;
+            }
+
+            // Take the ready ones out first: a resumed coroutine may wait again.
+            std::vector<std::coroutine_handle<> > ready;
+            std::vector<std::pair<int, std::coroutine_handle<> > > still;
+            for (std::size_t i = 0; i < waiting_.size(); ++i) {
+                if (fds[i].revents) {
+                    ready.push_back(waiting_[i].second);
+                }
+                else {
+                    still.push_back(waiting_[i]);
+                }
+            }
+            waiting_.swap(still);
+
+            for (std::size_t i = 0; i < ready.size(); ++i) {
+                ready[i].resume();
+            }
+            return ready.size();
+        }
+
+        void run()
+        {
+            while (!waiting_.empty()) {
+                run_once();
+            }
+        }
+
+    private:
+        std::vector<std::pair<int, std::coroutine_handle<> > > waiting_;
+    };
+
+    /**
+     * Source reading a pipe or socket. The descriptor is switched to non
+     * blocking; a read that would block suspends until loop reports it
+     * readable, and is tried again then. A wakeup that finds nothing to
+     * read (another reader got there first) parks again. A failed read
+     * yields -1, with its errno kept in error().
+     */
+    class pipe_source
+    {
+    public:
+        pipe_source(int fd, io_loop &loop) : fd_(fd), loop_(loop), error_(0)
+        {
+            ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL) | O_NONBLOCK);
+        }
+
+        /**
+         * One read, made before suspending and again after being resumed;
+         * errno is taken straight after each, before anything else on the
+         * loop can overwrite it.
+         */
+        struct read_awaiter
+        {
+            pipe_source &source;
+            char *buf;
+            std::size_t size;
+            ssize_t n;
+            int error;
+
+            bool await_ready()
+            {
+                attempt();
+                return !would_block();
+            }
+
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                source.loop_.wait_readable(source.fd_, h);
+            }
+
+            void await_resume()
+            {
+                if (would_block()) {
+                    attempt();
+                }
+            }
+
+            void attempt()
+            {
+                n = ::read(source.fd_, buf, size);
+                error = n < 0 ? errno : 0;
+            }
+
+            bool would_block() const
+            {
+                return n < 0 && (error == EAGAIN || error == EWOULDBLOCK);
+            }
+        };
+
+        task<ssize_t> read_some(char *buf, std::size_t size)
+        {
+            for (;;) {
+                read_awaiter a = { *this, buf, size, 0, 0 };
+                co_await a;
+                if (a.n >= 0) {
+                    co_return a.n;
+                }
+                if (!a.would_block() && a.error != EINTR) {
+                    error_ = a.error;
+                    co_return -1;
+                }
+            }
+        }
+
+        /**
+         * errno of the last failed read.
+         */
+        int error() const { return error_; }
+
+    private:
+        int fd_;
+        io_loop &loop_;
+        int error_;
+    };
+
+    enum read_status_t
+    {
+        read_ok,
+        read_end_of_stream,  // the source ended between requests
+        read_truncated,      // the source ended inside a request head
+        read_bad_request,    // the head did not parse
+        read_too_large,      // no blank line within max_head bytes
+        read_error           // the source failed, eg ECONNRESET
+    };
+
+    /**
+     * Reads request heads from a source, see above. The request filled in
+     * by read() refers to the reader's buffer and stays valid until the
+     * next call. Bytes after a head (a body, or pipelined requests) stay
+     * buffered for the caller or the next read().
+     */
+    template <typename Source>
+    class async_request_reader
+    {
+    public:
+        explicit async_request_reader(Source &source, std::size_t max_head = 64 * 1024) :
+            source_(source), max_head_(max_head), grammar_(req_),
+            begin_(0), end_(0), scan_(0), consumed_(0)
+        {
+            buf_.resize(4096);
+        }
+
+        task<read_status_t> read(request_t &req)
+        {
+            discard_head();
+
+            for (;;) {
+                std::size_t head_end = find_head_end();
+                if (head_end) {
+                    co_return parse(req, head_end);
+                }
+                if (end_ - begin_ >= max_head_) {
+                    co_return read_too_large;
+                }
+
+                make_room();
+                ssize_t n = co_await source_.read_some(&buf_[end_], buf_.size() - end_);
+                if (n < 0) {
+                    co_return read_error;
+                }
+                if (n == 0) {
+                    co_return end_ == begin_ ? read_end_of_stream : read_truncated;
+                }
+                end_ += static_cast<std::size_t>(n);
+            }
+        }
+
+        /**
+         * Bytes read past the last head, eg the start of a body.
+         */
+        const char *rest_begin() const { return buf_.data() + consumed_; }
+        const char *rest_end() const { return buf_.data() + end_; }
+
+        /**
+         * Drop n bytes of rest(), eg after handling a body.
+         */
+        void consume(std::size_t n) { consumed_ += n; }
+
+    private:
+        // Forget the previous head so the next search starts after it.
+        void discard_head()
+        {
+            begin_ = consumed_;
+            scan_ = begin_;
+        }
+
+        // Offset just past "\r\n\r\n", or 0. The search resumes where the
+        // previous one gave up.
+        std::size_t find_head_end()
+        {
+            const char *base = buf_.data();
+            while (end_ - scan_ >= 4) {
+                const char *cr = static_cast<const char *>(std::memchr(base + scan_, '\r', end_ - scan_ - 3));
+                if (!cr) {
+                    scan_ = end_ - 3;
+                    return 0;
+                }
+                if (std::memcmp(cr, "\r\n\r\n", 4) == 0) {
+                    scan_ = cr - base;
+                    return scan_ + 4;
+                }
+                scan_ = cr - base + 1;
+            }
+            return 0;
+        }
+
+        // Move unconsumed bytes to the front and grow when full.
+        void make_room()
+        {
+            if (begin_ > 0) {
+                std::memmove(&buf_[0], &buf_[begin_], end_ - begin_);
+                end_ -= begin_;
+                scan_ -= begin_;
+                consumed_ -= begin_;
+                begin_ = 0;
+            }
+            if (end_ == buf_.size()) {
+                buf_.resize(buf_.size() * 2);
+            }
+        }
+
+        // The grammar is bound to req_, which swaps with the caller's
+        // request so both keep their capacity.
+        read_status_t parse(request_t &req, std::size_t head_end)
+        {
+            std::swap(req_, req);
+            req_.clear();
+
+            const char *first = buf_.data() + begin_;
+            const char *last = buf_.data() + head_end;
+            consumed_ = head_end;
+
+            // The grammar stops before the blank line.
+            bool ok = boost::spirit::qi::parse(first, last, grammar_);
+            std::swap(req_, req);
+            return ok && first == last - 2 ? read_ok : read_bad_request;
+        }
+
+        Source &source_;
+        std::size_t max_head_;
+        request_t req_;
+        request_parser<const char *> grammar_;
+        std::vector<char> buf_;
+        std::size_t begin_;     // start of the current head
+        std::size_t end_;       // end of the bytes read
+        std::size_t scan_;      // where the blank line search resumes
+        std::size_t consumed_;  // end of the last parsed head
+    };
+} // namespace http11
+
+#endif // __http11_async_h__
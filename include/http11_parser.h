@@ -5,57 +5,61 @@
 #include <boost/spirit/include/phoenix_core.hpp>
 #include <boost/spirit/include/phoenix_operator.hpp>
 #include <boost/spirit/include/phoenix_object.hpp>
-#include <boost/spirit/include/phoenix_stl.hpp>
+#include <boost/spirit/include/phoenix_function.hpp>
+#include <boost/fusion/include/adapt_struct.hpp>
 
 #include <string>
-#include <map>
 
+#include "http11_request.h"
+#include "http11_scan.h"
 #include "uri_parser.h"
 
+BOOST_FUSION_ADAPT_STRUCT(
+    http11::version_t,
+    (uint8_t, major)
+    (uint8_t, minor)
+)
+
 namespace http11
 {
     namespace qi = boost::spirit::qi;
     namespace ascii = boost::spirit::ascii;
     namespace phoenix = boost::phoenix;
 
-    typedef std::string header_key_t;
-    typedef std::string header_value_t;
-    typedef std::map<header_key_t, header_value_t> header_container_t;
-    typedef header_container_t::value_type header_container_value_type;
-
-    /**
-     * Structure representing an entire HTTP 1.1 request.
-     */
-    struct request_t
+    namespace detail
     {
-        std::string method;
-        std::string version;
-        uri::uri_t uri;
-        header_container_t headers;
-
-        request_t() { }
-
-        std::string to_string()
+        /**
+         * Semantic action helpers filling the next header entry in place,
+         * see header_container_t::next(); assigning into the existing
+         * strings keeps their capacity.
+         */
+        struct header_key_impl
         {
-            std::ostringstream str;
-            str << "request line:"
-                << "method("  << method  << ")," 
-                << "version(" << version << "),"
-                << "uri("     << uri.to_string() << "),"
-                << std::endl;
-
-            std::cerr << "headers:" << std::endl;
-            header_container_t::const_iterator cur = headers.begin();
-            header_container_t::const_iterator end = headers.end();
-            for (; cur != end; ++cur) {
-                str << "key("   << (*cur).first  << "),"
-                    << "value(" << (*cur).second << ")"
-                    << std::endl;
+            typedef void result_type;
+
+            template <typename Range>
+            void operator()(header_container_t &headers, const Range &r) const
+            {
+                headers.next().first.assign(&*r.begin(), r.end() - r.begin());
+                header_container_t::source_t &source = headers.next_source();
+                source.key = boost::string_ref(&*r.begin(), r.end() - r.begin());
+                source.value = boost::string_ref();
             }
+        };
 
-            return str.str();
-        }
-    };
+        struct header_value_impl
+        {
+            typedef void result_type;
+
+            template <typename Range>
+            void operator()(header_container_t &headers, const Range &r) const
+            {
+                headers.next().second.assign(&*r.begin(), r.end() - r.begin());
+                headers.next_source().value = boost::string_ref(&*r.begin(), r.end() - r.begin());
+                headers.commit();
+            }
+        };
+    } // namespace detail
 
     /**
      * An implementation of an HTTP 1.1 parser
@@ -63,62 +67,73 @@ namespace http11
     template <typename Iterator>
     struct request_parser : qi::grammar<Iterator>
     {
-        request_parser(request_t &it) : 
-            request_parser::base_type(start),
-            uri(it.uri)
-        {
-            using qi::char_;
-            using qi::omit;
-            using qi::repeat;
-
-            using ascii::space;
-            using ascii::alnum;
-            using ascii::upper;
-            using ascii::print;
-            using ascii::digit;
-            using ascii::string;
-
-            using phoenix::ref;
-            using phoenix::val;
-            using phoenix::construct;
-            using phoenix::insert;
-
-            // Misc.
-            crlf            = string("\r\n");
-
-            // Method 
-            method_attr     = repeat(1, 20)[upper | digit];
-            method          = method_attr[ref(it.method) = qi::_1] >> space;
-
-            // HTTP-Version 
-            version_attr    = +digit >> char_('.') >> +digit;
-            version         = string("HTTP/") >> version_attr[ref(it.version) = qi::_1];
-
-            // Full Request-Line
-            http_request    = method >> uri >> ' ' >> version;
-
-            // Headers: key: value\r\n[key: value\r\n...]
-            //TODO: continuation lines
-            header_key      = +(alnum | '-');
-            header_value    = +(print | ' ' | '\t');
-            header          = (header_key >> ':' >> omit[*space] >> header_value)[
-                insert(ref(it.headers), construct<header_container_value_type>(qi::_1, qi::_2))
-            ];
-
-            //TODO: where does the input stream begin? How do we pass that back to the parser?
-            start = http_request >> crlf >> *(header >> crlf);
-        }
+        /**
+         * Parse into it; cache is handed to the URI grammar, see
+         * uri::authority_cache.
+         */
+        request_parser(request_t &it, uri::authority_cache *cache = 0);
        
         uri::uri_parser<Iterator> uri;
-        qi::rule<Iterator, std::string()> crlf;
+        qi::rule<Iterator> crlf;
         qi::rule<Iterator> http_request;
-        qi::rule<Iterator> method, version;
-        qi::rule<Iterator, std::string()> method_attr, version_attr;
-        qi::rule<Iterator, std::string()> header_key, header_value;
-        qi::rule<Iterator, header_container_value_type> header;
+        qi::rule<Iterator, version_t()> version;
+        qi::rule<Iterator> header_key, header_value;
+        qi::rule<Iterator> header;
         qi::rule<Iterator> start;
     };
 
+    template <typename Iterator>
+    request_parser<Iterator>::request_parser(request_t &it, uri::authority_cache *cache) :
+        request_parser::base_type(start),
+        uri(it.uri, cache)
+    {
+        using qi::char_;
+        using qi::omit;
+
+        using ascii::space;
+        using ascii::alnum;
+        using ascii::print;
+        using ascii::string;
+
+        using qi::raw;
+
+        phoenix::function<detail::header_key_impl> header_key_;
+        phoenix::function<detail::header_value_impl> header_value_;
+
+        qi::uint_parser<uint8_t> uint8_;
+
+        // Misc.
+        crlf            = literal_parser("\r\n");
+
+        // HTTP-Version, the general form. HTTP/1.1 and HTTP/1.0 never get
+        // here, see below.
+        version         = literal_parser("HTTP/") >> uint8_ >> '.' >> uint8_;
+
+        // Full Request-Line. The method, repeat(1, 20)[upper | digit], and
+        // the common versions are scanned directly rather than through rule
+        // calls; only the URI needs the full grammar.
+        http_request    = term(method_parser())[phoenix::ref(it.method) = qi::_1] >> space
+                       >> uri >> ' '
+                       >> (term(common_version_parser()) | version)[phoenix::ref(it.version) = qi::_1];
+
+        // Headers: key: value\r\n[key: value\r\n...]
+        //TODO: continuation lines
+        header_key      = +(alnum | char_('-'));
+        header_value    = field_value_parser();  // +(print | char_('\t'))
+        // Written straight into the next header entry, so no strings are
+        // built along the way.
+        header          = raw[header_key][header_key_(phoenix::ref(it.headers), qi::_1)] >> ':' >> omit[*space]
+                       >> raw[header_value][header_value_(phoenix::ref(it.headers), qi::_1)];
+
+        //TODO: where does the input stream begin? How do we pass that back to the parser?
+        start = http_request >> crlf >> *(header >> crlf);
+    }
+
+#ifdef SPIRIT_PARSERS_EXTERN_TEMPLATES
+    // Instantiated once in the spirit_parsers library, see src/request_parser.cpp.
+    extern template struct request_parser<const char *>;
+    extern template struct request_parser<std::string::const_iterator>;
+#endif
 } // namespace http11
 
 #endif // __http11_parser_h__
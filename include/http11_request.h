@@ -0,0 +1,294 @@
+#ifndef __http11_request_h__
+#define __http11_request_h__
+
+#include <boost/iterator/indirect_iterator.hpp>
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "uri.h"
+
+namespace http11
+{
+    typedef std::string header_key_t;
+    typedef std::string header_value_t;
+
+    /**
+     * The headers of a request, in the order they were received.
+     *
+     * The interface is the subset of std::map the parser and its users
+     * need (find, count, operator[], insert keeping the first value of a
+     * repeated key), over an array of entries: a dozen headers are found
+     * faster by a linear scan than through a tree, and clear() keeps every
+     * entry and string allocated, so a container reused across requests
+     * stops allocating once it has seen the largest of them. Keys compare
+     * case sensitively, as before.
+     *
+     * Each entry is allocated on its own, so as with std::map, references
+     * to entries (eg from operator[]) stay valid while others are added,
+     * until clear(). Unlike std::map, iterators do not: adding an entry
+     * invalidates them all.
+     *
+     * Entries filled in by request_parser also remember where their key
+     * and value were in the input (see source()), so http11::write can
+     * point at the original bytes instead of the copies.
+     */
+    class header_container_t
+    {
+    public:
+        typedef std::pair<header_key_t, header_value_t> value_type;
+    private:
+        typedef std::vector<std::unique_ptr<value_type> > entries_t;
+
+    public:
+        typedef boost::indirect_iterator<entries_t::iterator> iterator;
+        typedef boost::indirect_iterator<entries_t::const_iterator, const value_type> const_iterator;
+        typedef std::size_t size_type;
+
+        /**
+         * The input bytes an entry was parsed from; empty for entries added
+         * through operator[] or insert. Only meaningful while the input is,
+         * and only while they still equal the entry (http11::write checks).
+         */
+        struct source_t
+        {
+            boost::string_ref key;
+            boost::string_ref value;
+        };
+
+        header_container_t() : size_(0) { }
+
+        header_container_t(const header_container_t &rhs) : size_(0)
+        {
+            *this = rhs;
+        }
+
+        header_container_t &operator=(const header_container_t &rhs)
+        {
+            if (this != &rhs) {
+                clear();
+                for (size_type i = 0; i < rhs.size_; ++i) {
+                    next() = *rhs.entries_[i];
+                    sources_[size_] = rhs.sources_[i];
+                    ++size_;
+                }
+            }
+            return *this;
+        }
+
+        header_container_t(header_container_t &&rhs) noexcept : size_(0)
+        {
+            *this = std::move(rhs);
+        }
+
+        /**
+         * Take rhs's entries, leaving it empty and ready for reuse.
+         */
+        header_container_t &operator=(header_container_t &&rhs) noexcept
+        {
+            if (this != &rhs) {
+                entries_ = std::move(rhs.entries_);
+                sources_ = std::move(rhs.sources_);
+                size_ = rhs.size_;
+                rhs.entries_.clear();
+                rhs.sources_.clear();
+                rhs.size_ = 0;
+            }
+            return *this;
+        }
+
+        iterator begin() { return entries_.begin(); }
+        iterator end() { return entries_.begin() + size_; }
+        const_iterator begin() const { return entries_.begin(); }
+        const_iterator end() const { return entries_.begin() + size_; }
+
+        size_type size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        iterator find(const header_key_t &key)
+        {
+            iterator cur = begin();
+            for (; cur != end() && cur->first != key; ++cur) { }
+            return cur;
+        }
+
+        const_iterator find(const header_key_t &key) const
+        {
+            const_iterator cur = begin();
+            for (; cur != end() && cur->first != key; ++cur) { }
+            return cur;
+        }
+
+        size_type count(const header_key_t &key) const
+        {
+            return find(key) != end() ? 1 : 0;
+        }
+
+        /**
+         * The value of key, added empty when missing.
+         */
+        header_value_t &operator[](const header_key_t &key)
+        {
+            iterator i = find(key);
+            if (i != end()) {
+                return i->second;
+            }
+            value_type &entry = next();
+            entry.first = key;
+            entry.second.clear();
+            sources_[size_] = source_t();
+            ++size_;
+            return entry.second;
+        }
+
+        /**
+         * Add v unless its key is already there.
+         */
+        std::pair<iterator, bool> insert(const value_type &v)
+        {
+            iterator i = find(v.first);
+            if (i != end()) {
+                return std::make_pair(i, false);
+            }
+            value_type &entry = next();
+            entry.first = v.first;
+            entry.second = v.second;
+            sources_[size_] = source_t();
+            return std::make_pair(begin() + size_++, true);
+        }
+
+        /**
+         * Empty the container; the entries and their strings keep their
+         * capacity for the next request.
+         */
+        void clear()
+        {
+            for (size_type i = 0; i < size_; ++i) {
+                sources_[i] = source_t();
+            }
+            size_ = 0;
+        }
+
+        const source_t &source(const_iterator i) const
+        {
+            return sources_[i - begin()];
+        }
+
+        /**
+         * The entry after the last one, for filling in place; commit()
+         * adds it, unless its key is already there.
+         */
+        value_type &next()
+        {
+            if (size_ == entries_.size()) {
+                entries_.push_back(std::unique_ptr<value_type>(new value_type()));
+                sources_.push_back(source_t());
+            }
+            return *entries_[size_];
+        }
+
+        /**
+         * The source of the entry next() returns.
+         */
+        source_t &next_source()
+        {
+            next();
+            return sources_[size_];
+        }
+
+        bool commit()
+        {
+            value_type &entry = *entries_[size_];
+            for (size_type i = 0; i < size_; ++i) {
+                if (entries_[i]->first == entry.first) {
+                    return false;
+                }
+            }
+            ++size_;
+            return true;
+        }
+
+    private:
+        entries_t entries_;                // [size_, end) are spare
+        std::vector<source_t> sources_;    // one per entry
+        size_type size_;
+    };
+
+    typedef header_container_t::value_type header_container_value_type;
+
+    /**
+     * HTTP-Version of a request as a major/minor pair, eg 1.1.
+     */
+    struct version_t
+    {
+        uint8_t major;
+        uint8_t minor;
+
+        version_t() : major(0), minor(0) { }
+        version_t(uint8_t major, uint8_t minor) : major(major), minor(minor) { }
+
+        bool operator==(const version_t &rhs) const { return major == rhs.major && minor == rhs.minor; }
+        bool operator!=(const version_t &rhs) const { return !(*this == rhs); }
+
+        std::string to_string() const
+        {
+            std::ostringstream str;
+            str << static_cast<unsigned>(major) << '.' << static_cast<unsigned>(minor);
+            return str.str();
+        }
+    };
+
+    /**
+     * Structure representing an entire HTTP 1.1 request.
+     */
+    struct request_t
+    {
+        std::string method;
+        version_t version;
+        uri::uri_t uri;
+        header_container_t headers;
+
+        request_t() { }
+
+        /**
+         * Empty the request for the next parse, keeping the capacity of
+         * the method, the URI's decode buffers and the headers.
+         */
+        void clear()
+        {
+            method.clear();
+            version = version_t();
+            uri.clear();
+            headers.clear();
+        }
+
+        std::string to_string() const
+        {
+            std::ostringstream str;
+            str << "request line:"
+                << "method("  << method  << ")," 
+                << "version(" << version.to_string() << "),"
+                << "uri("     << uri.to_string() << "),"
+                << std::endl;
+
+            str << "headers:" << std::endl;
+            header_container_t::const_iterator cur = headers.begin();
+            header_container_t::const_iterator end = headers.end();
+            for (; cur != end; ++cur) {
+                str << "key("   << (*cur).first  << "),"
+                    << "value(" << (*cur).second << ")"
+                    << std::endl;
+            }
+
+            return str.str();
+        }
+    };
+} // namespace http11
+
+#endif // __http11_request_h__
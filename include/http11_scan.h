@@ -0,0 +1,374 @@
+#ifndef __http11_scan_h__
+#define __http11_scan_h__
+
+#include <boost/spirit/include/qi.hpp>
+#include <boost/utility/string_ref.hpp>
+
+#include "http11_request.h"
+
+#include <cstddef>
+#include <cstring>
+#include <stdint.h>
+#include <string>
+
+namespace http11
+{
+    namespace qi = boost::spirit::qi;
+
+    /**
+     * Scanners behind the request grammar's hot loops. Each comes as a
+     * generic template that works on any forward iterator and a const char *
+     * overload that the compiler picks for pointer iterators; the two match
+     * exactly the same input, the overload just gets there with pointer-only
+     * tricks (memcmp, eight bytes at a time).
+     */
+    namespace scan
+    {
+        inline bool field_char(unsigned char c)
+        {
+            return (c >= 0x20 && c < 0x7f) || c == '\t';
+        }
+
+        /**
+         * End of the longest run of printable characters and tabs (a header
+         * field value) starting at first.
+         */
+        template <typename Iterator>
+        Iterator field_value(Iterator first, Iterator last)
+        {
+            while (first != last && field_char(static_cast<unsigned char>(*first))) {
+                ++first;
+            }
+            return first;
+        }
+
+        inline const char *field_value(const char *first, const char *last)
+        {
+            const uint64_t ones = 0x0101010101010101ULL;
+            const uint64_t highs = 0x8080808080808080ULL;
+
+            // A word is all printable when no byte is below 0x20, equal to
+            // 0x7f or has its top bit set. Any other word, tabs included, is
+            // finished a byte at a time.
+            while (last - first >= 8) {
+                uint64_t w;
+                std::memcpy(&w, first, sizeof(w));
+                uint64_t del = w ^ (ones * 0x7f);
+                uint64_t bad = ((w - ones * 0x20) | (del - ones) | w) & highs;
+                if (bad) {
+                    break;
+                }
+                first += 8;
+            }
+            while (first != last && field_char(static_cast<unsigned char>(*first))) {
+                ++first;
+            }
+            return first;
+        }
+
+        /**
+         * Match the size bytes of s at first, moving first past them.
+         */
+        template <typename Iterator>
+        bool literal(Iterator &first, Iterator last, const char *s, std::size_t size)
+        {
+            Iterator cur = first;
+            for (std::size_t i = 0; i < size; ++i, ++cur) {
+                if (cur == last || *cur != s[i]) {
+                    return false;
+                }
+            }
+            first = cur;
+            return true;
+        }
+
+        inline bool literal(const char *&first, const char *last, const char *s, std::size_t size)
+        {
+            if (static_cast<std::size_t>(last - first) < size || std::memcmp(first, s, size) != 0) {
+                return false;
+            }
+            first += size;
+            return true;
+        }
+
+        inline bool key_char(char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-';
+        }
+
+        // ascii::space, as skipped by the header rule.
+        inline bool header_space(char c)
+        {
+            return c == ' ' || (c >= '\t' && c <= '\r');
+        }
+
+        /**
+         * Match the Request-Line of a head, checked only as far as being
+         * printable, and its CRLF, moving first past them. On failure first
+         * is left where the line stopped matching.
+         */
+        inline bool request_line(const char *&first, const char *last)
+        {
+            const char *cur = field_value(first, last);
+            bool matched = cur != first && literal(cur, last, "\r\n", 2);
+            first = cur;
+            return matched;
+        }
+
+        /**
+         * Match one header line, header >> crlf as request_parser does,
+         * moving first past it; key and value point into the line. On
+         * failure, eg at the blank line ending the head, first is left where
+         * the line stopped matching.
+         */
+        inline bool header_line(const char *&first, const char *last, boost::string_ref &key, boost::string_ref &value)
+        {
+            const char *cur = first;
+            while (cur != last && key_char(*cur)) {
+                ++cur;
+            }
+            const char *key_end = cur;
+            if (key_end == first || cur == last || *cur != ':') {
+                first = cur;
+                return false;
+            }
+            ++cur;
+            while (cur != last && header_space(*cur)) {
+                ++cur;
+            }
+            const char *value_begin = cur;
+            cur = field_value(cur, last);
+            if (cur == value_begin || !literal(cur, last, "\r\n", 2)) {
+                first = cur;
+                return false;
+            }
+            key = boost::string_ref(first, key_end - first);
+            value = boost::string_ref(value_begin, cur - 2 - value_begin);
+            first = cur;
+            return true;
+        }
+
+        /**
+         * Whether a key as header_line gives it is name, which is in lower
+         * case, ignoring case.
+         */
+        inline bool same_key(boost::string_ref key, const char *name)
+        {
+            if (key.size() != std::strlen(name)) {
+                return false;
+            }
+            for (std::size_t i = 0; i < key.size(); ++i) {
+                // Only letters, digits and '-' are in a key, so folding 0x20
+                // is a case insensitive compare.
+                if ((key[i] | 0x20) != name[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * End of a request method token, up to 20 upper case letters or
+         * digits, starting at first; first itself when there is no token or
+         * it is longer than 20 characters.
+         */
+        template <typename Iterator>
+        Iterator method(Iterator first, Iterator last)
+        {
+            Iterator cur = first;
+            for (std::size_t n = 0; cur != last; ++cur, ++n) {
+                char c = *cur;
+                if (!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))) {
+                    break;
+                }
+                if (n == 20) {
+                    return first;
+                }
+            }
+            return cur;
+        }
+
+        /**
+         * Recognise "HTTP/1.1" and "HTTP/1.0", the only versions seen in
+         * practice, moving first past them. Anything else, including a longer
+         * minor version such as "HTTP/1.10", is left to the general grammar.
+         */
+        template <typename Iterator>
+        bool common_version(Iterator &first, Iterator last, version_t &v)
+        {
+            Iterator cur = first;
+            if (!literal(cur, last, "HTTP/1.", 7) || cur == last || (*cur != '0' && *cur != '1')) {
+                return false;
+            }
+            char minor = *cur++;
+            if (cur != last && *cur >= '0' && *cur <= '9') {
+                return false;
+            }
+            v = version_t(1, minor - '0');
+            first = cur;
+            return true;
+        }
+
+        inline bool common_version(const char *&first, const char *last, version_t &v)
+        {
+            // One eight byte compare; the constants are folded at compile
+            // time whatever the byte order.
+            uint64_t w, http_11, http_10;
+            if (last - first < 8) {
+                return false;
+            }
+            std::memcpy(&w, first, sizeof(w));
+            std::memcpy(&http_11, "HTTP/1.1", sizeof(http_11));
+            std::memcpy(&http_10, "HTTP/1.0", sizeof(http_10));
+            if (w != http_11 && w != http_10) {
+                return false;
+            }
+            if (last - first > 8 && first[8] >= '0' && first[8] <= '9') {
+                return false;
+            }
+            v = version_t(1, first[7] - '0');
+            first += 8;
+            return true;
+        }
+    } // namespace scan
+
+    /**
+     * Wrap one of the parsers below in a proto terminal, so it takes a
+     * semantic action like any Spirit terminal, eg term(method_parser())[f].
+     */
+    template <typename Parser>
+    typename boost::proto::terminal<Parser>::type term(const Parser &p)
+    {
+        typename boost::proto::terminal<Parser>::type t = { p };
+        return t;
+    }
+
+    /**
+     * Parser for a header field value, equivalent to +(print | char_('\t'))
+     * but run by scan::field_value. The attribute is the matched text.
+     */
+    struct field_value_parser : qi::primitive_parser<field_value_parser>
+    {
+        template <typename Context, typename Iterator>
+        struct attribute
+        {
+            typedef std::string type;
+        };
+
+        template <typename Iterator, typename Context, typename Skipper, typename Attribute>
+        bool parse(Iterator &first, Iterator const &last, Context &, Skipper const &skipper, Attribute &attr) const
+        {
+            qi::skip_over(first, last, skipper);
+            Iterator end = scan::field_value(first, last);
+            if (end == first) {
+                return false;
+            }
+            boost::spirit::traits::assign_to(first, end, attr);
+            first = end;
+            return true;
+        }
+
+        template <typename Context>
+        boost::spirit::info what(Context &) const
+        {
+            return boost::spirit::info("field_value");
+        }
+    };
+
+    /**
+     * Parser for a fixed string with no attribute, compared with memcmp over
+     * pointer iterators.
+     */
+    struct literal_parser : qi::primitive_parser<literal_parser>
+    {
+        template <typename Context, typename Iterator>
+        struct attribute
+        {
+            typedef boost::spirit::unused_type type;
+        };
+
+        explicit literal_parser(const char *s) :
+            str(s), size(std::strlen(s))
+        { }
+
+        template <typename Iterator, typename Context, typename Skipper, typename Attribute>
+        bool parse(Iterator &first, Iterator const &last, Context &, Skipper const &skipper, Attribute &) const
+        {
+            qi::skip_over(first, last, skipper);
+            return scan::literal(first, last, str, size);
+        }
+
+        template <typename Context>
+        boost::spirit::info what(Context &) const
+        {
+            return boost::spirit::info("literal", std::string(str, size));
+        }
+
+        const char *str;
+        std::size_t size;
+    };
+
+    /**
+     * Parser for a request method token, equivalent to
+     * repeat(1, 20)[upper | digit]. The attribute is the matched text.
+     */
+    struct method_parser : qi::primitive_parser<method_parser>
+    {
+        template <typename Context, typename Iterator>
+        struct attribute
+        {
+            typedef std::string type;
+        };
+
+        template <typename Iterator, typename Context, typename Skipper, typename Attribute>
+        bool parse(Iterator &first, Iterator const &last, Context &, Skipper const &skipper, Attribute &attr) const
+        {
+            qi::skip_over(first, last, skipper);
+            Iterator end = scan::method(first, last);
+            if (end == first) {
+                return false;
+            }
+            boost::spirit::traits::assign_to(first, end, attr);
+            first = end;
+            return true;
+        }
+
+        template <typename Context>
+        boost::spirit::info what(Context &) const
+        {
+            return boost::spirit::info("method");
+        }
+    };
+
+    /**
+     * Parser for the fast path of HTTP-Version, see scan::common_version.
+     */
+    struct common_version_parser : qi::primitive_parser<common_version_parser>
+    {
+        template <typename Context, typename Iterator>
+        struct attribute
+        {
+            typedef version_t type;
+        };
+
+        template <typename Iterator, typename Context, typename Skipper, typename Attribute>
+        bool parse(Iterator &first, Iterator const &last, Context &, Skipper const &skipper, Attribute &attr) const
+        {
+            qi::skip_over(first, last, skipper);
+            version_t v;
+            if (!scan::common_version(first, last, v)) {
+                return false;
+            }
+            boost::spirit::traits::assign_to(v, attr);
+            return true;
+        }
+
+        template <typename Context>
+        boost::spirit::info what(Context &) const
+        {
+            return boost::spirit::info("common_version");
+        }
+    };
+} // namespace http11
+
+#endif // __http11_scan_h__
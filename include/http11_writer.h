@@ -0,0 +1,74 @@
+#ifndef __http11_writer_h__
+#define __http11_writer_h__
+
+#include "http11_request.h"
+#include "uri_writer.h"
+
+namespace http11
+{
+    using uri::buffer_writer;
+    using uri::iovec_writer;
+
+    /**
+     * Write the request line of req: method, request-target (see
+     * uri::write) and HTTP-Version, ending in CRLF.
+     */
+    template <typename Writer>
+    void write_request_line(Writer &out, const request_t &req)
+    {
+        out.piece(req.method.data(), req.method.size());
+        out.separator(" ", 1);
+        uri::write(out, req.uri);
+        out.separator(" HTTP/", 6);
+        if (req.version == version_t(1, 1)) {
+            out.separator("1.1", 3);
+        }
+        else if (req.version == version_t(1, 0)) {
+            out.separator("1.0", 3);
+        }
+        else {
+            out.number(req.version.major);
+            out.separator(".", 1);
+            out.number(req.version.minor);
+        }
+        out.separator("\r\n", 2);
+    }
+
+    /**
+     * Write the whole head of req: the request line, each header as
+     * "key: value" CRLF, and the blank line ending the head.
+     *
+     * Header keys and values still equal to what was parsed are written
+     * from the input bytes (header_container_t::source), others from
+     * req.headers; either way an iovec_writer copies nothing. Given the
+     * input as its source, an unmodified head comes out as three iovecs:
+     * the method (a copy in req), a space, and one over the rest of the
+     * input. The input must still be there, as for the URI.
+     */
+    template <typename Writer>
+    void write(Writer &out, const request_t &req)
+    {
+        write_request_line(out, req);
+
+        header_container_t::const_iterator cur = req.headers.begin();
+        header_container_t::const_iterator end = req.headers.end();
+        for (; cur != end; ++cur) {
+            const header_container_t::source_t &source = req.headers.source(cur);
+            boost::string_ref key(cur->first);
+            boost::string_ref value(cur->second);
+            if (source.key == key) {
+                key = source.key;
+            }
+            if (source.value == value) {
+                value = source.value;
+            }
+            out.piece(key.data(), key.size());
+            out.separator(": ", 2);
+            out.piece(value.data(), value.size());
+            out.separator("\r\n", 2);
+        }
+        out.separator("\r\n", 2);
+    }
+} // namespace http11
+
+#endif // __http11_writer_h__
@@ -0,0 +1,202 @@
+#ifndef __http11_http_date_h__
+#define __http11_http_date_h__
+
+#include <boost/config/warning_disable.hpp>
+#include <boost/spirit/include/qi.hpp>
+#include <boost/spirit/include/phoenix_core.hpp>
+#include <boost/spirit/include/phoenix_operator.hpp>
+#include <boost/spirit/include/phoenix_function.hpp>
+#include <boost/utility/string_ref.hpp>
+
+#include <cstring>
+#include <ctime>
+
+namespace http11
+{
+    namespace qi = boost::spirit::qi;
+    namespace phoenix = boost::phoenix;
+
+    namespace detail
+    {
+        // Days from 1970-01-01 to the proleptic Gregorian year-month-day.
+        inline long days_from_civil(int year, int month, int day)
+        {
+            year -= month <= 2;
+            long era = (year >= 0 ? year : year - 399) / 400;
+            long yoe = year - era * 400;
+            long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+            long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+            return era * 146097 + doe - 719468;
+        }
+
+        inline int days_in_month(int year, int month)
+        {
+            static const int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+            bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+            return month == 2 && leap ? 29 : days[month - 1];
+        }
+
+        struct make_time_impl
+        {
+            typedef bool result_type;
+
+            bool operator()(std::time_t &out, int year, int month, int day, int hour, int minute, int second) const
+            {
+                if (day < 1 || day > days_in_month(year, month) || hour > 23 || minute > 59 || second > 60) {
+                    return false;
+                }
+                out = static_cast<std::time_t>(days_from_civil(year, month, day)) * 86400
+                    + hour * 3600 + minute * 60 + second;
+                return true;
+            }
+        };
+
+        inline int utc_year(std::time_t t)
+        {
+            std::tm utc;
+            gmtime_r(&t, &utc);
+            return utc.tm_year + 1900;
+        }
+
+        // RFC 7231 section 7.1.1.1: a two digit year more than 50 years in
+        // the future is the most recent past year with those digits.
+        struct rfc850_year_impl
+        {
+            typedef int result_type;
+
+            int operator()(int year, int this_year) const
+            {
+                int full = this_year - this_year % 100 + year;
+                return full > this_year + 50 ? full - 100 : full;
+            }
+        };
+    } // namespace detail
+
+    /**
+     * Parser for an HTTP-date (RFC 7231 section 7.1.1.1) into a time_t:
+     *
+     *     Sun, 06 Nov 1994 08:49:37 GMT    ; IMF-fixdate
+     *     Sunday, 06-Nov-94 08:49:37 GMT   ; obsolete RFC 850 format
+     *     Sun Nov  6 08:49:37 1994         ; ANSI C's asctime() format
+     *
+     * Names are case-sensitive, as the RFC has them. The day of the week
+     * is matched but not checked against the date; the date itself is
+     * (no 31 Nov, 29 Feb only in leap years). A leap second, 60, is taken
+     * as the first second of the next minute.
+     */
+    template <typename Iterator>
+    struct http_date : qi::grammar<Iterator, std::time_t()>
+    {
+        http_date();
+
+        int this_year;  // for RFC 850 two digit years, the current one by default
+
+        qi::symbols<char, int> day_name, day_name_l, month;
+        qi::rule<Iterator, std::time_t(), qi::locals<int, int, int, int, int, int> > imf_fixdate, rfc850_date, asctime_date;
+        qi::rule<Iterator, std::time_t()> start;
+    }; // struct http_date
+
+    template <typename Iterator>
+    http_date<Iterator>::http_date() :
+        http_date::base_type(start)
+    {
+        using qi::lit;
+        using qi::eps;
+        using qi::_val;
+        using qi::_1;
+        using qi::_a;
+        using qi::_b;
+        using qi::_c;
+        using qi::_d;
+        using qi::_e;
+        using qi::_f;
+        using qi::_pass;
+
+        this_year = detail::utc_year(std::time(0));
+
+        phoenix::function<detail::make_time_impl> make_time_;
+        phoenix::function<detail::rfc850_year_impl> rfc850_year_;
+        qi::uint_parser<int, 10, 1, 1> digit1;
+        qi::uint_parser<int, 10, 2, 2> digit2;
+        qi::uint_parser<int, 10, 4, 4> digit4;
+
+        day_name.add("Mon", 1)("Tue", 2)("Wed", 3)("Thu", 4)("Fri", 5)("Sat", 6)("Sun", 7);
+        day_name_l.add("Monday", 1)("Tuesday", 2)("Wednesday", 3)("Thursday", 4)
+                      ("Friday", 5)("Saturday", 6)("Sunday", 7);
+        month.add("Jan", 1)("Feb", 2)("Mar", 3)("Apr", 4)("May", 5)("Jun", 6)
+                 ("Jul", 7)("Aug", 8)("Sep", 9)("Oct", 10)("Nov", 11)("Dec", 12);
+
+        // locals: _a day, _b month, _c year, _d hour, _e minute, _f second
+        imf_fixdate  = day_name >> lit(", ")
+                     >> digit2[_a = _1] >> ' ' >> month[_b = _1] >> ' ' >> digit4[_c = _1] >> ' '
+                     >> digit2[_d = _1] >> ':' >> digit2[_e = _1] >> ':' >> digit2[_f = _1]
+                     >> lit(" GMT")
+                     >> eps[_pass = make_time_(_val, _c, _b, _a, _d, _e, _f)];
+
+        rfc850_date  = day_name_l >> lit(", ")
+                     >> digit2[_a = _1] >> '-' >> month[_b = _1] >> '-' >> digit2[_c = rfc850_year_(_1, phoenix::ref(this_year))] >> ' '
+                     >> digit2[_d = _1] >> ':' >> digit2[_e = _1] >> ':' >> digit2[_f = _1]
+                     >> lit(" GMT")
+                     >> eps[_pass = make_time_(_val, _c, _b, _a, _d, _e, _f)];
+
+        asctime_date = day_name >> ' ' >> month[_b = _1] >> ' ' >> (digit2[_a = _1] | ' ' >> digit1[_a = _1]) >> ' '
+                     >> digit2[_d = _1] >> ':' >> digit2[_e = _1] >> ':' >> digit2[_f = _1] >> ' '
+                     >> digit4[_c = _1]
+                     >> eps[_pass = make_time_(_val, _c, _b, _a, _d, _e, _f)];
+
+        start        = imf_fixdate | rfc850_date | asctime_date;
+
+        imf_fixdate.name("imf_fixdate");
+        rfc850_date.name("rfc850_date");
+        asctime_date.name("asctime_date");
+        start.name("start");
+    }
+
+    /**
+     * Parse an HTTP-date header value, eg If-Modified-Since, ignoring
+     * trailing whitespace. Clients repeat the same timestamp (the
+     * Last-Modified they were sent) request after request, so the last
+     * IMF-fixdate parsed on this thread is remembered, keyed on its exact
+     * 29 bytes, and a repeat costs a memcmp. The current year, which
+     * RFC 850 dates are read against, is kept up to date across a new
+     * year.
+     */
+    inline bool parse_http_date(boost::string_ref value, std::time_t &out)
+    {
+        enum { imf_fixdate_size = 29 };
+        static thread_local char cached[imf_fixdate_size];
+        static thread_local std::time_t cached_time = -1;
+
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+            value.remove_suffix(1);
+        }
+        bool fixed = value.size() == imf_fixdate_size;
+        if (fixed && cached_time != -1 && std::memcmp(value.data(), cached, imf_fixdate_size) == 0) {
+            out = cached_time;
+            return true;
+        }
+
+        static thread_local http_date<const char *> grammar;
+        static thread_local std::time_t next_year = 0;
+        std::time_t now = std::time(0);
+        if (now >= next_year) {
+            grammar.this_year = detail::utc_year(now);
+            next_year = static_cast<std::time_t>(detail::days_from_civil(grammar.this_year + 1, 1, 1)) * 86400;
+        }
+
+        const char *first = value.data();
+        const char *last = first + value.size();
+        std::time_t parsed;
+        if (!qi::parse(first, last, grammar, parsed) || first != last) {
+            return false;
+        }
+        if (fixed) {
+            std::memcpy(cached, value.data(), imf_fixdate_size);
+            cached_time = parsed;
+        }
+        out = parsed;
+        return true;
+    }
+} // namespace http11
+
+#endif // __http11_http_date_h__
@@ -22,42 +22,55 @@ namespace uri
     template <typename Iterator>
     struct ipv4_address : qi::grammar<Iterator, std::string()>
     {
-        ipv4_address() : 
-            ipv4_address::base_type(start)
-        {
-            using qi::char_;
-            using qi::raw;
-            using ascii::digit;
-            using ascii::string;
+        ipv4_address();
 
-            qi::on_error<qi::fail>
-            (
-                start,
-                std::cerr << phoenix::val("Error! Expecting")
-                          << qi::_4
-                          << phoenix::val(" here: \"")
-                          << phoenix::construct<std::string>(qi::_3, qi::_2)
-                          << phoenix::val("\"")
-                          << std::endl
-            );
+        qi::rule<Iterator> dec_octet;
+        qi::rule<Iterator> ipv4_attr;  // the address without its text, for use under raw[]
+        qi::rule<Iterator, std::string()> start;
+    }; // struct ipv4_address
 
-            dec_octet = string("25") >> char_("012345")
-                      | char_('2')  >> char_("01234") >> digit
-                      | char_("01") >> digit >> digit
-                      | digit >> digit
-                      | digit
-                      ;
+    template <typename Iterator>
+    ipv4_address<Iterator>::ipv4_address() :
+        ipv4_address::base_type(start)
+    {
+        using qi::char_;
+        using qi::raw;
+        using ascii::digit;
+        using ascii::string;
 
-            start     = raw[(dec_octet >> qi::repeat(3)[char_('.') >> dec_octet])] >> !digit
-                      ;
+        qi::on_error<qi::fail>
+        (
+            start,
+            std::cerr << phoenix::val("Error! Expecting")
+                      << qi::_4
+                      << phoenix::val(" here: \"")
+                      << phoenix::construct<std::string>(qi::_3, qi::_2)
+                      << phoenix::val("\"")
+                      << std::endl
+        );
 
-            dec_octet.name("dec_octet");
-            start.name("start");
-        }
+        dec_octet = string("25") >> char_("012345")
+                  | char_('2')  >> char_("01234") >> digit
+                  | char_("01") >> digit >> digit
+                  | digit >> digit
+                  | digit
+                  ;
 
-        qi::rule<Iterator> dec_octet;
-        qi::rule<Iterator, std::string()> start;
-    }; // struct ipv4_address
+        ipv4_attr = dec_octet >> qi::repeat(3)[char_('.') >> dec_octet];
+
+        start     = raw[ipv4_attr >> !digit]
+                  ;
+
+        dec_octet.name("dec_octet");
+        ipv4_attr.name("ipv4_attr");
+        start.name("start");
+    }
+
+#ifdef SPIRIT_PARSERS_EXTERN_TEMPLATES
+    // Instantiated once in the spirit_parsers library, see src/ipv4_address.cpp.
+    extern template struct ipv4_address<const char *>;
+    extern template struct ipv4_address<std::string::const_iterator>;
+#endif
 } // namespace uri
 
 #endif // __ipv4_address_h__
@@ -0,0 +1,248 @@
+#ifndef __ipv4_scan_h__
+#define __ipv4_scan_h__
+
+#include <boost/utility/string_ref.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define IPV4_SCAN_SSSE3 1
+#include <immintrin.h>
+#endif
+
+namespace uri
+{
+    /**
+     * Bulk IPv4 address parsing, for logs and X-Forwarded-For lists where
+     * the grammar's per-address cost adds up.
+     *
+     * Everything here accepts exactly what ipv4_address accepts: four
+     * dec-octets separated by '.', each octet a run of one to three digits
+     * worth at most 255, leading zeros allowed ("001.02.3.4"). That is what
+     * the dec_octet alternation and the trailing !digit come down to: an
+     * octet the alternation cuts short (the "25" of "256") is always
+     * followed by a digit, which neither '.' nor !digit let through.
+     *
+     * Addresses come out as uint32_t in host order, the first octet in the
+     * top byte (inet_pton gives network order; htonl converts).
+     */
+    namespace scan
+    {
+        /**
+         * Match ipv4_address at first, with its prefix semantics: first is
+         * moved past the address, which must not be followed by a digit.
+         */
+        template <typename Iterator>
+        bool ipv4(Iterator &first, Iterator last, uint32_t &addr)
+        {
+            Iterator cur = first;
+            uint32_t value = 0;
+            for (int octet = 0; octet < 4; ++octet) {
+                if (octet && (cur == last || *cur++ != '.')) {
+                    return false;
+                }
+                unsigned n = 0;
+                unsigned digits = 0;
+                for (; cur != last && *cur >= '0' && *cur <= '9'; ++cur) {
+                    if (++digits > 3) {
+                        return false;
+                    }
+                    n = n * 10 + (*cur - '0');
+                }
+                if (digits == 0 || n > 255) {
+                    return false;
+                }
+                value = value << 8 | n;
+            }
+            first = cur;
+            addr = value;
+            return true;
+        }
+
+        namespace detail
+        {
+            inline bool ipv4_scalar(const char *first, const char *last, uint32_t &addr)
+            {
+                return ipv4(first, last, addr) && first == last;
+            }
+
+#ifdef IPV4_SCAN_SSSE3
+            /**
+             * pshufb controls moving the digits of each octet, right aligned,
+             * into bytes 4k..4k+2 of lane group k, for every combination of
+             * octet lengths (1 to 3 each, the index being base 3).
+             */
+            struct ipv4_shuffles
+            {
+                signed char c[81][16];
+
+                constexpr ipv4_shuffles() : c()
+                {
+                    for (int i = 0; i < 81; ++i) {
+                        int start = 0;
+                        for (int k = 0; k < 4; ++k) {
+                            int length = (i / (k == 0 ? 27 : k == 1 ? 9 : k == 2 ? 3 : 1)) % 3 + 1;
+                            for (int j = 0; j < 4; ++j) {
+                                int digit = j - (3 - length);
+                                c[i][4 * k + j] = static_cast<signed char>(j < 3 && digit >= 0 ? start + digit : -128);
+                            }
+                            start += length + 1;
+                        }
+                    }
+                }
+            };
+
+            /**
+             * Whole span parse of 7 to 15 bytes already in a register, lanes
+             * from size on ignored: classify all lanes at once, find the dots
+             * in the resulting bit masks, then shuffle the digits into place
+             * and weigh them with two multiply-adds.
+             */
+            __attribute__((target("ssse3")))
+            inline bool ipv4_ssse3(__m128i v, unsigned size, uint32_t &addr)
+            {
+                static constexpr ipv4_shuffles shuffles;
+
+                const unsigned span = (1u << size) - 1;
+                __m128i d = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+                __m128i digit = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+                __m128i dot = _mm_cmpeq_epi8(v, _mm_set1_epi8('.'));
+                unsigned digits = _mm_movemask_epi8(digit) & span;
+                unsigned dots = _mm_movemask_epi8(dot) & span;
+                if ((digits | dots) != span || __builtin_popcount(dots) != 3) {
+                    return false;
+                }
+
+                unsigned p0 = __builtin_ctz(dots);
+                dots &= dots - 1;
+                unsigned p1 = __builtin_ctz(dots);
+                dots &= dots - 1;
+                unsigned p2 = __builtin_ctz(dots);
+                unsigned l0 = p0, l1 = p1 - p0 - 1, l2 = p2 - p1 - 1, l3 = size - p2 - 1;
+                // An empty octet wraps round to a large length.
+                if (l0 - 1 > 2 || l1 - 1 > 2 || l2 - 1 > 2 || l3 - 1 > 2) {
+                    return false;
+                }
+
+                unsigned pattern = (l0 - 1) * 27 + (l1 - 1) * 9 + (l2 - 1) * 3 + (l3 - 1);
+                __m128i control = _mm_loadu_si128(reinterpret_cast<const __m128i *>(shuffles.c[pattern]));
+                __m128i placed = _mm_shuffle_epi8(d, control);
+                __m128i pairs = _mm_maddubs_epi16(placed, _mm_setr_epi8(100, 10, 1, 0, 100, 10, 1, 0,
+                                                                        100, 10, 1, 0, 100, 10, 1, 0));
+                __m128i octets = _mm_madd_epi16(pairs, _mm_set1_epi16(1));
+                if (_mm_movemask_epi8(_mm_cmpgt_epi32(octets, _mm_set1_epi32(255)))) {
+                    return false;
+                }
+
+                __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(octets, octets), octets);
+                addr = __builtin_bswap32(static_cast<uint32_t>(_mm_cvtsi128_si32(bytes)));
+                return true;
+            }
+
+            inline bool has_ssse3()
+            {
+                static const bool supported = __builtin_cpu_supports("ssse3");
+                return supported;
+            }
+#endif
+        } // namespace detail
+    } // namespace scan
+
+    /**
+     * Parse exactly [first, last) as an IPv4 address, the equivalent of
+     * qi::parse with ipv4_address and first == last afterwards.
+     */
+    inline bool parse_ipv4(const char *first, const char *last, uint32_t &addr)
+    {
+        std::size_t size = last - first;
+        if (size < 7 || size > 15) {
+            return false;
+        }
+#ifdef IPV4_SCAN_SSSE3
+        if (scan::detail::has_ssse3()) {
+            char lanes[16] = { };
+            std::memcpy(lanes, first, size);
+            return scan::detail::ipv4_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lanes)),
+                                            static_cast<unsigned>(size), addr);
+        }
+#endif
+        return scan::detail::ipv4_scalar(first, last, addr);
+    }
+
+    /**
+     * Parse count spans, each as a whole address. addrs[i] is set for each
+     * valid span (and left alone otherwise); valid is a bit set of
+     * (count + 63) / 64 words, bit i % 64 of word i / 64 telling whether
+     * spans[i] was an address. Returns the number of addresses.
+     */
+    inline std::size_t parse_ipv4(const boost::string_ref *spans, std::size_t count, uint32_t *addrs, uint64_t *valid)
+    {
+        std::size_t found = 0;
+        for (std::size_t word = 0; word * 64 < count; ++word) {
+            uint64_t bits = 0;
+            std::size_t end = count - word * 64 < 64 ? count - word * 64 : 64;
+            for (std::size_t i = 0; i < end; ++i) {
+                const boost::string_ref &span = spans[word * 64 + i];
+                bool ok = parse_ipv4(span.data(), span.data() + span.size(), addrs[word * 64 + i]);
+                bits |= static_cast<uint64_t>(ok) << i;
+            }
+            valid[word] = bits;
+            found += __builtin_popcountll(bits);
+        }
+        return found;
+    }
+
+    /**
+     * Parse a buffer of addresses separated by delimiter (eg '\n'), each
+     * field taken as a whole address, as for the spans above. At most max
+     * fields are read; first is left at the start of the next field, or at
+     * last. A delimiter just before last does not start another field.
+     * Returns the number of fields read.
+     *
+     * Fields with 16 bytes of the buffer ahead of them are loaded straight
+     * from it, with no copy.
+     */
+    inline std::size_t parse_ipv4(const char *&first, const char *last, char delimiter,
+                                  uint32_t *addrs, uint64_t *valid, std::size_t max)
+    {
+        std::size_t fields = 0;
+        uint64_t bits = 0;
+#ifdef IPV4_SCAN_SSSE3
+        const bool simd = scan::detail::has_ssse3();
+#endif
+        while (first != last && fields < max) {
+            const char *end = static_cast<const char *>(std::memchr(first, delimiter, last - first));
+            if (!end) {
+                end = last;
+            }
+
+            bool ok;
+            std::size_t size = end - first;
+#ifdef IPV4_SCAN_SSSE3
+            if (simd && size >= 7 && size <= 15 && last - first >= 16) {
+                ok = scan::detail::ipv4_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i *>(first)),
+                                              static_cast<unsigned>(size), addrs[fields]);
+            }
+            else
+#endif
+            {
+                ok = parse_ipv4(first, end, addrs[fields]);
+            }
+            bits |= static_cast<uint64_t>(ok) << (fields % 64);
+            if (++fields % 64 == 0) {
+                valid[fields / 64 - 1] = bits;
+                bits = 0;
+            }
+
+            first = end == last ? last : end + 1;
+        }
+        if (fields % 64) {
+            valid[fields / 64] = bits;
+        }
+        return fields;
+    }
+} // namespace uri
+
+#endif // __ipv4_scan_h__
@@ -24,52 +24,61 @@ namespace uri
     template <typename Iterator>
     struct ipv6_address : qi::grammar<Iterator, std::string()>
     {
-        ipv6_address() : 
-            ipv6_address::base_type(start)
-        {
-            using qi::repeat;
-            using qi::raw;
-            using ascii::xdigit;
-
-            qi::on_error<qi::fail>
-            (
-                start,
-                std::cerr << phoenix::val("Error! Expecting")
-                          << qi::_4
-                          << phoenix::val(" here: \"")
-                          << phoenix::construct<std::string>(qi::_3, qi::_2)
-                          << phoenix::val("\"")
-                          << std::endl
-            );
-
-
-            h16          = repeat(1,4)[xdigit];    
-            ls32         = h16 >> ':' >> h16 | ipv4 ;
-
-            ipv6_attr    =                                                repeat(6)[h16 >> ':'] >> ls32
-                         |                                        "::" >> repeat(5)[h16 >> ':'] >> ls32
-                         | - h16                               >> "::" >> repeat(4)[h16 >> ':'] >> ls32
-                         | -(h16 >> -(           ':' >> h16) ) >> "::" >> repeat(3)[h16 >> ':'] >> ls32
-                         | -(h16 >> -repeat(1,2)[':' >> h16] ) >> "::" >> repeat(2)[h16 >> ':'] >> ls32
-                         | -(h16 >> -repeat(1,3)[':' >> h16] ) >> "::" >>           h16 >> ':'  >> ls32
-                         | -(h16 >> -repeat(1,4)[':' >> h16] ) >> "::"                          >> ls32
-                         | -(h16 >> -repeat(1,5)[':' >> h16] ) >> "::" >>           h16
-                         | -(h16 >> -repeat(1,6)[':' >> h16] ) >> "::"
-                         ;
-
-            start        = raw[ipv6_attr];
-
-            h16.name("h16");
-            ls32.name("ls32");
-            ipv6_attr.name("ipv6_attr");
-            start.name("start");
-        }
+        ipv6_address();
 
         ipv4_address<Iterator> ipv4;
         qi::rule<Iterator> h16, ls32;
         qi::rule<Iterator, std::string()> ipv6_attr;
         qi::rule<Iterator, std::string()> start;
     };
+
+    template <typename Iterator>
+    ipv6_address<Iterator>::ipv6_address() :
+        ipv6_address::base_type(start)
+    {
+        using qi::repeat;
+        using qi::raw;
+        using ascii::xdigit;
+
+        qi::on_error<qi::fail>
+        (
+            start,
+            std::cerr << phoenix::val("Error! Expecting")
+                      << qi::_4
+                      << phoenix::val(" here: \"")
+                      << phoenix::construct<std::string>(qi::_3, qi::_2)
+                      << phoenix::val("\"")
+                      << std::endl
+        );
+
+
+        h16          = repeat(1,4)[xdigit];    
+        ls32         = h16 >> ':' >> h16 | ipv4 ;
+
+        ipv6_attr    =                                                repeat(6)[h16 >> ':'] >> ls32
+                     |                                        "::" >> repeat(5)[h16 >> ':'] >> ls32
+                     | - h16                               >> "::" >> repeat(4)[h16 >> ':'] >> ls32
+                     | -(h16 >> -(           ':' >> h16) ) >> "::" >> repeat(3)[h16 >> ':'] >> ls32
+                     | -(h16 >> -repeat(1,2)[':' >> h16] ) >> "::" >> repeat(2)[h16 >> ':'] >> ls32
+                     | -(h16 >> -repeat(1,3)[':' >> h16] ) >> "::" >>           h16 >> ':'  >> ls32
+                     | -(h16 >> -repeat(1,4)[':' >> h16] ) >> "::"                          >> ls32
+                     | -(h16 >> -repeat(1,5)[':' >> h16] ) >> "::" >>           h16
+                     | -(h16 >> -repeat(1,6)[':' >> h16] ) >> "::"
+                     ;
+
+        start        = raw[ipv6_attr];
+
+        h16.name("h16");
+        ls32.name("ls32");
+        ipv6_attr.name("ipv6_attr");
+        start.name("start");
+    }
+
+#ifdef SPIRIT_PARSERS_EXTERN_TEMPLATES
+    // Instantiated once in the spirit_parsers library, see src/ipv6_address.cpp.
+    extern template struct ipv6_address<const char *>;
+    extern template struct ipv6_address<std::string::const_iterator>;
+#endif
 } // namespace uri
 
 #endif // __ipv6_parser_h__
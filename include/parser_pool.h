@@ -0,0 +1,243 @@
+#ifndef __parser_pool_h__
+#define __parser_pool_h__
+
+#include "http11_parser.h"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace uri
+{
+    /**
+     * Empty a result before a pooled grammar parses into it; found by
+     * argument dependent lookup, so other result types provide their own.
+     */
+    inline void reset_result(uri_t &uri)
+    {
+        uri.clear();
+    }
+
+    /**
+     * Pool of ready built grammars for multithreaded servers.
+     *
+     * A grammar is expensive to build and writes through the Result it was
+     * built with, so it cannot be shared between threads. The pool keeps
+     * (Result, Grammar) pairs; a thread checks one out for as long as it
+     * likes (one request, or the life of a worker) and the lease hands it
+     * back on destruction. Free pairs are kept on one tagged free list per
+     * CPU, each on its own cache line: a checkout takes from the list of
+     * the CPU it runs on and a return gives back to it, a single compare
+     * and swap on a line no other core is using, so in the steady state
+     * workers never contend and throughput scales with the cores. Only
+     * when its own list is empty does a checkout take from another CPU's
+     * list, and a new pair is only built when every existing one is
+     * checked out, so the pool settles at the peak number of concurrent
+     * users, eg one per worker thread or core.
+     *
+     * The grammars share no mutable state: each owns its rules and tables,
+     * and the only statics in the library are per-thread.
+     *
+     * Example:
+     *     static http11::request_pool pool;
+     *     http11::request_pool::lease parser = pool.checkout();
+     *     if (parser.parse(first, last)) { use(parser.result()); }
+     */
+    template <typename Result, typename Grammar>
+    class parser_pool
+    {
+        // Cache line sized and aligned, so leases held by different cores
+        // never share a line.
+        struct alignas(64) slot_t
+        {
+            Result result;
+            Grammar grammar;
+            std::atomic<uint32_t> next;  // free list link, index + 1
+
+            slot_t() : grammar(result), next(0) { }
+        };
+
+    public:
+        enum { max_slots = 1024, shard_count = 64 };
+
+        class lease
+        {
+        public:
+            lease(lease &&rhs) noexcept : pool_(rhs.pool_), index_(rhs.index_) { rhs.pool_ = 0; }
+
+            ~lease()
+            {
+                if (pool_) {
+                    pool_->release(index_);
+                }
+            }
+
+            lease(const lease &) = delete;
+            lease &operator=(const lease &) = delete;
+
+            Result &result() { return pool_->slots_[index_].load(std::memory_order_relaxed)->result; }
+            Grammar &grammar() { return pool_->slots_[index_].load(std::memory_order_relaxed)->grammar; }
+
+            /**
+             * Reset result() and parse a prefix of [first, last) into it.
+             */
+            template <typename Iterator>
+            bool parse(Iterator &first, Iterator last)
+            {
+                reset_result(result());
+                return boost::spirit::qi::parse(first, last, grammar());
+            }
+
+        private:
+            friend class parser_pool;
+
+            lease(parser_pool *pool, uint32_t index) : pool_(pool), index_(index) { }
+
+            parser_pool *pool_;
+            uint32_t index_;
+        };
+
+        /**
+         * Build prealloc pairs up front so checkouts never build one.
+         */
+        explicit parser_pool(std::size_t prealloc = 0) :
+            count_(0)
+        {
+            for (std::size_t i = 0; i < shard_count; ++i) {
+                shards_[i].head.store(0, std::memory_order_relaxed);
+            }
+            for (std::size_t i = 0; i < max_slots; ++i) {
+                slots_[i].store(0, std::memory_order_relaxed);
+            }
+            for (std::size_t i = 0; i < prealloc && i < max_slots; ++i) {
+                push(shards_[i % shard_count], grow());
+            }
+        }
+
+        ~parser_pool()
+        {
+            uint32_t n = count_.load(std::memory_order_acquire);
+            for (uint32_t i = 0; i < n && i < max_slots; ++i) {
+                delete slots_[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        parser_pool(const parser_pool &) = delete;
+        parser_pool &operator=(const parser_pool &) = delete;
+
+        lease checkout()
+        {
+            std::size_t home = current_shard();
+            for (std::size_t i = 0; i < shard_count; ++i) {
+                uint32_t index;
+                if (pop(shards_[(home + i) % shard_count], index)) {
+                    return lease(this, index);
+                }
+            }
+            return lease(this, grow());
+        }
+
+        /**
+         * Number of pairs built so far.
+         */
+        std::size_t size() const
+        {
+            return count_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        // Build a new pair; throws std::length_error past max_slots.
+        uint32_t grow()
+        {
+            uint32_t index = count_.fetch_add(1, std::memory_order_relaxed);
+            if (index >= max_slots) {
+                count_.fetch_sub(1, std::memory_order_relaxed);
+                throw std::length_error("parser_pool: too many concurrent leases");
+            }
+            slots_[index].store(new slot_t, std::memory_order_release);
+            return index;
+        }
+
+        void release(uint32_t index)
+        {
+            push(shards_[current_shard()], index);
+        }
+
+        // A free list; (tag << 32) | (index of the first free slot + 1),
+        // 0 when empty.
+        struct alignas(64) shard_t
+        {
+            std::atomic<uint64_t> head;
+        };
+
+        bool pop(shard_t &shard, uint32_t &index)
+        {
+            uint64_t head = shard.head.load(std::memory_order_acquire);
+            for (;;) {
+                uint32_t top = static_cast<uint32_t>(head);
+                if (top == 0) {
+                    return false;
+                }
+                slot_t *slot = slots_[top - 1].load(std::memory_order_acquire);
+                uint64_t next = ((head >> 32) + 1) << 32 | slot->next.load(std::memory_order_relaxed);
+                if (shard.head.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) {
+                    index = top - 1;
+                    return true;
+                }
+            }
+        }
+
+        void push(shard_t &shard, uint32_t index)
+        {
+            slot_t *slot = slots_[index].load(std::memory_order_relaxed);
+            uint64_t head = shard.head.load(std::memory_order_relaxed);
+            uint64_t next;
+            do {
+                slot->next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+                // The tag in the upper half changes on every update, so a
+                // pop that read a stale top cannot succeed (ABA), even when
+                // the slot has moved to another list since.
+                next = ((head >> 32) + 1) << 32 | (index + 1);
+            } while (!shard.head.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        // The free list of the CPU the caller runs on; without
+        // sched_getcpu, threads are spread over the lists by first use.
+        static std::size_t current_shard()
+        {
+#if defined(__linux__)
+            int cpu = sched_getcpu();
+            if (cpu >= 0) {
+                return static_cast<std::size_t>(cpu) % shard_count;
+            }
+#endif
+            static std::atomic<std::size_t> threads(0);
+            static thread_local std::size_t shard = threads.fetch_add(1, std::memory_order_relaxed) % shard_count;
+            return shard;
+        }
+
+        shard_t shards_[shard_count];
+        alignas(64) std::atomic<uint32_t> count_;
+        std::atomic<slot_t *> slots_[max_slots];
+    };
+
+    typedef parser_pool<uri_t, uri_parser<const char *> > uri_pool;
+} // namespace uri
+
+namespace http11
+{
+    inline void reset_result(request_t &req)
+    {
+        req.clear();
+    }
+
+    typedef uri::parser_pool<request_t, request_parser<const char *> > request_pool;
+} // namespace http11
+
+#endif // __parser_pool_h__
@@ -0,0 +1,109 @@
+#ifndef __uri_percent_decode_h__
+#define __uri_percent_decode_h__
+
+#include <boost/utility/string_ref.hpp>
+
+#include <cstring>
+#include <string>
+
+namespace uri
+{
+    /**
+     * Value of a single hex digit, or -1 if c is not one.
+     */
+    inline int hex_value(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    /**
+     * True if [first, last) contains anything percent_decode would change.
+     */
+    inline bool needs_decoding(const char *first, const char *last, bool plus_as_space = false)
+    {
+        std::size_t n = last - first;
+        return std::memchr(first, '%', n) != 0
+            || (plus_as_space && std::memchr(first, '+', n) != 0);
+    }
+
+    /**
+     * Decode the percent encoded bytes in [first, last), appending the result
+     * to out. A '+' becomes a space when plus_as_space is set (the
+     * application/x-www-form-urlencoded convention). Malformed escapes are
+     * copied through unchanged rather than rejected; validation is the
+     * grammar's job.
+     */
+    inline void percent_decode(const char *first, const char *last, std::string &out, bool plus_as_space = false)
+    {
+        while (first != last) {
+            const char *pct = static_cast<const char *>(std::memchr(first, '%', last - first));
+            const char *run_end = pct ? pct : last;
+
+            if (plus_as_space) {
+                for (; first != run_end; ++first) {
+                    out += (*first == '+') ? ' ' : *first;
+                }
+            }
+            else {
+                out.append(first, run_end);
+                first = run_end;
+            }
+
+            if (!pct) {
+                break;
+            }
+
+            int hi, lo;
+            if (last - pct >= 3 && (hi = hex_value(pct[1])) >= 0 && (lo = hex_value(pct[2])) >= 0) {
+                out += static_cast<char>(hi * 16 + lo);
+                first = pct + 3;
+            }
+            else {
+                out += '%';
+                first = pct + 1;
+            }
+        }
+    }
+
+    /**
+     * Compare the decoded form of raw against plain without materialising
+     * the decoded string.
+     */
+    inline bool decoded_equals(boost::string_ref raw, boost::string_ref plain, bool plus_as_space = false)
+    {
+        const char *cur = raw.data();
+        const char *end = raw.data() + raw.size();
+        const char *want = plain.data();
+        const char *want_end = plain.data() + plain.size();
+
+        for (; cur != end; ++want) {
+            if (want == want_end) {
+                return false;
+            }
+
+            char c = *cur;
+            int hi, lo;
+            if (c == '%' && end - cur >= 3 && (hi = hex_value(cur[1])) >= 0 && (lo = hex_value(cur[2])) >= 0) {
+                c = static_cast<char>(hi * 16 + lo);
+                cur += 3;
+            }
+            else {
+                if (plus_as_space && c == '+') {
+                    c = ' ';
+                }
+                ++cur;
+            }
+
+            if (c != *want) {
+                return false;
+            }
+        }
+
+        return want == want_end;
+    }
+} // namespace uri
+
+#endif // __uri_percent_decode_h__
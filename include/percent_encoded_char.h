@@ -15,7 +15,9 @@ namespace uri
     namespace ascii = boost::spirit::ascii;
     namespace phoenix = boost::phoenix;
 
-    // Symbol table for individual 4 bit hex characters.
+    // Symbol table for individual 4 bit hex characters. Each grammar owns its
+    // own table, so the header defines no objects and can be included from
+    // several translation units.
     struct hex_digit_ : qi::symbols<char, char>
     {
         hex_digit_()
@@ -31,7 +33,7 @@ namespace uri
                 ("F", 0xf) ("f", 0xf)
             ;
         }
-    } hex_digit;
+    };
 
     /**
      * Implementation of the percent encoded character grammar.
@@ -46,19 +48,29 @@ namespace uri
     template <typename Iterator>
     struct percent_encoded_char : qi::grammar<Iterator, char()>
     {
-        percent_encoded_char() :
-            percent_encoded_char::base_type(start)
-        {
-            start = qi::eps[qi::_val = 0] >> 
-                    (
-                      qi::omit['%'] >> 
-                      hex_digit[qi::_val =  qi::_1 * 16] >> 
-                      hex_digit[qi::_val += qi::_1]
-                    );
-        }
+        percent_encoded_char();
 
+        hex_digit_ hex_digit;
         qi::rule<Iterator, char()> start;
     };
+
+    template <typename Iterator>
+    percent_encoded_char<Iterator>::percent_encoded_char() :
+        percent_encoded_char::base_type(start)
+    {
+        start = qi::eps[qi::_val = 0] >> 
+                (
+                  qi::omit['%'] >> 
+                  hex_digit[qi::_val =  qi::_1 * 16] >> 
+                  hex_digit[qi::_val += qi::_1]
+                );
+    }
+
+#ifdef SPIRIT_PARSERS_EXTERN_TEMPLATES
+    // Instantiated once in the spirit_parsers library, see src/percent_encoded_char.cpp.
+    extern template struct percent_encoded_char<const char *>;
+    extern template struct percent_encoded_char<std::string::const_iterator>;
+#endif
 } // namespace uri
 
 #endif // __uri_percent_encoded_char_h__
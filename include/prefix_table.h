@@ -0,0 +1,318 @@
+#ifndef __prefix_table_h__
+#define __prefix_table_h__
+
+#include "cidr.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+namespace uri
+{
+    namespace detail
+    {
+        /**
+         * Longest prefix match over Width bit keys, laid out as a Poptrie
+         * (Asai and Ohara, SIGCOMM 2015): a direct table indexed by the top
+         * 18 bits, then 64-way nodes, 6 bits a level. A node keeps one bit
+         * per child saying whether it is another node, and one bit per run
+         * of equal leaves; a child is found by counting the bits below it,
+         * so a node is 24 bytes and a lookup is a few dependent loads.
+         *
+         * Prefixes go into a plain binary trie with add(); build() compiles
+         * it into the lookup layout in one pass, which is the bulk load.
+         */
+        template <typename Key, unsigned Width>
+        class poptrie
+        {
+        public:
+            enum
+            {
+                direct_bits = 18,
+                stride = 6
+            };
+
+            static constexpr uint32_t no_value = 0xffffffff;
+
+            poptrie() : trie_(1), prefixes_(0)
+            {
+                build();
+            }
+
+            // Later values for the same prefix replace earlier ones.
+            void add(Key key, unsigned length, uint32_t value)
+            {
+                std::size_t node = 0;
+                for (unsigned depth = 0; depth < length; ++depth) {
+                    unsigned bit = bits(key, depth, 1);
+                    if (trie_[node].child[bit] == 0) {
+                        trie_[node].child[bit] = static_cast<uint32_t>(trie_.size());
+                        trie_.push_back(trie_node_t());
+                    }
+                    node = trie_[node].child[bit];
+                }
+                if (trie_[node].value == no_value) {
+                    ++prefixes_;
+                }
+                trie_[node].value = value;
+            }
+
+            void build()
+            {
+                nodes_.clear();
+                leaves_.clear();
+                direct_.assign(std::size_t(1) << direct_bits, 0);
+
+                std::vector<entry_t> entries(std::size_t(1) << direct_bits);
+                expand(0, trie_[0].value, direct_bits, entries.data());
+
+                uint32_t previous = 0;
+                for (std::size_t i = 0; i < entries.size(); ++i) {
+                    if (entries[i].node) {
+                        nodes_.push_back(node_t());
+                        direct_[i] = node_flag | static_cast<uint32_t>(nodes_.size() - 1);
+                        continue;
+                    }
+                    if (leaves_.empty() || leaves_[previous] != entries[i].value) {
+                        leaves_.push_back(entries[i].value);
+                        previous = static_cast<uint32_t>(leaves_.size() - 1);
+                    }
+                    direct_[i] = previous;
+                }
+
+                // Node indexes are only final once the direct table has
+                // all of its own, so compile the children afterwards.
+                for (std::size_t i = 0, n = 0; i < entries.size(); ++i) {
+                    if (entries[i].node) {
+                        compile(n++, entries[i]);
+                    }
+                }
+            }
+
+            void clear()
+            {
+                trie_.assign(1, trie_node_t());
+                prefixes_ = 0;
+                build();
+            }
+
+            std::size_t size() const { return prefixes_; }
+
+            uint32_t match(Key key) const
+            {
+                uint32_t e = direct_[bits(key, 0, direct_bits)];
+                if (!(e & node_flag)) {
+                    return leaves_[e];
+                }
+                const node_t *n = &nodes_[e & ~node_flag];
+                for (unsigned offset = direct_bits;; offset += stride) {
+                    unsigned v = bits(key, offset, stride);
+                    uint64_t below = (uint64_t(2) << v) - 1;
+                    if (n->vector >> v & 1) {
+                        n = &nodes_[n->base0 + __builtin_popcountll(n->vector & below) - 1];
+                    }
+                    else {
+                        return leaves_[n->base1 + __builtin_popcountll(n->leafvec & below) - 1];
+                    }
+                }
+            }
+
+            std::size_t bytes() const
+            {
+                return direct_.size() * sizeof(uint32_t) + nodes_.size() * sizeof(node_t)
+                     + leaves_.size() * sizeof(uint32_t);
+            }
+
+        private:
+            static constexpr uint32_t node_flag = 0x80000000;
+
+            struct trie_node_t
+            {
+                uint32_t child[2];  // 0 when absent, the root being nobody's child
+                uint32_t value;
+
+                trie_node_t() : value(no_value) { child[0] = child[1] = 0; }
+            };
+
+            struct node_t
+            {
+                uint64_t vector;   // which children are nodes
+                uint64_t leafvec;  // which leaf children start a run of equal leaves
+                uint32_t base0;    // first child node
+                uint32_t base1;    // first leaf
+            };
+
+            // One expanded child while compiling: a leaf value, or a trie
+            // node to compile into a node, with the value it inherits.
+            struct entry_t
+            {
+                bool node;
+                uint32_t trie;
+                uint32_t value;
+            };
+
+            // count bits of key from offset (0 being the top bit); bits past
+            // the key read as zero.
+            static unsigned bits(Key key, unsigned offset, unsigned count)
+            {
+                return static_cast<unsigned>(static_cast<Key>(key << offset) >> (Width - count));
+            }
+
+            bool has_children(uint32_t trie) const
+            {
+                return trie_[trie].child[0] || trie_[trie].child[1];
+            }
+
+            // The 2^count children of trie node at, which holds or inherits
+            // value.
+            void expand(uint32_t at, uint32_t value, unsigned count, entry_t *out) const
+            {
+                if (count == 0) {
+                    out->node = has_children(at);
+                    out->trie = at;
+                    out->value = value;
+                    return;
+                }
+                std::size_t half = std::size_t(1) << (count - 1);
+                for (unsigned bit = 0; bit < 2; ++bit) {
+                    uint32_t child = trie_[at].child[bit];
+                    entry_t *half_out = out + bit * half;
+                    if (child == 0) {
+                        for (std::size_t i = 0; i < half; ++i) {
+                            half_out[i].node = false;
+                            half_out[i].value = value;
+                        }
+                    }
+                    else {
+                        uint32_t inherited = trie_[child].value != no_value ? trie_[child].value : value;
+                        expand(child, inherited, count - 1, half_out);
+                    }
+                }
+            }
+
+            void compile(std::size_t index, const entry_t &entry)
+            {
+                entry_t entries[1 << stride];
+                expand(entry.trie, entry.value, stride, entries);
+
+                uint64_t vector = 0;
+                uint64_t leafvec = 0;
+                uint32_t base0 = static_cast<uint32_t>(nodes_.size());
+                uint32_t base1 = static_cast<uint32_t>(leaves_.size());
+                bool first_leaf = true;
+                for (unsigned i = 0; i < (1u << stride); ++i) {
+                    if (entries[i].node) {
+                        vector |= uint64_t(1) << i;
+                        nodes_.push_back(node_t());
+                    }
+                    else if (first_leaf || leaves_.back() != entries[i].value) {
+                        leafvec |= uint64_t(1) << i;
+                        leaves_.push_back(entries[i].value);
+                        first_leaf = false;
+                    }
+                }
+
+                node_t &n = nodes_[index];
+                n.vector = vector;
+                n.leafvec = leafvec;
+                n.base0 = base0;
+                n.base1 = base1;
+
+                for (unsigned i = 0, k = 0; i < (1u << stride); ++i) {
+                    if (entries[i].node) {
+                        compile(base0 + k++, entries[i]);
+                    }
+                }
+            }
+
+            std::vector<trie_node_t> trie_;
+            std::size_t prefixes_;
+            std::vector<uint32_t> direct_;  // leaf index, or node_flag | node index
+            std::vector<node_t> nodes_;
+            std::vector<uint32_t> leaves_;
+        };
+    } // namespace detail
+
+    /**
+     * Longest prefix match of addresses against a table of IPv4 and IPv6
+     * prefixes (cidr_t, eg from cidr_address), each mapped to a value such
+     * as a rule number or an allow / deny flag.
+     *
+     * Load the table with add() and then build() once; matches see the
+     * prefixes added up to the last build(). A match costs one direct
+     * table load for the top 18 bits plus one 24 byte node per 6 more
+     * bits of the longest prefix there, so a /24 takes two loads.
+     *
+     * Example:
+     *     uri::prefix_table deny;
+     *     deny.add(prefix, 1);                  // for each cidr_t of the list
+     *     deny.build();
+     *     if (deny.match(client) != uri::prefix_table::no_match) { ... }
+     */
+    class prefix_table
+    {
+    public:
+        static constexpr uint32_t no_match = 0xffffffff;
+
+        /**
+         * Map prefix to value, which must not be no_match. Adding a prefix
+         * again replaces its value.
+         */
+        void add(const cidr_t &prefix, uint32_t value)
+        {
+            if (prefix.family == cidr_t::family_ipv4) {
+                ipv4_.add(prefix.ipv4(), prefix.length, value);
+            }
+            else if (prefix.family == cidr_t::family_ipv6) {
+                ipv6_.add(ipv6_key(prefix.bytes), prefix.length, value);
+            }
+        }
+
+        void build()
+        {
+            ipv4_.build();
+            ipv6_.build();
+        }
+
+        void clear()
+        {
+            ipv4_.clear();
+            ipv6_.clear();
+        }
+
+        /**
+         * Prefixes added, both families.
+         */
+        std::size_t size() const { return ipv4_.size() + ipv6_.size(); }
+
+        /**
+         * Memory taken by the lookup structures.
+         */
+        std::size_t bytes() const { return ipv4_.bytes() + ipv6_.bytes(); }
+
+        /**
+         * The value of the longest prefix holding the address, or no_match.
+         * IPv4 addresses are in host order, as parse_ipv4 gives them.
+         */
+        uint32_t match(uint32_t ipv4) const { return ipv4_.match(ipv4); }
+
+        uint32_t match(const uint8_t (&ipv6)[16]) const { return ipv6_.match(ipv6_key(ipv6)); }
+
+    private:
+        typedef unsigned __int128 ipv6_key_t;
+
+        static ipv6_key_t ipv6_key(const uint8_t *bytes)
+        {
+            ipv6_key_t key = 0;
+            for (int i = 0; i < 16; ++i) {
+                key = key << 8 | bytes[i];
+            }
+            return key;
+        }
+
+        detail::poptrie<uint32_t, 32> ipv4_;
+        detail::poptrie<ipv6_key_t, 128> ipv6_;
+    };
+} // namespace uri
+
+#endif // __prefix_table_h__
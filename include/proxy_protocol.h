@@ -0,0 +1,310 @@
+#ifndef __http11_proxy_protocol_h__
+#define __http11_proxy_protocol_h__
+
+#include <boost/config/warning_disable.hpp>
+#include <boost/spirit/include/qi.hpp>
+#include <boost/spirit/include/phoenix_core.hpp>
+#include <boost/spirit/include/phoenix_operator.hpp>
+#include <boost/spirit/include/phoenix_function.hpp>
+#include <boost/utility/string_ref.hpp>
+
+#include "cidr.h"
+#include "ipv4_address.h"
+#include "ipv6_address.h"
+
+#include <cstddef>
+#include <cstring>
+#include <stdint.h>
+
+namespace http11
+{
+    namespace qi = boost::spirit::qi;
+    namespace ascii = boost::spirit::ascii;
+    namespace phoenix = boost::phoenix;
+
+    /**
+     * A PROXY protocol header (HAProxy, version 1 or 2): the connection
+     * as the load balancer in front of us received it.
+     */
+    struct proxy_header_t
+    {
+        enum command_t
+        {
+            command_local,  // a health check from the proxy itself, use the real peer
+            command_proxy
+        };
+
+        enum transport_t
+        {
+            transport_unspec,  // v1 UNKNOWN, or v2 AF_UNSPEC / unknown transport
+            transport_stream,
+            transport_dgram
+        };
+
+        int version;
+        command_t command;
+        transport_t transport;
+        uri::ip_address_t source;       // family_none unless an IPv4 or IPv6 header
+        uri::ip_address_t destination;
+        uint16_t source_port;
+        uint16_t destination_port;
+        boost::string_ref source_path;       // v2 AF_UNIX addresses
+        boost::string_ref destination_path;
+        boost::string_ref tlvs;         // v2 type-length-value vectors, raw, see next_tlv
+        std::size_t size;               // bytes of the header
+
+        proxy_header_t() :
+            version(0), command(command_local), transport(transport_unspec),
+            source_port(0), destination_port(0), size(0)
+        { }
+    };
+
+    enum proxy_status_t
+    {
+        proxy_ok,
+        proxy_incomplete,  // a prefix of a header, read more
+        proxy_none,        // the input does not start with a PROXY header
+        proxy_bad          // a malformed header
+    };
+
+    /**
+     * Parser for the version 1 (text) header line into it:
+     *
+     *     "PROXY TCP4 192.0.2.1 198.51.100.2 56324 443\r\n"
+     *     "PROXY TCP6 2001:db8::1 2001:db8::2 56324 443\r\n"
+     *     "PROXY UNKNOWN ...\r\n"
+     *
+     * Ports are 0-65535 without leading zeros. The 107 byte limit is left
+     * to parse_proxy_header.
+     */
+    template <typename Iterator>
+    struct proxy_v1_parser : qi::grammar<Iterator>
+    {
+        explicit proxy_v1_parser(proxy_header_t &it);
+
+        uri::ipv4_address<Iterator> ipv4;
+        uri::ipv6_address<Iterator> ipv6;
+        qi::rule<Iterator> port_digits, tcp4, tcp6, unknown;
+        qi::rule<Iterator> start;
+    }; // struct proxy_v1_parser
+
+    template <typename Iterator>
+    proxy_v1_parser<Iterator>::proxy_v1_parser(proxy_header_t &it) :
+        proxy_v1_parser::base_type(start)
+    {
+        using qi::char_;
+        using qi::lit;
+        using qi::raw;
+        using qi::_1;
+        using qi::_pass;
+        using ascii::digit;
+        using phoenix::ref;
+        typedef uri::ip_address_t address_t;
+
+        phoenix::function<uri::detail::assign_address_impl> address_;
+        qi::uint_parser<unsigned, 10, 1, 5> port;
+
+        port_digits = !(lit('0') >> digit) >> &digit;
+
+        tcp4        = lit("TCP4 ")
+                    >> raw[ipv4][_pass = address_(ref(it.source), address_t::family_ipv4, _1)] >> ' '
+                    >> raw[ipv4][_pass = address_(ref(it.destination), address_t::family_ipv4, _1)] >> ' '
+                    ;
+        tcp6        = lit("TCP6 ")
+                    >> raw[ipv6.ipv6_attr][_pass = address_(ref(it.source), address_t::family_ipv6, _1)] >> ' '
+                    >> raw[ipv6.ipv6_attr][_pass = address_(ref(it.destination), address_t::family_ipv6, _1)] >> ' '
+                    ;
+        unknown     = lit("UNKNOWN") >> *(char_ - '\r');
+
+        start       = lit("PROXY ")
+                    >> ( (tcp4 | tcp6)
+                         >> port_digits >> port[_pass = _1 <= 65535u, ref(it.source_port) = _1] >> ' '
+                         >> port_digits >> port[_pass = _1 <= 65535u, ref(it.destination_port) = _1]
+                         >> qi::eps[ref(it.transport) = proxy_header_t::transport_stream]
+                       | unknown
+                       )
+                    >> lit("\r\n")
+                    ;
+
+        tcp4.name("tcp4");
+        tcp6.name("tcp6");
+        unknown.name("unknown");
+        start.name("start");
+    }
+
+    namespace detail
+    {
+        const char proxy_v1_signature[] = "PROXY ";
+        const char proxy_v2_signature[] = "\r\n\r\n\0\r\nQUIT\n";
+
+        const std::size_t proxy_v1_signature_size = 6;
+        const std::size_t proxy_v1_max_size = 107;
+        const std::size_t proxy_v2_signature_size = 12;
+        const std::size_t proxy_v2_fixed_size = 16;
+
+        inline uint16_t big_endian16(const char *p)
+        {
+            return static_cast<uint16_t>(static_cast<unsigned char>(p[0]) << 8 | static_cast<unsigned char>(p[1]));
+        }
+
+        // The prefix of a signature the input holds: 0 when it differs.
+        inline std::size_t signature_prefix(const char *first, const char *last, const char *signature, std::size_t size)
+        {
+            std::size_t n = static_cast<std::size_t>(last - first) < size ? last - first : size;
+            return std::memcmp(first, signature, n) == 0 ? n : 0;
+        }
+
+        inline boost::string_ref unix_path(const char *p)
+        {
+            const char *nul = static_cast<const char *>(std::memchr(p, 0, 108));
+            return boost::string_ref(p, nul ? nul - p : 108);
+        }
+
+        inline proxy_status_t parse_proxy_v2(const char *first, const char *last, proxy_header_t &out)
+        {
+            if (static_cast<std::size_t>(last - first) < proxy_v2_fixed_size) {
+                return proxy_incomplete;
+            }
+            unsigned char version_command = static_cast<unsigned char>(first[12]);
+            unsigned char family_transport = static_cast<unsigned char>(first[13]);
+            std::size_t length = big_endian16(first + 14);
+
+            unsigned command = version_command & 0xf;
+            unsigned family = family_transport >> 4;
+            unsigned transport = family_transport & 0xf;
+            if (version_command >> 4 != 2 || command > 1 || family > 3 || transport > 2) {
+                return proxy_bad;
+            }
+            if (static_cast<std::size_t>(last - first) < proxy_v2_fixed_size + length) {
+                return proxy_incomplete;
+            }
+
+            const char *p = first + proxy_v2_fixed_size;
+            const char *end = p + length;
+            std::size_t addresses = family == 1 ? 12 : family == 2 ? 36 : family == 3 ? 216 : 0;
+            if (length < addresses) {
+                return proxy_bad;
+            }
+
+            out = proxy_header_t();
+            out.version = 2;
+            out.size = proxy_v2_fixed_size + length;
+            out.command = command ? proxy_header_t::command_proxy : proxy_header_t::command_local;
+            out.transport = static_cast<proxy_header_t::transport_t>(transport);
+            if (family == 1) {
+                out.source.assign(static_cast<uint32_t>(big_endian16(p)) << 16 | big_endian16(p + 2));
+                out.destination.assign(static_cast<uint32_t>(big_endian16(p + 4)) << 16 | big_endian16(p + 6));
+                out.source_port = big_endian16(p + 8);
+                out.destination_port = big_endian16(p + 10);
+            }
+            else if (family == 2) {
+                uint8_t address[16];
+                std::memcpy(address, p, 16);
+                out.source.assign(address);
+                std::memcpy(address, p + 16, 16);
+                out.destination.assign(address);
+                out.source_port = big_endian16(p + 32);
+                out.destination_port = big_endian16(p + 34);
+            }
+            else if (family == 3) {
+                out.source_path = unix_path(p);
+                out.destination_path = unix_path(p + 108);
+            }
+            out.tlvs = boost::string_ref(p + addresses, end - p - addresses);
+            return proxy_ok;
+        }
+    } // namespace detail
+
+    /**
+     * Parse the PROXY header, of either version, at the start of a
+     * connection's first bytes. On proxy_ok, first is moved past it (by
+     * out.size bytes), so the HTTP request parse starts there in the same
+     * buffer. Nothing is copied or allocated; out.tlvs and the AF_UNIX
+     * paths point into the input.
+     *
+     * proxy_incomplete asks for more bytes; proxy_none means the input
+     * starts with something else, which is a request when the proxy
+     * header is optional and an error when it is required.
+     *
+     * Example:
+     *     http11::proxy_header_t proxy;
+     *     switch (http11::parse_proxy_header(first, last, proxy)) { ... }
+     *     http11::parse_request(first, last, req);
+     */
+    inline proxy_status_t parse_proxy_header(const char *&first, const char *last, proxy_header_t &out)
+    {
+        using namespace detail;
+
+        if (first == last) {
+            return proxy_incomplete;
+        }
+
+        std::size_t v2 = signature_prefix(first, last, proxy_v2_signature, proxy_v2_signature_size);
+        if (v2 == proxy_v2_signature_size) {
+            proxy_status_t status = parse_proxy_v2(first, last, out);
+            if (status == proxy_ok) {
+                first += out.size;
+            }
+            return status;
+        }
+        std::size_t v1 = signature_prefix(first, last, proxy_v1_signature, proxy_v1_signature_size);
+        if (v2 == static_cast<std::size_t>(last - first) || v1 == static_cast<std::size_t>(last - first)) {
+            return proxy_incomplete;
+        }
+        if (v1 != proxy_v1_signature_size) {
+            return proxy_none;
+        }
+
+        std::size_t available = static_cast<std::size_t>(last - first);
+        std::size_t window = available < proxy_v1_max_size ? available : proxy_v1_max_size;
+        const char *lf = static_cast<const char *>(std::memchr(first, '\n', window));
+        if (!lf) {
+            return available < proxy_v1_max_size ? proxy_incomplete : proxy_bad;
+        }
+
+        static thread_local proxy_header_t parsed;
+        static thread_local proxy_v1_parser<const char *> grammar(parsed);
+
+        parsed = proxy_header_t();
+        const char *cur = first;
+        if (!qi::parse(cur, lf + 1, grammar) || cur != lf + 1) {
+            return proxy_bad;
+        }
+        parsed.version = 1;
+        parsed.command = proxy_header_t::command_proxy;
+        parsed.size = cur - first;
+        out = parsed;
+        first = cur;
+        return proxy_ok;
+    }
+
+    /**
+     * A version 2 type-length-value vector.
+     */
+    struct proxy_tlv_t
+    {
+        uint8_t type;  // eg 0x01 PP2_TYPE_ALPN, 0x02 PP2_TYPE_AUTHORITY
+        boost::string_ref value;
+    };
+
+    /**
+     * Take the first vector off tlvs (see proxy_header_t::tlvs); false at
+     * the end, or when the rest is truncated.
+     */
+    inline bool next_tlv(boost::string_ref &tlvs, proxy_tlv_t &out)
+    {
+        if (tlvs.size() < 3) {
+            return false;
+        }
+        std::size_t length = detail::big_endian16(tlvs.data() + 1);
+        if (tlvs.size() < 3 + length) {
+            return false;
+        }
+        out.type = static_cast<uint8_t>(tlvs[0]);
+        out.value = boost::string_ref(tlvs.data() + 3, length);
+        tlvs.remove_prefix(3 + length);
+        return true;
+    }
+} // namespace http11
+
+#endif // __http11_proxy_protocol_h__
@@ -0,0 +1,208 @@
+#ifndef __uri_query_string_h__
+#define __uri_query_string_h__
+
+#include "percent_decode.h"
+
+#include <boost/utility/string_ref.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <string>
+
+namespace uri
+{
+    /**
+     * A single key[=value] pair of a query string. Both halves point into the
+     * raw (still encoded) query, so "a%26b=1" and "a&b=1" stay distinct.
+     */
+    struct query_param_t
+    {
+        boost::string_ref key;
+        boost::string_ref value;
+        bool has_value;  // "a=" has an (empty) value, "a" has none
+
+        query_param_t() : has_value(false) { }
+    };
+
+    /**
+     * Lazy tokenizer over the raw bytes of a query component.
+     *
+     * Nothing is decoded or copied up front: iterating only splits on '&'
+     * and '=', and a pair is decoded when the caller asks for it, into a
+     * buffer the caller owns. Decoding returns the raw bytes directly when
+     * there is nothing to decode.
+     *
+     * Example:
+     *     uri::query_string qs(raw, uri::query_string::plus_as_space);
+     *     for (uri::query_string::const_iterator i = qs.begin(); i != qs.end(); ++i) {
+     *         boost::string_ref value = qs.decode(i->value, scratch);
+     *     }
+     */
+    class query_string
+    {
+    public:
+        enum flags_t
+        {
+            plus_as_space = 1  // treat '+' as an encoded space
+        };
+
+        class const_iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef query_param_t value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const query_param_t *pointer;
+            typedef const query_param_t &reference;
+
+            const_iterator() : next_(0), end_(0) { }
+
+            const_iterator(const char *first, const char *last) :
+                next_(first), end_(last)
+            {
+                advance();
+            }
+
+            reference operator*() const { return param_; }
+            pointer operator->() const { return &param_; }
+
+            const_iterator &operator++()
+            {
+                advance();
+                return *this;
+            }
+
+            const_iterator operator++(int)
+            {
+                const_iterator tmp(*this);
+                advance();
+                return tmp;
+            }
+
+            bool operator==(const const_iterator &rhs) const
+            {
+                return param_.key.data() == rhs.param_.key.data() && next_ == rhs.next_;
+            }
+
+            bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+
+        private:
+            // Move to the next non-empty pair, or become the end iterator.
+            void advance()
+            {
+                while (next_ && next_ != end_) {
+                    const char *amp = static_cast<const char *>(std::memchr(next_, '&', end_ - next_));
+                    const char *pair_end = amp ? amp : end_;
+                    const char *pair_begin = next_;
+                    next_ = amp ? amp + 1 : end_;
+
+                    if (pair_begin == pair_end) {
+                        continue;
+                    }
+
+                    const char *eq = static_cast<const char *>(std::memchr(pair_begin, '=', pair_end - pair_begin));
+                    if (eq) {
+                        param_.key = boost::string_ref(pair_begin, eq - pair_begin);
+                        param_.value = boost::string_ref(eq + 1, pair_end - eq - 1);
+                        param_.has_value = true;
+                    }
+                    else {
+                        param_.key = boost::string_ref(pair_begin, pair_end - pair_begin);
+                        param_.value = boost::string_ref();
+                        param_.has_value = false;
+                    }
+                    return;
+                }
+
+                next_ = end_ = 0;
+                param_ = query_param_t();
+            }
+
+            const char *next_;
+            const char *end_;
+            query_param_t param_;
+        };
+
+        typedef const_iterator iterator;
+
+        query_string(const char *first, const char *last, int flags = 0) :
+            first_(first), last_(last), flags_(flags)
+        { }
+
+        explicit query_string(boost::string_ref raw, int flags = 0) :
+            first_(raw.data()), last_(raw.data() + raw.size()), flags_(flags)
+        { }
+
+        const_iterator begin() const { return const_iterator(first_, last_); }
+        const_iterator end() const { return const_iterator(); }
+
+        bool empty() const { return begin() == end(); }
+
+        /**
+         * Decoded form of raw (a key or value of this query). Returns raw
+         * itself when it holds no escapes, otherwise decodes into scratch and
+         * returns a reference to it.
+         */
+        boost::string_ref decode(boost::string_ref raw, std::string &scratch) const
+        {
+            bool plus = (flags_ & plus_as_space) != 0;
+            if (!needs_decoding(raw.data(), raw.data() + raw.size(), plus)) {
+                return raw;
+            }
+            scratch.clear();
+            percent_decode(raw.data(), raw.data() + raw.size(), scratch, plus);
+            return boost::string_ref(scratch);
+        }
+
+        /**
+         * Look up several keys in a single pass over the query. keys are
+         * compared against the decoded parameter names; found[i] receives the
+         * first pair named keys[i] and is left untouched when there is none.
+         * A key given twice is resolved in both places. Stops as soon as
+         * every key has been seen. Returns the number of keys found; at most
+         * the first 64 keys are looked up.
+         */
+        std::size_t find(const boost::string_ref *keys, std::size_t count, query_param_t *found) const
+        {
+            // Bit i of seen marks keys[i] as resolved; callers look up a handful
+            // of keys, so a word is plenty.
+            unsigned long long seen = 0;
+            std::size_t wanted = std::min<std::size_t>(count, 64);
+            std::size_t hits = 0;
+            bool plus = (flags_ & plus_as_space) != 0;
+
+            for (const_iterator cur = begin(), last = end(); cur != last && hits < wanted; ++cur) {
+                bool raw_key = !needs_decoding(cur->key.data(), cur->key.data() + cur->key.size(), plus);
+                for (std::size_t i = 0; i < wanted; ++i) {
+                    if (seen & (1ULL << i)) {
+                        continue;
+                    }
+                    if (raw_key ? cur->key == keys[i] : decoded_equals(cur->key, keys[i], plus)) {
+                        found[i] = *cur;
+                        seen |= 1ULL << i;
+                        ++hits;
+                    }
+                }
+            }
+
+            return hits;
+        }
+
+        /**
+         * Single key lookup, see above.
+         */
+        bool find(boost::string_ref key, query_param_t &found) const
+        {
+            return find(&key, 1, &found) == 1;
+        }
+
+    private:
+        const char *first_;
+        const char *last_;
+        int flags_;
+    };
+} // namespace uri
+
+#endif // __uri_query_string_h__
@@ -0,0 +1,41 @@
+#ifndef __spirit_parsers_h__
+#define __spirit_parsers_h__
+
+/**
+ * Lightweight entry points into the precompiled grammars of the
+ * spirit_parsers library.
+ *
+ * This header pulls in no Spirit or Phoenix code, only the result types, so
+ * translation units that just need to parse can include it instead of
+ * uri_parser.h or http11_parser.h and link against spirit_parsers.
+ *
+ * Every function parses a prefix of [first, last) like qi::parse: on success
+ * first is moved past the matched input and true is returned. The results
+ * refer to the parsed input (see component_t), which must outlive them.
+ * Grammars are built once per thread, so the functions are thread safe.
+ */
+
+#include "uri.h"
+#include "http11_request.h"
+
+#include <string>
+
+namespace uri
+{
+    bool parse_uri(const char *&first, const char *last, uri_t &out);
+    bool parse_uri(std::string::const_iterator &first, std::string::const_iterator last, uri_t &out);
+
+    bool parse_ipv4_address(const char *&first, const char *last, std::string &out);
+    bool parse_ipv4_address(std::string::const_iterator &first, std::string::const_iterator last, std::string &out);
+
+    bool parse_ipv6_address(const char *&first, const char *last, std::string &out);
+    bool parse_ipv6_address(std::string::const_iterator &first, std::string::const_iterator last, std::string &out);
+} // namespace uri
+
+namespace http11
+{
+    bool parse_request(const char *&first, const char *last, request_t &out);
+    bool parse_request(std::string::const_iterator &first, std::string::const_iterator last, request_t &out);
+} // namespace http11
+
+#endif // __spirit_parsers_h__
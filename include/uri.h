@@ -0,0 +1,94 @@
+#ifndef __uri_h__
+#define __uri_h__
+
+#include "uri_component.h"
+
+#include <stdint.h>
+#include <string>
+
+namespace uri
+{
+    /**
+     * Which alternative of the host grammar matched.
+     */
+    enum host_kind_t
+    {
+        host_none,
+        host_reg_name,
+        host_ipv4,
+        host_ipv6,
+        host_ipv_future
+    };
+
+    /**
+     * Whether a URI had a port: "http://host" has none, "http://host:" an
+     * empty one.
+     */
+    enum port_state_t
+    {
+        port_absent,
+        port_empty,
+        port_present
+    };
+
+    /**
+     * A parsed URI. Every component refers to the parsed input, see
+     * component_t, so the input must outlive the uri_t.
+     */
+    struct uri_t
+    {
+        component_t scheme;
+        component_t authority;  // user_info@host:port, as a whole
+        component_t user_info;
+        component_t host;       // IP literals without their brackets
+        component_t port;       // the digits as written, eg "080"
+        component_t path;
+        component_t query;
+        component_t fragment;
+        host_kind_t host_kind;
+        uint16_t port_number;   // 0 unless port_state() is port_present
+
+        uri_t() : host_kind(host_none), port_number(0) { }
+
+        port_state_t port_state() const
+        {
+            if (!port.defined()) {
+                return port_absent;
+            }
+            return port.empty() ? port_empty : port_present;
+        }
+
+        void clear()
+        {
+            scheme.clear();
+            clear_authority();
+            path.clear();
+            query.clear();
+            fragment.clear();
+        }
+
+        void clear_authority()
+        {
+            authority.clear();
+            user_info.clear();
+            host.clear();
+            port.clear();
+            host_kind = host_none;
+            port_number = 0;
+        }
+
+        std::string to_string() const
+        {
+            return "scheme(" + scheme.str() + 
+                   "),user_info(" + user_info.str() + 
+                   "),host(" + host.str() + 
+                   "),port(" + port.str() + 
+                   "),path(" + path.str() + 
+                   "),query(" + query.str() + 
+                   "),fragment(" + fragment.str() + 
+                   ")";
+        }
+    };
+} // namespace uri
+
+#endif // __uri_h__
@@ -0,0 +1,121 @@
+#ifndef __uri_component_h__
+#define __uri_component_h__
+
+#include "percent_decode.h"
+
+#include <boost/utility/string_ref.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace uri
+{
+    /**
+     * A single URI component (scheme, host, path, ...).
+     *
+     * The component refers to the bytes exactly as they appeared in the
+     * parsed input, so those can be forwarded untouched; the input buffer
+     * must outlive the component. The decoded form is produced the first
+     * time it is asked for. When the raw bytes hold no escapes, which is
+     * the common case, the decoded form is the raw bytes and nothing is
+     * copied.
+     *
+     * Comparisons against strings use the decoded form.
+     *
+     * Note: decoded() fills a cache, so concurrent first calls on a shared
+     * component must be synchronised by the caller.
+     */
+    class component_t
+    {
+    public:
+        component_t() :
+            first_(0), size_(0), defined_(false), escaped_(false), decoded_ready_(false)
+        { }
+
+        /**
+         * Point the component at [first, last) of the input buffer.
+         */
+        void assign(const char *first, const char *last)
+        {
+            first_ = first;
+            size_ = last - first;
+            defined_ = true;
+            escaped_ = size_ != 0 && std::memchr(first, '%', size_) != 0;
+            decoded_ready_ = false;
+        }
+
+        /**
+         * Forget the component; the decode buffer keeps its capacity.
+         */
+        void clear()
+        {
+            first_ = 0;
+            size_ = 0;
+            defined_ = false;
+            escaped_ = false;
+            decoded_ready_ = false;
+            decoded_.clear();
+        }
+
+        // Present in the input, possibly empty (eg, the query of "/a?").
+        bool defined() const { return defined_; }
+        bool empty() const { return size_ == 0; }
+        bool escaped() const { return escaped_; }
+
+        /**
+         * The bytes as they appeared in the input.
+         */
+        boost::string_ref raw() const { return boost::string_ref(first_, size_); }
+
+        /**
+         * The percent decoded bytes. Shares the raw bytes when there is
+         * nothing to decode.
+         */
+        boost::string_ref decoded() const
+        {
+            if (!escaped_) {
+                return raw();
+            }
+            if (!decoded_ready_) {
+                decoded_.clear();
+                percent_decode(first_, first_ + size_, decoded_);
+                decoded_ready_ = true;
+            }
+            return boost::string_ref(decoded_);
+        }
+
+        std::string str() const
+        {
+            boost::string_ref d = decoded();
+            return std::string(d.data(), d.size());
+        }
+
+        friend bool operator==(const component_t &lhs, boost::string_ref rhs) { return lhs.decoded() == rhs; }
+        friend bool operator==(boost::string_ref lhs, const component_t &rhs) { return rhs.decoded() == lhs; }
+        friend bool operator==(const component_t &lhs, const char *rhs) { return lhs.decoded() == rhs; }
+        friend bool operator==(const char *lhs, const component_t &rhs) { return rhs.decoded() == lhs; }
+        friend bool operator==(const component_t &lhs, const std::string &rhs) { return lhs.decoded() == rhs; }
+        friend bool operator==(const std::string &lhs, const component_t &rhs) { return rhs.decoded() == lhs; }
+        friend bool operator!=(const component_t &lhs, const char *rhs) { return !(lhs == rhs); }
+        friend bool operator!=(const char *lhs, const component_t &rhs) { return !(lhs == rhs); }
+        friend bool operator!=(const component_t &lhs, const std::string &rhs) { return !(lhs == rhs); }
+        friend bool operator!=(const std::string &lhs, const component_t &rhs) { return !(lhs == rhs); }
+
+        friend std::ostream &operator<<(std::ostream &os, const component_t &c)
+        {
+            return os << c.decoded();
+        }
+
+    private:
+        const char *first_;
+        std::size_t size_;
+        bool defined_;
+        bool escaped_;
+        mutable bool decoded_ready_;
+        mutable std::string decoded_;
+    };
+} // namespace uri
+
+#endif // __uri_component_h__
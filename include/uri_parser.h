@@ -6,7 +6,12 @@
 #include <boost/spirit/include/phoenix_core.hpp>
 #include <boost/spirit/include/phoenix_operator.hpp>
 #include <boost/spirit/include/phoenix_object.hpp>
+#include <boost/spirit/include/phoenix_function.hpp>
+#include <boost/spirit/include/phoenix_bind.hpp>
 
+#include "uri.h"
+#include "uri_scan.h"
+#include "authority_cache.h"
 #include "percent_encoded_char.h"
 #include "ipv4_address.h"
 #include "ipv6_address.h"
@@ -20,150 +25,300 @@ namespace uri
     namespace ascii = boost::spirit::ascii;
     namespace phoenix = boost::phoenix;
 
-    struct uri_t
+    namespace detail
     {
-        std::string scheme;
-        std::string user_info;
-        std::string host;
-        std::string port;
-        std::string path;
-        std::string query;
-        std::string fragment;
-
-        std::string to_string()
+        /**
+         * Semantic action helper pointing a component_t at the range matched
+         * by raw[]. The grammars require iterators over contiguous storage
+         * (const char *, std::string or std::vector<char> iterators).
+         */
+        struct assign_component_impl
         {
-            return "scheme(" + scheme + 
-                   "),user_info(" + user_info + 
-                   "),host(" + host + 
-                   "),port(" + port + 
-                   "),path(" + path + 
-                   "),query(" + query + 
-                   "),fragment(" + fragment + 
-                   ")";
-        }
-    };
+            typedef void result_type;
+
+            template <typename Range>
+            void operator()(component_t &c, const Range &r) const
+            {
+                if (r.begin() == r.end()) {
+                    c.assign(0, 0);
+                }
+                else {
+                    const char *first = &*r.begin();
+                    c.assign(first, first + (r.end() - r.begin()));
+                }
+            }
+        };
+
+        /**
+         * Runs the authority rule through an authority_cache, see there.
+         * Without a cache it is just the rule.
+         */
+        template <typename Iterator>
+        struct cached_authority_parser : qi::primitive_parser<cached_authority_parser<Iterator> >
+        {
+            template <typename Context, typename It>
+            struct attribute
+            {
+                typedef boost::spirit::unused_type type;
+            };
+
+            cached_authority_parser(const qi::rule<Iterator> &rule, uri_t &it, authority_cache *cache) :
+                rule(rule), it(it), cache(cache)
+            { }
+
+            template <typename It, typename Context, typename Skipper, typename Attribute>
+            bool parse(It &first, It const &last, Context &context, Skipper const &skipper, Attribute &attr) const
+            {
+                if (!cache || first == last) {
+                    return rule.parse(first, last, context, skipper, attr);
+                }
+
+                It end = first;
+                while (end != last && authority_cache::authority_char(*end)) {
+                    ++end;
+                }
+                std::size_t size = end - first;
+                if (size == 0 || size > authority_cache::max_key) {
+                    return rule.parse(first, last, context, skipper, attr);
+                }
+
+                const char *key = &*first;
+                if (cache->lookup(key, size, it)) {
+                    first = end;
+                    return true;
+                }
+
+                It cur = first;
+                if (!rule.parse(cur, last, context, skipper, attr)) {
+                    return false;
+                }
+                // Cache only what the grammar matched in full; a shorter match
+                // depends on more than the key bytes.
+                if (cur == end) {
+                    cache->insert(key, size, it);
+                }
+                first = cur;
+                return true;
+            }
+
+            template <typename Context>
+            boost::spirit::info what(Context &context) const
+            {
+                return rule.what(context);
+            }
+
+            const qi::rule<Iterator> &rule;
+            uri_t &it;
+            authority_cache *cache;
+        };
+
+        /**
+         * Picks the request-target alternative from its first bytes instead
+         * of trying abs_uri and backtracking into rel_uri: a scheme followed
+         * by ':' can only start an absolute URI, and "/" not followed by
+         * another "/" only a path-absolute reference.
+         */
+        template <typename Iterator>
+        struct target_parser : qi::primitive_parser<target_parser<Iterator> >
+        {
+            template <typename Context, typename It>
+            struct attribute
+            {
+                typedef boost::spirit::unused_type type;
+            };
+
+            target_parser(const qi::rule<Iterator> &abs_uri, const qi::rule<Iterator> &origin_form,
+                          const qi::rule<Iterator> &rel_uri) :
+                abs_uri(abs_uri), origin_form(origin_form), rel_uri(rel_uri)
+            { }
+
+            template <typename It, typename Context, typename Skipper, typename Attribute>
+            bool parse(It &first, It const &last, Context &context, Skipper const &skipper, Attribute &attr) const
+            {
+                if (first != last && *first == '/') {
+                    It second = first;
+                    if (++second == last || *second != '/') {
+                        return origin_form.parse(first, last, context, skipper, attr);
+                    }
+                }
+                else if (scan::scheme_follows(first, last)) {
+                    if (abs_uri.parse(first, last, context, skipper, attr)) {
+                        return true;
+                    }
+                }
+                return rel_uri.parse(first, last, context, skipper, attr);
+            }
+
+            template <typename Context>
+            boost::spirit::info what(Context &) const
+            {
+                return boost::spirit::info("request-target");
+            }
+
+            const qi::rule<Iterator> &abs_uri;
+            const qi::rule<Iterator> &origin_form;
+            const qi::rule<Iterator> &rel_uri;
+        };
+    } // namespace detail
 
     template <typename Iterator>
     struct uri_parser : qi::grammar<Iterator>
     {
-
-        uri_parser(uri_t &it) : 
-            uri_parser::base_type(start)
-        {
-            using qi::omit;
-            using qi::xdigit;
-            using qi::repeat;
-            using qi::char_;
-            using qi::raw;
-            using ascii::alnum;
-            using ascii::digit;
-            using ascii::string;
-            using phoenix::ref;
-
-            gen_delims      = char_(":/?#[]@");
-            sub_delims      = char_("!$&'()*+,;=");
-            path_char       = char_('/');
-            reserved_char   = gen_delims | sub_delims;
-            unreserved_char = alnum | char_("-._~");
-            pchar           = unreserved_char | pct_enc_char | sub_delims | char_(":@");
-
-            // Segments
-            segment         = *pchar;
-            segment_nz      = +pchar;
-            segment_nz_nc   = +(unreserved_char | pct_enc_char | sub_delims | char_('@'));
-
-            // Scheme
-            scheme_attr     = alnum >> +(alnum | char_("+-.")) >> omit[':'];
-            scheme          = scheme_attr[ref(it.scheme) = qi::_1];
-
-            // User info
-            user_info_attr  = +(unreserved_char | pct_enc_char | sub_delims | ':') >> omit['@'];
-            user_info       = user_info_attr[ref(it.user_info) = qi::_1];
-
-            // Address
-            reg_name        = +(unreserved_char | pct_enc_char | sub_delims);
-            ip_v_future     = char_('v') >> -xdigit >> '.' >> repeat(0,1)[unreserved_char | sub_delims | ':'];
-            ip_literal      = omit['['] >> (ip_v_future | ipv6) >> omit[']'];
-            host_attr       = ip_literal | ipv4 | reg_name;
-            host            = host_attr[ref(it.host) = qi::_1];
-            port_attr       = *digit;
-            port            = port_attr[ref(it.port) = qi::_1];
-
-            // Authority
-            authority       = -user_info >> host >> -(':' >> port);
-
-            // Path
-            path_abempty    %= raw[*(path_char >> segment)][ref(it.path) = qi::_val];
-            path_absolute   %= raw[path_char >> -(segment_nz >> *(path_char >> segment))][ref(it.path) = qi::_val];
-            path_noscheme   %= raw[segment_nz_nc >> *(path_char >> segment)][ref(it.path) = qi::_val];
-            path_rootless   %= raw[segment_nz >> *(path_char >> segment)][ref(it.path) = qi::_val];
-            path_empty      %= !pchar[ref(it.path) = ""];
-
-            // Query
-            query_attr      = omit['?'] >> *(pchar | char_("/?"));
-            query           = query_attr[ref(it.query) = qi::_1];
-
-            // Fragment
-            fragment_attr   = omit['#'] >> *(pchar | char_("/?"));
-            fragment        = fragment_attr[ref(it.fragment) = qi::_1];
-
-            // Request-URI
-            hier_part       = omit["//"] >> authority >> path_abempty
-                            | path_absolute
-                            | path_rootless
-                            | path_empty
-                            ;
-            abs_uri         = scheme >> hier_part >> -query >> -fragment;
-
-            relative_part   = omit["//"] >> authority >> path_abempty
-                            | path_absolute
-                            | path_noscheme
-                            | path_empty
-                            ;
-            rel_uri         = relative_part >> -query >> -fragment;
-
-            // entry
-            start           = abs_uri | rel_uri | string("*");
-
-
-            path_abempty.name("path_abempty");
-            path_absolute.name("path_absolute");
-            path_noscheme.name("path_noscheme");
-            path_rootless.name("path_rootless");
-            path_empty.name("path_empty");
-            hier_part.name("hier_part");
-
-            //qi::debug(hier_part);
-            //qi::debug(path_abempty);
-            //qi::debug(path_absolute);
-            //qi::debug(path_noscheme);
-            //qi::debug(path_rootless);
-            //qi::debug(path_empty);
-        }
+        /**
+         * Parse into it. With a cache, authorities are looked up there
+         * first, see authority_cache; eg pass &authority_cache::local().
+         */
+        uri_parser(uri_t &it, authority_cache *cache = 0);
 
         ipv4_address<Iterator> ipv4;
         ipv6_address<Iterator> ipv6;
         percent_encoded_char<Iterator> pct_enc_char;
 
-        qi::rule<Iterator, std::string()> reg_name;
+        typedef boost::iterator_range<Iterator> range_t;
+
+        qi::rule<Iterator> reg_name;
 
         qi::rule<Iterator, char()> gen_delims, sub_delims;
         qi::rule<Iterator, char()> reserved_char, unreserved_char;
         qi::rule<Iterator, char()> path_char;
         qi::rule<Iterator, char()> pchar;
 
-        qi::rule<Iterator> segment, segment_nz, segment_nz_nc;
-        qi::rule<Iterator, std::string()> path_abempty, path_absolute, path_noscheme, path_rootless, path_empty;
+        qi::rule<Iterator, range_t()> path_abempty, path_absolute, path_noscheme, path_rootless, path_empty;
 
-        qi::rule<Iterator, std::string()> ip_v_future, ip_literal;
+        qi::rule<Iterator> ip_v_future;
+        qi::rule<Iterator, range_t()> ip_literal, host_attr;
 
-        qi::rule<Iterator> scheme, user_info, host, port, path, query, fragment, authority;
+        qi::rule<Iterator> scheme, user_info, host, port, query, fragment, authority, clear_authority;
 
-        qi::rule<Iterator, std::string()> scheme_attr, user_info_attr, host_attr, port_attr, path_attr, query_attr, fragment_attr;
-        qi::rule<Iterator, std::string()> hier_part, relative_part, abs_uri, rel_uri;
+        qi::rule<Iterator> scheme_attr, user_info_attr, port_attr, query_attr, fragment_attr;
+        qi::rule<Iterator> hier_part, relative_part, abs_uri, rel_uri, origin_form;
 
         qi::rule<Iterator> start;
     };
+
+    template <typename Iterator>
+    uri_parser<Iterator>::uri_parser(uri_t &it, authority_cache *cache) :
+        uri_parser::base_type(start)
+    {
+        using qi::omit;
+        using qi::xdigit;
+        using qi::repeat;
+        using qi::char_;
+        using qi::raw;
+        using qi::lit;
+        using qi::eps;
+        using ascii::alpha;
+        using ascii::alnum;
+        using ascii::digit;
+        using ascii::string;
+
+        phoenix::function<detail::assign_component_impl> assign;
+        qi::uint_parser<uint16_t> uint16_;
+
+        gen_delims      = char_(":/?#[]@");
+        sub_delims      = char_("!$&'()*+,;=");
+        path_char       = char_('/');
+        reserved_char   = gen_delims | sub_delims;
+        unreserved_char = alnum | char_("-._~");
+        pchar           = unreserved_char | pct_enc_char | sub_delims | char_(":@");
+
+        // Scheme
+        scheme_attr     = alpha >> *(alnum | char_("+-."));
+        scheme          = raw[scheme_attr >> &lit(':')][assign(phoenix::ref(it.scheme), qi::_1)] >> ':';
+
+        // User info
+        user_info_attr  = +(unreserved_char | pct_enc_char | sub_delims | char_(':'));
+        user_info       = raw[user_info_attr >> &lit('@')][assign(phoenix::ref(it.user_info), qi::_1)] >> '@';
+
+        // Address
+        reg_name        = +(unreserved_char | pct_enc_char | sub_delims);
+        ip_v_future     = char_('v') >> -xdigit >> '.' >> repeat(0,1)[unreserved_char | sub_delims | ':'];
+        ip_literal     %= '[' >> raw[ ip_v_future[phoenix::ref(it.host_kind) = host_ipv_future]
+                                   | ipv6[phoenix::ref(it.host_kind) = host_ipv6]
+                                   ] >> ']';
+        host_attr      %= ip_literal
+                        | raw[ ipv4[phoenix::ref(it.host_kind) = host_ipv4]
+                             | reg_name[phoenix::ref(it.host_kind) = host_reg_name]
+                             ];
+        host            = host_attr[assign(phoenix::ref(it.host), qi::_1)];
+        // Port: converted while it is matched; a value over 65535 fails the
+        // port, and with it the authority.
+        port_attr       = -uint16_[phoenix::ref(it.port_number) = qi::_1] >> !digit;
+        port            = raw[port_attr][assign(phoenix::ref(it.port), qi::_1)];
+
+        // Authority
+        authority       = raw[-user_info >> host >> -(':' >> port)][assign(phoenix::ref(it.authority), qi::_1)];
+        detail::cached_authority_parser<Iterator> cached_authority(authority, it, cache);
+
+        // Path: RFC 3986 section 3.3, matched by scan::path_* in
+        // uri_scan.h, which has the ABNF of each.
+        path_abempty    = raw[path_parser(scan::path_abempty)];
+        path_absolute   = raw[path_parser(scan::path_absolute)];
+        path_noscheme   = raw[path_parser(scan::path_noscheme)];
+        path_rootless   = raw[path_parser(scan::path_rootless)];
+        path_empty      = raw[!pchar];
+
+        // Query
+        query_attr      = path_parser(scan::query_chars);         // *(pchar | char_("/?"))
+        query           = '?' >> raw[query_attr][assign(phoenix::ref(it.query), qi::_1)];
+
+        // Fragment
+        fragment_attr   = path_parser(scan::query_chars);         // *(pchar | char_("/?"))
+        fragment        = '#' >> raw[fragment_attr][assign(phoenix::ref(it.fragment), qi::_1)];
+
+        // Request-URI
+        // An authority that fails part way (eg, "//joe@/x") may already
+        // have filled in user_info, so the other branches start by
+        // clearing it.
+        clear_authority = eps[phoenix::bind(&uri_t::clear_authority, phoenix::ref(it))];
+
+        hier_part       = omit["//"] >> cached_authority >> path_abempty[assign(phoenix::ref(it.path), qi::_1)]
+                        | clear_authority >>
+                          ( path_absolute[assign(phoenix::ref(it.path), qi::_1)]
+                          | path_rootless[assign(phoenix::ref(it.path), qi::_1)]
+                          | path_empty[assign(phoenix::ref(it.path), qi::_1)]
+                          )
+                        ;
+        abs_uri         = scheme >> hier_part >> -query >> -fragment;
+
+        relative_part   = omit["//"] >> cached_authority >> path_abempty[assign(phoenix::ref(it.path), qi::_1)]
+                        | clear_authority >>
+                          ( path_absolute[assign(phoenix::ref(it.path), qi::_1)]
+                          | path_noscheme[assign(phoenix::ref(it.path), qi::_1)]
+                          | path_empty[assign(phoenix::ref(it.path), qi::_1)]
+                          )
+                        ;
+        rel_uri         = relative_part >> -query >> -fragment;
+
+        // rel_uri for a target starting with a single "/", without its
+        // authority alternative.
+        origin_form     = clear_authority >> path_absolute[assign(phoenix::ref(it.path), qi::_1)] >> -query >> -fragment;
+
+        // entry: abs_uri | rel_uri | string("*"), dispatched on the first
+        // bytes so no alternative is tried and abandoned.
+        start           = detail::target_parser<Iterator>(abs_uri, origin_form, rel_uri) | string("*");
+
+
+        path_abempty.name("path_abempty");
+        path_absolute.name("path_absolute");
+        path_noscheme.name("path_noscheme");
+        path_rootless.name("path_rootless");
+        path_empty.name("path_empty");
+        hier_part.name("hier_part");
+
+        //qi::debug(hier_part);
+        //qi::debug(path_abempty);
+        //qi::debug(path_absolute);
+        //qi::debug(path_noscheme);
+        //qi::debug(path_rootless);
+        //qi::debug(path_empty);
+    }
+
+#ifdef SPIRIT_PARSERS_EXTERN_TEMPLATES
+    // Instantiated once in the spirit_parsers library, see src/uri_parser.cpp.
+    extern template struct uri_parser<const char *>;
+    extern template struct uri_parser<std::string::const_iterator>;
+#endif
 } // namespace uri
 
 #endif // __uri_parser_h__
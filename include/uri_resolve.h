@@ -0,0 +1,171 @@
+#ifndef __uri_resolve_h__
+#define __uri_resolve_h__
+
+#include "uri_parser.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace uri
+{
+    /**
+     * Implementation of remove_dot_segments, see RFC 3986 section 5.2.4.
+     *
+     * Works in place on buf starting at pos; anything before pos (eg, the
+     * scheme and authority of a URI being recomposed) is left untouched.
+     * The output of each step is never longer than the input it consumed, so
+     * no scratch buffer is needed.
+     */
+    inline void remove_dot_segments(std::string &buf, std::string::size_type pos = 0)
+    {
+        if (pos >= buf.size()) {
+            return;
+        }
+
+        char *base = &buf[pos];
+        char *in   = base;
+        char *end  = base + (buf.size() - pos);
+        char *out  = base;
+
+        while (in < end) {
+            std::size_t rem = end - in;
+
+            // A: "../" or "./" prefix
+            if (rem >= 3 && in[0] == '.' && in[1] == '.' && in[2] == '/') {
+                in += 3;
+            }
+            else if (rem >= 2 && in[0] == '.' && in[1] == '/') {
+                in += 2;
+            }
+            // B: "/./" or "/." at the end, replaced by "/"
+            else if (rem >= 3 && in[0] == '/' && in[1] == '.' && in[2] == '/') {
+                in += 2;
+            }
+            else if (rem == 2 && in[0] == '/' && in[1] == '.') {
+                in += 1;
+                in[0] = '/';
+            }
+            // C: "/../" or "/.." at the end, replaced by "/" and drop the last
+            // output segment along with its preceding "/"
+            else if ((rem >= 4 && in[0] == '/' && in[1] == '.' && in[2] == '.' && in[3] == '/')
+                  || (rem == 3 && in[0] == '/' && in[1] == '.' && in[2] == '.')) {
+                in += 2;
+                if (rem == 3) {
+                    in[0] = '/';
+                }
+                else {
+                    ++in;
+                }
+                while (out > base && out[-1] != '/') {
+                    --out;
+                }
+                if (out > base) {
+                    --out;
+                }
+            }
+            // D: "." or ".." on its own
+            else if ((rem == 1 && in[0] == '.') || (rem == 2 && in[0] == '.' && in[1] == '.')) {
+                in = end;
+            }
+            // E: move the first segment, with its leading "/" if any, to the output
+            else {
+                char *seg_end = std::find(in + (in[0] == '/' ? 1 : 0), end, '/');
+                std::memmove(out, in, seg_end - in);
+                out += seg_end - in;
+                in = seg_end;
+            }
+        }
+
+        buf.resize(pos + (out - base));
+    }
+
+    namespace detail
+    {
+        inline void append(std::string &out, boost::string_ref s)
+        {
+            out.append(s.data(), s.size());
+        }
+    } // namespace detail
+
+    /**
+     * Resolve the reference ref against base, see RFC 3986 section 5.2.2
+     * (strict), and write the recomposed target URI (section 5.3) into out.
+     *
+     * Only the raw parsed components are used, so escapes are carried over
+     * exactly as written and nothing is re-parsed. out is cleared first but
+     * keeps its capacity, so a caller resolving many references can reuse
+     * the same buffer without further allocations.
+     */
+    inline void resolve(const uri_t &base, const uri_t &ref, std::string &out)
+    {
+        out.clear();
+
+        const uri_t &scheme_src    = ref.scheme.defined() ? ref : base;
+        const uri_t &authority_src = (ref.scheme.defined() || ref.authority.defined()) ? ref : base;
+
+        if (scheme_src.scheme.defined()) {
+            detail::append(out, scheme_src.scheme.raw());
+            out += ':';
+        }
+        if (authority_src.authority.defined()) {
+            out += "//";
+            detail::append(out, authority_src.authority.raw());
+        }
+
+        std::string::size_type path_pos = out.size();
+        const uri_t *query_src = &ref;
+        boost::string_ref ref_path = ref.path.raw();
+        boost::string_ref base_path = base.path.raw();
+
+        if (ref.scheme.defined() || ref.authority.defined()) {
+            detail::append(out, ref_path);
+            remove_dot_segments(out, path_pos);
+        }
+        else if (ref_path.empty()) {
+            detail::append(out, base_path);
+            if (!ref.query.defined()) {
+                query_src = &base;
+            }
+        }
+        else if (ref_path[0] == '/') {
+            detail::append(out, ref_path);
+            remove_dot_segments(out, path_pos);
+        }
+        else {
+            // merge, see RFC 3986 section 5.2.3
+            if (base.authority.defined() && base_path.empty()) {
+                out += '/';
+            }
+            else {
+                boost::string_ref::size_type slash = base_path.rfind('/');
+                if (slash != boost::string_ref::npos) {
+                    detail::append(out, base_path.substr(0, slash + 1));
+                }
+            }
+            detail::append(out, ref_path);
+            remove_dot_segments(out, path_pos);
+        }
+
+        if (query_src->query.defined()) {
+            out += '?';
+            detail::append(out, query_src->query.raw());
+        }
+        if (ref.fragment.defined()) {
+            out += '#';
+            detail::append(out, ref.fragment.raw());
+        }
+    }
+
+    /**
+     * Convenience wrapper returning the resolved URI.
+     */
+    inline std::string resolve(const uri_t &base, const uri_t &ref)
+    {
+        std::string out;
+        resolve(base, ref, out);
+        return out;
+    }
+} // namespace uri
+
+#endif // __uri_resolve_h__
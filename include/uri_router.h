@@ -0,0 +1,258 @@
+#ifndef __uri_router_h__
+#define __uri_router_h__
+
+#include "uri.h"
+#include "uri_scan.h"
+
+#include <boost/utility/string_ref.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace uri
+{
+    /**
+     * Result of router::match: the route that matched, or -1, and the path
+     * segments captured by its {name} placeholders, in order. The captures
+     * point into the matched path, raw (still percent encoded).
+     */
+    struct route_match_t
+    {
+        enum { max_captures = 8 };
+
+        int route;
+        std::size_t captures;
+        boost::string_ref capture[max_captures];
+
+        route_match_t() : route(-1), captures(0) { }
+
+        bool matched() const { return route >= 0; }
+    };
+
+    /**
+     * Routes a path, eg uri_t::path, to one of a table of patterns such as
+     * "/users/{id}/posts/{slug}".
+     *
+     * A pattern is split into segments on '/' exactly as path_abempty /
+     * path_absolute split a path ('/' segment)*; each segment is either
+     * literal text, compared with the raw path segment, or a {name}
+     * placeholder matching any non-empty segment. The patterns are compiled
+     * into a trie of segments once, with add(); a match then looks at each
+     * byte of the path once (to split it) and walks the trie over the
+     * segments without allocating. A literal segment always wins over a
+     * placeholder: the walk never goes back, so "/users/me/posts/x" does not
+     * match "/users/{id}/posts/{slug}" once "/users/me" is routed. Each
+     * segment is looked at once whatever the table.
+     *
+     * Example:
+     *     uri::router routes;
+     *     int post = routes.add("/users/{id}/posts/{slug}");
+     *     uri::route_match_t m = routes.match(uri.path);
+     *     if (m.route == post) { show(m.capture[0], routes.capture(m, "slug")); }
+     */
+    class router
+    {
+    public:
+        enum { max_segments = 32 };  // longer paths never match
+
+        router() : nodes_(1) { }
+
+        /**
+         * Add a pattern, returning its route number, or -1 when the pattern
+         * is malformed (not starting with '/', a segment that is not pchar*,
+         * more than max_captures placeholders) or is already routed.
+         */
+        int add(const std::string &pattern)
+        {
+            if (pattern.empty() || pattern[0] != '/') {
+                return -1;
+            }
+
+            std::vector<std::string> names;
+            std::size_t node = 0;
+            std::size_t first = 1;
+            for (;;) {
+                std::size_t last = pattern.find('/', first);
+                if (last == std::string::npos) {
+                    last = pattern.size();
+                }
+                boost::string_ref segment(pattern.data() + first, last - first);
+
+                if (segment.size() > 2 && segment.front() == '{' && segment.back() == '}') {
+                    if (names.size() == route_match_t::max_captures) {
+                        return -1;
+                    }
+                    names.push_back(std::string(segment.data() + 1, segment.size() - 2));
+                    if (nodes_[node].param < 0) {
+                        nodes_[node].param = new_node();
+                    }
+                    node = nodes_[node].param;
+                }
+                else {
+                    if (!valid_segment(segment)) {
+                        return -1;
+                    }
+                    node = literal_child(node, segment);
+                }
+
+                if (last == pattern.size()) {
+                    break;
+                }
+                first = last + 1;
+            }
+
+            if (nodes_[node].route >= 0) {
+                return -1;
+            }
+            nodes_[node].route = static_cast<int>(names_.size());
+            names_.push_back(names);
+            return nodes_[node].route;
+        }
+
+        std::size_t size() const { return names_.size(); }
+
+        /**
+         * The placeholder names of route, in capture order.
+         */
+        const std::vector<std::string> &captures(int route) const { return names_[route]; }
+
+        /**
+         * The segment captured by the placeholder name, empty when the route
+         * has no such placeholder.
+         */
+        boost::string_ref capture(const route_match_t &m, boost::string_ref name) const
+        {
+            if (!m.matched()) {
+                return boost::string_ref();
+            }
+            const std::vector<std::string> &names = names_[m.route];
+            for (std::size_t i = 0; i < names.size(); ++i) {
+                if (name == names[i]) {
+                    return m.capture[i];
+                }
+            }
+            return boost::string_ref();
+        }
+
+        /**
+         * Match a raw path. An empty path (eg "http://host") is taken as
+         * "/".
+         */
+        route_match_t match(boost::string_ref path) const
+        {
+            route_match_t m;
+            if (path.empty()) {
+                path = boost::string_ref("/", 1);
+            }
+            if (path[0] != '/') {
+                return m;
+            }
+
+            // Split once, then walk the trie a segment at a time.
+            boost::string_ref segments[max_segments];
+            std::size_t count = 0;
+            const char *cur = path.data() + 1;
+            const char *last = path.data() + path.size();
+            for (;;) {
+                const char *slash = static_cast<const char *>(std::memchr(cur, '/', last - cur));
+                const char *end = slash ? slash : last;
+                if (count == max_segments) {
+                    return m;
+                }
+                segments[count++] = boost::string_ref(cur, end - cur);
+                if (!slash) {
+                    break;
+                }
+                cur = slash + 1;
+            }
+
+            walk(0, segments, count, m);
+            return m;
+        }
+
+        route_match_t match(const component_t &path) const
+        {
+            return match(path.raw());
+        }
+
+    private:
+        struct edge_t
+        {
+            std::string segment;
+            std::size_t child;
+
+            bool operator<(boost::string_ref s) const { return boost::string_ref(segment) < s; }
+        };
+
+        struct node_t
+        {
+            std::vector<edge_t> literals;  // sorted by segment
+            int param;                     // child for {name}, or -1
+            int route;                     // route ending here, or -1
+
+            node_t() : param(-1), route(-1) { }
+        };
+
+        // pchar*, as uri_parser's segment matches it.
+        static bool valid_segment(boost::string_ref s)
+        {
+            return scan::run(s.begin(), s.end(), scan::pchar_class) == s.end();
+        }
+
+        int new_node()
+        {
+            nodes_.push_back(node_t());
+            return static_cast<int>(nodes_.size() - 1);
+        }
+
+        std::size_t literal_child(std::size_t node, boost::string_ref segment)
+        {
+            std::vector<edge_t> &edges = nodes_[node].literals;
+            std::vector<edge_t>::iterator i = std::lower_bound(edges.begin(), edges.end(), segment);
+            if (i != edges.end() && i->segment == segment) {
+                return i->child;
+            }
+            std::size_t pos = i - edges.begin();
+
+            edge_t edge;
+            edge.segment.assign(segment.data(), segment.size());
+            edge.child = new_node();
+            // new_node() may have moved nodes_, so look the edges up again.
+            std::vector<edge_t> &moved = nodes_[node].literals;
+            moved.insert(moved.begin() + pos, edge);
+            return edge.child;
+        }
+
+        void walk(std::size_t node, const boost::string_ref *segments, std::size_t count, route_match_t &m) const
+        {
+            for (std::size_t i = 0; i < count; ++i) {
+                const node_t &n = nodes_[node];
+                const std::vector<edge_t> &edges = n.literals;
+                std::vector<edge_t>::const_iterator e = std::lower_bound(edges.begin(), edges.end(), segments[i]);
+                if (e != edges.end() && boost::string_ref(e->segment) == segments[i]) {
+                    node = e->child;
+                }
+                else if (n.param >= 0 && !segments[i].empty()) {
+                    m.capture[m.captures++] = segments[i];
+                    node = n.param;
+                }
+                else {
+                    m.captures = 0;
+                    return;
+                }
+            }
+            m.route = nodes_[node].route;
+            if (m.route < 0) {
+                m.captures = 0;
+            }
+        }
+
+        std::vector<node_t> nodes_;
+        std::vector<std::vector<std::string> > names_;
+    };
+} // namespace uri
+
+#endif // __uri_router_h__
@@ -0,0 +1,194 @@
+#ifndef __uri_scan_h__
+#define __uri_scan_h__
+
+#include <boost/spirit/include/qi.hpp>
+
+namespace uri
+{
+    namespace qi = boost::spirit::qi;
+
+    /**
+     * Scanners behind the URI grammar's path, query and fragment rules. They
+     * match exactly what the Spirit expressions noted on each match, one
+     * table lookup per byte instead of a rule call per character.
+     */
+    namespace scan
+    {
+        enum char_class_t
+        {
+            pchar_nc_class = 1,  // unreserved / sub-delims / '@'
+            colon_class    = 2,
+            slash_class    = 4,
+            question_class = 8,
+            hex_class      = 16,
+
+            pchar_class    = pchar_nc_class | colon_class
+        };
+
+        struct char_classes
+        {
+            unsigned char c[256];
+
+            constexpr char_classes() : c()
+            {
+                for (int i = 0; i < 256; ++i) {
+                    bool alpha = (i >= 'a' && i <= 'z') || (i >= 'A' && i <= 'Z');
+                    bool digit = i >= '0' && i <= '9';
+                    bool mark = i == '-' || i == '.' || i == '_' || i == '~';
+                    bool sub_delim = i == '!' || i == '$' || i == '&' || i == '\'' || i == '(' || i == ')'
+                                  || i == '*' || i == '+' || i == ',' || i == ';' || i == '=';
+                    c[i] = (alpha || digit || mark || sub_delim || i == '@' ? pchar_nc_class : 0)
+                         | (i == ':' ? colon_class : 0)
+                         | (i == '/' ? slash_class : 0)
+                         | (i == '?' ? question_class : 0)
+                         | (digit || (i >= 'a' && i <= 'f') || (i >= 'A' && i <= 'F') ? hex_class : 0);
+                }
+            }
+        };
+
+        inline unsigned char_class(char c)
+        {
+            static constexpr char_classes table;
+            return table.c[static_cast<unsigned char>(c)];
+        }
+
+        /**
+         * End of the longest run, starting at first, of characters in the
+         * classes of mask and of percent encoded characters ('%' HEXDIG
+         * HEXDIG).
+         */
+        template <typename Iterator>
+        Iterator run(Iterator first, Iterator last, unsigned mask)
+        {
+            while (first != last) {
+                unsigned cls = char_class(*first);
+                if (cls & mask) {
+                    ++first;
+                    continue;
+                }
+                if (*first != '%') {
+                    break;
+                }
+                Iterator cur = first;
+                if (++cur == last || !(char_class(*cur) & hex_class) || ++cur == last || !(char_class(*cur) & hex_class)) {
+                    break;
+                }
+                first = ++cur;
+            }
+            return first;
+        }
+
+        enum path_kind_t
+        {
+            path_abempty,   // *( "/" segment )
+            path_absolute,  // "/" [ segment-nz *( "/" segment ) ]
+            path_noscheme,  // segment-nz-nc *( "/" segment )
+            path_rootless,  // segment-nz *( "/" segment )
+            query_chars     // *( pchar / "/" / "?" ), a query or fragment
+        };
+
+        /**
+         * Match kind at first, moving first past it.
+         */
+        template <typename Iterator>
+        bool path(Iterator &first, Iterator last, path_kind_t kind)
+        {
+            const unsigned segments = pchar_class | slash_class;
+            Iterator cur = first;
+            Iterator end;
+
+            switch (kind) {
+            case path_abempty:
+                if (cur != last && *cur == '/') {
+                    first = run(cur, last, segments);
+                }
+                return true;
+
+            case path_absolute:
+                if (cur == last || *cur != '/') {
+                    return false;
+                }
+                ++cur;
+                end = run(cur, last, pchar_class);
+                first = end == cur ? cur : run(end, last, segments);
+                return true;
+
+            case path_noscheme:
+                end = run(cur, last, pchar_nc_class);
+                if (end == cur) {
+                    return false;
+                }
+                first = end != last && *end == '/' ? run(end, last, segments) : end;
+                return true;
+
+            case path_rootless:
+                end = run(cur, last, pchar_class);
+                if (end == cur) {
+                    return false;
+                }
+                first = run(end, last, segments);
+                return true;
+
+            case query_chars:
+                first = run(cur, last, segments | question_class);
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * Whether [first, last) starts with scheme ":", scheme being
+         * ALPHA *( ALPHA / DIGIT / "+" / "-" / "." ).
+         */
+        template <typename Iterator>
+        bool scheme_follows(Iterator first, Iterator last)
+        {
+            if (first == last || !((*first >= 'a' && *first <= 'z') || (*first >= 'A' && *first <= 'Z'))) {
+                return false;
+            }
+            for (++first; first != last; ++first) {
+                char c = *first;
+                if (c == ':') {
+                    return true;
+                }
+                if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                      || c == '+' || c == '-' || c == '.')) {
+                    return false;
+                }
+            }
+            return false;
+        }
+    } // namespace scan
+
+    /**
+     * Parser for one of the path forms, or a query / fragment, run by
+     * scan::path. No attribute; wrap it in raw[] for the matched range.
+     */
+    struct path_parser : qi::primitive_parser<path_parser>
+    {
+        template <typename Context, typename Iterator>
+        struct attribute
+        {
+            typedef boost::spirit::unused_type type;
+        };
+
+        explicit path_parser(scan::path_kind_t kind) : kind(kind) { }
+
+        template <typename Iterator, typename Context, typename Skipper, typename Attribute>
+        bool parse(Iterator &first, Iterator const &last, Context &, Skipper const &skipper, Attribute &) const
+        {
+            qi::skip_over(first, last, skipper);
+            return scan::path(first, last, kind);
+        }
+
+        template <typename Context>
+        boost::spirit::info what(Context &) const
+        {
+            return boost::spirit::info("path");
+        }
+
+        scan::path_kind_t kind;
+    };
+} // namespace uri
+
+#endif // __uri_scan_h__
@@ -0,0 +1,241 @@
+#ifndef __uri_writer_h__
+#define __uri_writer_h__
+
+#include "uri.h"
+
+#include <boost/utility/string_ref.hpp>
+
+#include <cstddef>
+#include <cstring>
+
+#include <sys/uio.h>
+
+namespace uri
+{
+    /**
+     * Writers take the output of write() below a piece at a time, without
+     * allocating. A writer provides
+     *
+     *     void piece(const char *p, std::size_t n);      // bytes to output
+     *     void separator(const char *s, std::size_t n);  // a literal, eg "://"
+     *     void number(unsigned v);                       // in decimal
+     *
+     * buffer_writer copies into a caller buffer, iovec_writer only points
+     * iovecs at the pieces, ready for writev(2).
+     */
+
+    /**
+     * Writer copying into [first, first + size). When the output does not
+     * fit, writing carries on counting, so size() says how much room is
+     * needed.
+     */
+    class buffer_writer
+    {
+    public:
+        buffer_writer(char *first, std::size_t size) :
+            first_(first), capacity_(size), size_(0)
+        { }
+
+        void piece(const char *p, std::size_t n)
+        {
+            if (size_ + n <= capacity_) {
+                std::memcpy(first_ + size_, p, n);
+            }
+            size_ += n;
+        }
+
+        void separator(const char *s, std::size_t n)
+        {
+            piece(s, n);
+        }
+
+        void number(unsigned v)
+        {
+            char digits[16];
+            char *p = digits + sizeof(digits);
+            do {
+                *--p = static_cast<char>('0' + v % 10);
+                v /= 10;
+            } while (v);
+            piece(p, digits + sizeof(digits) - p);
+        }
+
+        const char *data() const { return first_; }
+
+        /**
+         * Bytes written, or needed when overflow().
+         */
+        std::size_t size() const { return size_; }
+
+        bool overflow() const { return size_ > capacity_; }
+
+    private:
+        char *first_;
+        std::size_t capacity_;
+        std::size_t size_;
+    };
+
+    /**
+     * Writer filling an iovec array for writev(2); no byte is copied.
+     *
+     * Pieces that follow each other in memory share an iovec. When given
+     * the source buffer the components were parsed from, a separator that
+     * is also the next byte of that buffer extends the previous iovec
+     * instead of pointing at a literal, so an unmodified URI or request
+     * line comes out as a single iovec over the original input.
+     *
+     * The iovecs point at the components, the separators (string literals)
+     * and, for number(), at a small buffer inside the writer: all of these
+     * must outlive the writev.
+     */
+    class iovec_writer
+    {
+    public:
+        enum { scratch_size = 32 };  // room for number()
+
+        iovec_writer(iovec *iov, std::size_t count, const char *source_first = 0, const char *source_last = 0) :
+            iov_(iov), capacity_(count), count_(0), size_(0), scratch_used_(0),
+            last_end_(0), source_first_(source_first), source_last_(source_last), overflow_(false)
+        { }
+
+        iovec_writer(const iovec_writer &) = delete;
+        iovec_writer &operator=(const iovec_writer &) = delete;
+
+        void piece(const char *p, std::size_t n)
+        {
+            if (n == 0) {
+                return;
+            }
+            size_ += n;
+            if (count_ && last_end_ == p) {
+                if (count_ <= capacity_) {
+                    iov_[count_ - 1].iov_len += n;
+                }
+                last_end_ = p + n;
+                return;
+            }
+            last_end_ = p + n;
+            if (++count_ > capacity_) {
+                overflow_ = true;
+                return;
+            }
+            iov_[count_ - 1].iov_base = const_cast<char *>(p);
+            iov_[count_ - 1].iov_len = n;
+        }
+
+        void separator(const char *s, std::size_t n)
+        {
+            const char *e = last_end_;
+            if (e && e >= source_first_ && e < source_last_
+                && static_cast<std::size_t>(source_last_ - e) >= n && std::memcmp(e, s, n) == 0) {
+                piece(e, n);
+            }
+            else {
+                piece(s, n);
+            }
+        }
+
+        void number(unsigned v)
+        {
+            char digits[16];
+            char *p = digits + sizeof(digits);
+            do {
+                *--p = static_cast<char>('0' + v % 10);
+                v /= 10;
+            } while (v);
+
+            std::size_t n = digits + sizeof(digits) - p;
+            if (scratch_used_ + n > scratch_size) {
+                // Still counted, as an iovec of its own.
+                size_ += n;
+                ++count_;
+                last_end_ = 0;
+                overflow_ = true;
+                return;
+            }
+            char *out = scratch_ + scratch_used_;
+            std::memcpy(out, p, n);
+            scratch_used_ += n;
+            piece(out, n);
+        }
+
+        /**
+         * iovecs used, or needed when overflow().
+         */
+        std::size_t count() const { return count_; }
+
+        /**
+         * Total bytes the iovecs cover.
+         */
+        std::size_t size() const { return size_; }
+
+        bool overflow() const { return overflow_; }
+
+    private:
+        iovec *iov_;
+        std::size_t capacity_;
+        std::size_t count_;
+        std::size_t size_;
+        char scratch_[scratch_size];
+        std::size_t scratch_used_;
+        const char *last_end_;  // end of the last piece, stored or not
+        const char *source_first_;
+        const char *source_last_;
+        bool overflow_;
+    };
+
+    namespace detail
+    {
+        template <typename Writer>
+        void write_raw(Writer &out, const component_t &c)
+        {
+            boost::string_ref raw = c.raw();
+            out.piece(raw.data(), raw.size());
+        }
+    } // namespace detail
+
+    /**
+     * Recompose it (RFC 3986 section 5.3) from its raw components, so
+     * escapes come out exactly as parsed. The authority is written from
+     * user_info, host and port, so replacing any of those is enough to
+     * change it; IP literal hosts get their brackets back.
+     */
+    template <typename Writer>
+    void write(Writer &out, const uri_t &it)
+    {
+        if (it.scheme.defined()) {
+            detail::write_raw(out, it.scheme);
+            out.separator(":", 1);
+        }
+        if (it.authority.defined() || it.host.defined()) {
+            out.separator("//", 2);
+            if (it.user_info.defined()) {
+                detail::write_raw(out, it.user_info);
+                out.separator("@", 1);
+            }
+            bool literal = it.host_kind == host_ipv6 || it.host_kind == host_ipv_future;
+            if (literal) {
+                out.separator("[", 1);
+            }
+            detail::write_raw(out, it.host);
+            if (literal) {
+                out.separator("]", 1);
+            }
+            if (it.port.defined()) {
+                out.separator(":", 1);
+                detail::write_raw(out, it.port);
+            }
+        }
+        detail::write_raw(out, it.path);
+        if (it.query.defined()) {
+            out.separator("?", 1);
+            detail::write_raw(out, it.query);
+        }
+        if (it.fragment.defined()) {
+            out.separator("#", 1);
+            detail::write_raw(out, it.fragment);
+        }
+    }
+} // namespace uri
+
+#endif // __uri_writer_h__
@@ -0,0 +1,7 @@
+#include "ipv4_address.h"
+
+namespace uri
+{
+    template struct ipv4_address<const char *>;
+    template struct ipv4_address<std::string::const_iterator>;
+} // namespace uri
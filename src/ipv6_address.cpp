@@ -0,0 +1,7 @@
+#include "ipv6_address.h"
+
+namespace uri
+{
+    template struct ipv6_address<const char *>;
+    template struct ipv6_address<std::string::const_iterator>;
+} // namespace uri
@@ -0,0 +1,7 @@
+#include "percent_encoded_char.h"
+
+namespace uri
+{
+    template struct percent_encoded_char<const char *>;
+    template struct percent_encoded_char<std::string::const_iterator>;
+} // namespace uri
@@ -0,0 +1,7 @@
+#include "http11_parser.h"
+
+namespace http11
+{
+    template struct request_parser<const char *>;
+    template struct request_parser<std::string::const_iterator>;
+} // namespace http11
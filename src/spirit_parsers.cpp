@@ -0,0 +1,110 @@
+#include "spirit_parsers.h"
+#include "http11_parser.h"
+
+namespace
+{
+    namespace qi = boost::spirit::qi;
+
+    // The grammars write through a reference bound at construction, so each
+    // thread keeps one grammar per iterator type together with the object it
+    // fills. Building a grammar is far more expensive than a parse.
+    template <typename Iterator>
+    struct uri_context
+    {
+        uri::uri_t result;
+        uri::uri_parser<Iterator> grammar;
+
+        uri_context() : grammar(result) { }
+    };
+
+    template <typename Iterator>
+    struct request_context
+    {
+        http11::request_t result;
+        http11::request_parser<Iterator> grammar;
+
+        request_context() : grammar(result) { }
+    };
+
+    template <typename Iterator>
+    bool parse_uri(Iterator &first, Iterator last, uri::uri_t &out)
+    {
+        static thread_local uri_context<Iterator> ctx;
+
+        ctx.result.clear();
+        if (!qi::parse(first, last, ctx.grammar)) {
+            return false;
+        }
+        out = ctx.result;
+        return true;
+    }
+
+    template <typename Iterator>
+    bool parse_request(Iterator &first, Iterator last, http11::request_t &out)
+    {
+        static thread_local request_context<Iterator> ctx;
+
+        // Take over the caller's buffers so their capacity is reused.
+        std::swap(ctx.result, out);
+        ctx.result.clear();
+
+        bool pass = qi::parse(first, last, ctx.grammar);
+        std::swap(ctx.result, out);
+        return pass;
+    }
+
+    template <template <typename> class Grammar, typename Iterator>
+    bool parse_address(Iterator &first, Iterator last, std::string &out)
+    {
+        static thread_local Grammar<Iterator> grammar;
+
+        out.clear();
+        return qi::parse(first, last, grammar, out);
+    }
+} // namespace
+
+namespace uri
+{
+    bool parse_uri(const char *&first, const char *last, uri_t &out)
+    {
+        return ::parse_uri(first, last, out);
+    }
+
+    bool parse_uri(std::string::const_iterator &first, std::string::const_iterator last, uri_t &out)
+    {
+        return ::parse_uri(first, last, out);
+    }
+
+    bool parse_ipv4_address(const char *&first, const char *last, std::string &out)
+    {
+        return parse_address<ipv4_address>(first, last, out);
+    }
+
+    bool parse_ipv4_address(std::string::const_iterator &first, std::string::const_iterator last, std::string &out)
+    {
+        return parse_address<ipv4_address>(first, last, out);
+    }
+
+    bool parse_ipv6_address(const char *&first, const char *last, std::string &out)
+    {
+        return parse_address<ipv6_address>(first, last, out);
+    }
+
+    bool parse_ipv6_address(std::string::const_iterator &first, std::string::const_iterator last, std::string &out)
+    {
+        return parse_address<ipv6_address>(first, last, out);
+    }
+} // namespace uri
+
+namespace http11
+{
+    bool parse_request(const char *&first, const char *last, request_t &out)
+    {
+        return ::parse_request(first, last, out);
+    }
+
+    bool parse_request(std::string::const_iterator &first, std::string::const_iterator last, request_t &out)
+    {
+        return ::parse_request(first, last, out);
+    }
+} // namespace http11
@@ -0,0 +1,7 @@
+#include "uri_parser.h"
+
+namespace uri
+{
+    template struct uri_parser<const char *>;
+    template struct uri_parser<std::string::const_iterator>;
+} // namespace uri
@@ -0,0 +1,13 @@
+#ifndef __alloc_counter_h__
+#define __alloc_counter_h__
+
+#include <cstddef>
+
+/**
+ * Every allocation the program has made, counted by the replacement
+ * operator new and operator delete of alloc_counter.cpp; link that into
+ * the test to use this.
+ */
+extern std::size_t allocations;
+
+#endif // __alloc_counter_h__
@@ -0,0 +1,179 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "uri_parser.h"
+
+#include <cstdio>
+#include <list>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+// uri_t refers to the parsed text, keep every input alive for the checks
+const std::string &keep(const char *test)
+{
+    static std::list<std::string> inputs;
+    inputs.push_back(test);
+    return inputs.back();
+}
+
+bool P(uri::uri_t &uri, uri::authority_cache *cache, const char *test)
+{
+    using boost::spirit::qi::parse;
+
+    const std::string &input = keep(test);
+    std::string::const_iterator begin = input.begin();
+
+    uri = uri::uri_t();
+    uri::uri_parser<std::string::const_iterator> grammar(uri, cache);
+    bool pass = parse(begin, input.end(), grammar) && begin == input.end();
+
+    std::cerr << "TEST: |" << test << "| " << uri.to_string() << std::endl;
+    return pass;
+}
+
+// Parse test with and without the cache and check both agree.
+void same(uri::authority_cache &cache, const char *test)
+{
+    uri::uri_t plain, cached;
+    BOOST_CHECK(P(plain, 0, test) == P(cached, &cache, test));
+
+    BOOST_CHECK(plain.authority.defined() == cached.authority.defined());
+    BOOST_CHECK(plain.authority.raw() == cached.authority.raw());
+    BOOST_CHECK(plain.user_info.defined() == cached.user_info.defined());
+    BOOST_CHECK(plain.user_info.raw() == cached.user_info.raw());
+    BOOST_CHECK(plain.host.defined() == cached.host.defined());
+    BOOST_CHECK(plain.host.raw() == cached.host.raw());
+    BOOST_CHECK(plain.port.defined() == cached.port.defined());
+    BOOST_CHECK(plain.port.raw() == cached.port.raw());
+    BOOST_CHECK(plain.host_kind == cached.host_kind);
+    BOOST_CHECK(plain.path.raw() == cached.path.raw());
+}
+
+BOOST_AUTO_TEST_CASE(repeated_authorities_hit)
+{
+    uri::authority_cache cache(16);
+    uri::uri_t uri;
+
+    BOOST_CHECK(true == P(uri, &cache, "http://user@makefile.com:8080/a"));
+    BOOST_CHECK(0 == cache.hits());
+    BOOST_CHECK(1 == cache.misses());
+
+    BOOST_CHECK(true == P(uri, &cache, "http://user@makefile.com:8080/b?q"));
+    BOOST_CHECK(1 == cache.hits());
+    BOOST_CHECK(1 == cache.misses());
+
+    // The components point into the new input.
+    BOOST_CHECK("user" == uri.user_info);
+    BOOST_CHECK("makefile.com" == uri.host);
+    BOOST_CHECK("8080" == uri.port);
+    BOOST_CHECK("/b" == uri.path);
+    BOOST_CHECK(uri::host_reg_name == uri.host_kind);
+
+    BOOST_CHECK(true == P(uri, &cache, "//user@makefile.com:8080"));
+    BOOST_CHECK(2 == cache.hits());
+
+    cache.reset_counters();
+    BOOST_CHECK(0 == cache.hits());
+    BOOST_CHECK(0 == cache.misses());
+}
+
+BOOST_AUTO_TEST_CASE(host_kinds)
+{
+    uri::authority_cache cache(16);
+    uri::uri_t uri;
+
+    const char *tests[] = {
+        "http://192.168.0.1/",
+        "http://[fe80::1]:80/",
+        "http://[v1.x]/",
+        "http://makefile.com/",
+    };
+    uri::host_kind_t kinds[] = { uri::host_ipv4, uri::host_ipv6, uri::host_ipv_future, uri::host_reg_name };
+
+    for (int round = 0; round < 2; ++round) {
+        for (std::size_t i = 0; i < 4; ++i) {
+            BOOST_CHECK(true == P(uri, &cache, tests[i]));
+            BOOST_CHECK(kinds[i] == uri.host_kind);
+        }
+    }
+    BOOST_CHECK(4 == cache.hits());
+    BOOST_CHECK(4 == cache.misses());
+
+    BOOST_CHECK(true == P(uri, &cache, "/no/authority"));
+    BOOST_CHECK(uri::host_none == uri.host_kind);
+}
+
+BOOST_AUTO_TEST_CASE(cached_matches_uncached)
+{
+    uri::authority_cache cache(16);
+
+    const char *tests[] = {
+        "http://makefile.com",
+        "http://makefile.com:",
+        "http://@makefile.com",
+        "http://us%65r:pw@makefile.com:443/x",
+        "http://[::1]:8080/",
+        "http://1.2.3.4:80/",
+        "http:///no/host",
+        "http://joe@/x",
+        "//makefile.com?q#f",
+    };
+
+    for (int round = 0; round < 3; ++round) {
+        for (std::size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); ++i) {
+            same(cache, tests[i]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(uncacheable_authorities)
+{
+    uri::authority_cache cache(16);
+    uri::uri_t uri;
+
+    // Longer than max_key.
+    std::string host(uri::authority_cache::max_key + 1, 'h');
+    std::string long_uri = "http://" + host + "/";
+    BOOST_CHECK(true == P(uri, &cache, long_uri.c_str()));
+    BOOST_CHECK(true == P(uri, &cache, long_uri.c_str()));
+    BOOST_CHECK(0 == cache.hits());
+    BOOST_CHECK(0 == cache.misses());
+    BOOST_CHECK(host == uri.host);
+
+    // The grammar stops before the end of the authority characters ("]"
+    // cannot follow a reg_name), so nothing is cached and the second parse
+    // runs the grammar again.
+    P(uri, &cache, "http://a]b/");
+    P(uri, &cache, "http://a]b/");
+    BOOST_CHECK(0 == cache.hits());
+    BOOST_CHECK(2 == cache.misses());
+}
+
+BOOST_AUTO_TEST_CASE(bounded)
+{
+    uri::authority_cache cache(8);
+    BOOST_CHECK(8 == cache.size());
+
+    uri::uri_t uri;
+    char test[64];
+    for (int i = 0; i < 100; ++i) {
+        std::sprintf(test, "http://host%d.makefile.com/", i);
+        BOOST_CHECK(true == P(uri, &cache, test));
+    }
+    BOOST_CHECK(100 == cache.misses());
+
+    // At most eight of them can still be there.
+    cache.reset_counters();
+    for (int i = 0; i < 100; ++i) {
+        std::sprintf(test, "http://host%d.makefile.com/", i);
+        BOOST_CHECK(true == P(uri, &cache, test));
+    }
+    BOOST_CHECK(cache.hits() <= 8);
+
+    cache.clear();
+    cache.reset_counters();
+    BOOST_CHECK(true == P(uri, &cache, "http://host1.makefile.com/"));
+    BOOST_CHECK(0 == cache.hits());
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,184 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "byte_range.h"
+#include "alloc_counter.h"
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+using http11::byte_range_t;
+using http11::byte_ranges_t;
+
+const uint64_t open_end = byte_range_t::open;
+
+bool P(const std::string &test, byte_ranges_t &out, std::size_t max_ranges = 16)
+{
+    bool result = http11::parse_byte_ranges(test, out, max_ranges);
+    std::cerr << "TEST: |" << test << "| " << (result ? "valid" : "invalid") << std::endl;
+    return result;
+}
+
+bool P(const std::string &test)
+{
+    byte_ranges_t out;
+    return P(test, out);
+}
+
+bool is(const byte_range_t &range, uint64_t first, uint64_t last)
+{
+    return range.first == first && range.last == last;
+}
+
+BOOST_AUTO_TEST_CASE(ranges)
+{
+    byte_ranges_t r;
+    BOOST_CHECK(true == P("bytes=0-1023,2048-", r));
+    BOOST_CHECK(2 == r.size());
+    BOOST_CHECK(is(r[0], 0, 1023));
+    BOOST_CHECK(is(r[1], 2048, open_end));
+    BOOST_CHECK(false == r[1].suffix());
+
+    BOOST_CHECK(true == P("bytes=-500", r));
+    BOOST_CHECK(1 == r.size());
+    BOOST_CHECK(true == r[0].suffix());
+    BOOST_CHECK(500 == r[0].last);
+
+    // RFC 7233 section 2.1 examples
+    BOOST_CHECK(true == P("bytes=500-600,601-999", r));
+    BOOST_CHECK(2 == r.size());
+    BOOST_CHECK(true == P("bytes=500-700,601-999", r));
+    BOOST_CHECK(true == P("bytes=9500-", r));
+    BOOST_CHECK(true == P("bytes=0-0,-1", r));
+    BOOST_CHECK(2 == r.size());
+
+    // list whitespace, empty elements, unit case, trailing whitespace
+    BOOST_CHECK(true == P("Bytes=, ,0-1 ,\t2-3,,  -4, ", r));
+    BOOST_CHECK(3 == r.size());
+    BOOST_CHECK(is(r[0], 0, 1));
+    BOOST_CHECK(is(r[1], 2, 3));
+    BOOST_CHECK(is(r[2], open_end, 4));
+
+    BOOST_CHECK(true == P("bytes=18446744073709551614-18446744073709551615", r));
+    BOOST_CHECK(is(r[0], 18446744073709551614ULL, 18446744073709551615ULL));
+}
+
+BOOST_AUTO_TEST_CASE(invalid)
+{
+    BOOST_CHECK(false == P(""));
+    BOOST_CHECK(false == P("bytes="));
+    BOOST_CHECK(false == P("bytes=,"));
+    BOOST_CHECK(false == P("bytes 0-1"));
+    BOOST_CHECK(false == P("bytes =0-1"));
+    BOOST_CHECK(false == P("bytes= 0-1"));
+    BOOST_CHECK(false == P("items=0-1"));
+    BOOST_CHECK(false == P("bytes=-"));
+    BOOST_CHECK(false == P("bytes=1"));
+    BOOST_CHECK(false == P("bytes=1-0"));
+    BOOST_CHECK(false == P("bytes=0-1;2-3"));
+    BOOST_CHECK(false == P("bytes=0-1 2-3"));
+    BOOST_CHECK(false == P("bytes=0-1, x"));
+    BOOST_CHECK(false == P("bytes=-1-2"));
+    BOOST_CHECK(false == P("bytes=+1-2"));
+
+    // overflow
+    BOOST_CHECK(false == P("bytes=18446744073709551616-"));
+    BOOST_CHECK(false == P("bytes=0-18446744073709551616"));
+    BOOST_CHECK(false == P("bytes=-99999999999999999999"));
+    BOOST_CHECK(false == P("bytes=18446744073709551615-"));
+}
+
+BOOST_AUTO_TEST_CASE(max_ranges)
+{
+    byte_ranges_t r;
+    std::string value = "bytes=0-0";
+    for (int i = 1; i < 16; ++i) {
+        value += "," + std::to_string(i * 2) + "-" + std::to_string(i * 2);
+    }
+    BOOST_CHECK(true == P(value, r));
+    BOOST_CHECK(16 == r.size());
+    BOOST_CHECK(false == P(value + ",-1", r));
+    BOOST_CHECK(false == P(value, r, 15));
+    BOOST_CHECK(true == P("bytes=0-1,-1", r, 2));
+    BOOST_CHECK(false == P("bytes=0-1,-1,5-", r, 2));
+}
+
+BOOST_AUTO_TEST_CASE(resolve)
+{
+    byte_ranges_t r;
+    BOOST_CHECK(true == P("bytes=0-1023,2048-", r));
+    BOOST_CHECK(true == r.resolve(10000));
+    BOOST_CHECK(2 == r.size());
+    BOOST_CHECK(is(r[0], 0, 1023));
+    BOOST_CHECK(is(r[1], 2048, 9999));
+    BOOST_CHECK(7952 == r[1].size());
+
+    // suffixes, clipping
+    BOOST_CHECK(true == P("bytes=-500", r));
+    BOOST_CHECK(true == r.resolve(10000));
+    BOOST_CHECK(is(r[0], 9500, 9999));
+    BOOST_CHECK(true == P("bytes=-500", r));
+    BOOST_CHECK(true == r.resolve(100));
+    BOOST_CHECK(is(r[0], 0, 99));
+    BOOST_CHECK(true == P("bytes=50-5000", r));
+    BOOST_CHECK(true == r.resolve(100));
+    BOOST_CHECK(is(r[0], 50, 99));
+
+    // unsatisfiable ranges are dropped; none left is a 416
+    BOOST_CHECK(true == P("bytes=100-200,-0,5-9", r));
+    BOOST_CHECK(true == r.resolve(100));
+    BOOST_CHECK(1 == r.size());
+    BOOST_CHECK(is(r[0], 5, 9));
+    BOOST_CHECK(true == P("bytes=100-200,-0", r));
+    BOOST_CHECK(false == r.resolve(100));
+    BOOST_CHECK(true == r.empty());
+    BOOST_CHECK(true == P("bytes=-5", r));
+    BOOST_CHECK(false == r.resolve(0));
+
+    // overlapping and adjacent ranges coalesce, in any order
+    BOOST_CHECK(true == P("bytes=500-700,601-999,0-99,100-199,-10,300-399", r));
+    BOOST_CHECK(true == r.resolve(10000));
+    BOOST_CHECK(4 == r.size());
+    BOOST_CHECK(is(r[0], 0, 199));
+    BOOST_CHECK(is(r[1], 300, 399));
+    BOOST_CHECK(is(r[2], 500, 999));
+    BOOST_CHECK(is(r[3], 9990, 9999));
+
+    // and so do ranges closer than gap
+    BOOST_CHECK(true == P("bytes=0-99,180-199,300-399", r));
+    BOOST_CHECK(true == r.resolve(1000, 81));
+    BOOST_CHECK(2 == r.size());
+    BOOST_CHECK(is(r[0], 0, 199));
+    BOOST_CHECK(is(r[1], 300, 399));
+
+    // a hostile request for the same bytes over and over is one range
+    std::string value = "bytes=0-";
+    for (int i = 0; i < 15; ++i) {
+        value += ",0-";
+    }
+    BOOST_CHECK(true == P(value, r));
+    BOOST_CHECK(true == r.resolve(1 << 30));
+    BOOST_CHECK(1 == r.size());
+    BOOST_CHECK(is(r[0], 0, (1 << 30) - 1));
+
+    BOOST_CHECK(true == P("bytes=0-", r));
+    BOOST_CHECK(true == r.resolve(open_end));
+    BOOST_CHECK(is(r[0], 0, open_end - 1));
+}
+
+BOOST_AUTO_TEST_CASE(no_allocations)
+{
+    byte_ranges_t r;
+    P("bytes=0-1", r);  // the grammar is built on first use
+
+    std::size_t before = allocations;
+    std::size_t parsed = 0;
+    for (int i = 0; i < 100; ++i) {
+        http11::parse_byte_ranges("bytes=0-1023,2048-4095,-512,8192-,10-20,30-40,50-60,70-80", r);
+        parsed += r.size();
+        r.resolve(100000, 80);
+    }
+    BOOST_CHECK(800 == parsed);
+    BOOST_CHECK(0 == allocations - before);
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "cidr_address.h"
+
+#include <arpa/inet.h>
+
+#include <cstdlib>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+namespace qi = boost::spirit::qi;
+
+bool P(const std::string &test, uri::cidr_t &parsed)
+{
+    static uri::cidr_address<const char *> grammar;
+
+    const char *first = test.data();
+    const char *last = test.data() + test.size();
+    std::cerr << "TEST: |" << test << "| ";
+    parsed = uri::cidr_t();
+    bool pass = qi::parse(first, last, grammar, parsed) && first == last;
+    std::cerr << (pass ? "good" : "bad") << std::endl;
+    return pass;
+}
+
+bool P(const std::string &test)
+{
+    uri::cidr_t parsed;
+    return P(test, parsed);
+}
+
+uri::cidr_t C(int family, const char *address, unsigned length)
+{
+    uri::cidr_t c;
+    uint8_t bytes[16] = { };
+    inet_pton(family, address, bytes);
+    c.assign(family == AF_INET ? uri::cidr_t::family_ipv4 : uri::cidr_t::family_ipv6, bytes, length);
+    return c;
+}
+
+BOOST_AUTO_TEST_CASE(ipv4_prefixes)
+{
+    uri::cidr_t c;
+    BOOST_CHECK(true  == P("10.0.0.0/8", c));
+    BOOST_CHECK(c == C(AF_INET, "10.0.0.0", 8));
+    BOOST_CHECK(0x0a000000 == c.ipv4());
+
+    BOOST_CHECK(true  == P("10.1.2.3/8", c));
+    BOOST_CHECK(c == C(AF_INET, "10.0.0.0", 8));
+    BOOST_CHECK(true  == P("192.168.1.129/25", c));
+    BOOST_CHECK(c == C(AF_INET, "192.168.1.128", 25));
+    BOOST_CHECK(true  == P("1.2.3.4/32", c));
+    BOOST_CHECK(c == C(AF_INET, "1.2.3.4", 32));
+    BOOST_CHECK(true  == P("255.255.255.255/0", c));
+    BOOST_CHECK(c == C(AF_INET, "0.0.0.0", 0));
+    BOOST_CHECK(true  == P("001.002.003.004/024", c));
+    BOOST_CHECK(c == C(AF_INET, "1.2.3.0", 24));
+
+    BOOST_CHECK(false == P("10.0.0.0"));
+    BOOST_CHECK(false == P("10.0.0.0/"));
+    BOOST_CHECK(false == P("10.0.0.0/33"));
+    BOOST_CHECK(false == P("10.0.0.0/100"));
+    BOOST_CHECK(false == P("10.0.0.0/0024"));
+    BOOST_CHECK(false == P("10.0.0/8"));
+    BOOST_CHECK(false == P("256.0.0.0/8"));
+    BOOST_CHECK(false == P("10.0.0.0 /8"));
+    BOOST_CHECK(false == P("10.0.0.0/-8"));
+}
+
+BOOST_AUTO_TEST_CASE(ipv6_prefixes)
+{
+    uri::cidr_t c;
+    BOOST_CHECK(true  == P("2001:db8::/32", c));
+    BOOST_CHECK(c == C(AF_INET6, "2001:db8::", 32));
+    BOOST_CHECK(true  == P("2001:db8:1:2:3:4:5:6/48", c));
+    BOOST_CHECK(c == C(AF_INET6, "2001:db8:1::", 48));
+    BOOST_CHECK(true  == P("::/0", c));
+    BOOST_CHECK(c == C(AF_INET6, "::", 0));
+    BOOST_CHECK(true  == P("::1/128", c));
+    BOOST_CHECK(c == C(AF_INET6, "::1", 128));
+    BOOST_CHECK(true  == P("::ffff:10.0.0.0/104", c));
+    BOOST_CHECK(c == C(AF_INET6, "::ffff:10.0.0.0", 104));
+    BOOST_CHECK(true  == P("fe80::/10", c));
+    BOOST_CHECK(c == C(AF_INET6, "fe80::", 10));
+    BOOST_CHECK(true  == P("FE80::1:2/64", c));
+    BOOST_CHECK(c == C(AF_INET6, "fe80::", 64));
+    BOOST_CHECK(uri::cidr_t::family_ipv6 == c.family);
+
+    BOOST_CHECK(false == P("::/129"));
+    BOOST_CHECK(false == P("::"));
+    BOOST_CHECK(false == P("2001:db8:::/32"));
+    BOOST_CHECK(false == P("2001:db8::1::/32"));
+    BOOST_CHECK(false == P("12345::/32"));
+    BOOST_CHECK(false == P("[::1]/128"));
+}
+
+// Every address the ipv6_address grammar accepts in full converts, to what
+// inet_pton makes of it, and nothing else converts.
+BOOST_AUTO_TEST_CASE(parse_ipv6_matches_the_grammar)
+{
+    uri::ipv6_address<const char *> grammar;
+
+    const char *groups[] = { "0", "1", "ab", "FFFF", "12345", "1.2.3.4", "" };
+    const std::size_t n = sizeof(groups) / sizeof(groups[0]);
+
+    std::srand(45);
+    std::size_t addresses = 0;
+    std::size_t mismatches = 0;
+    for (int i = 0; i < 200000; ++i) {
+        std::string s;
+        int count = std::rand() % 10;
+        for (int g = 0; g < count; ++g) {
+            if (g) {
+                s += std::rand() % 8 ? ":" : "::";
+            }
+            s += groups[std::rand() % n];
+        }
+        if (std::rand() % 4 == 0) {
+            s = std::rand() % 2 ? "::" + s : s + "::";
+        }
+
+        const char *first = s.data();
+        const char *last = first + s.size();
+        std::string parsed;
+        bool expected = qi::parse(first, last, grammar, parsed) && first == last;
+
+        uint8_t bytes[16];
+        bool got = uri::parse_ipv6(s.data(), last, bytes);
+        if (got != expected) {
+            std::cerr << "parse_ipv6 mismatch on |" << s << "|: " << got << std::endl;
+            ++mismatches;
+            continue;
+        }
+        if (got) {
+            ++addresses;
+            uint8_t reference[16];
+            if (inet_pton(AF_INET6, s.c_str(), reference) == 1 && std::memcmp(bytes, reference, 16) != 0) {
+                std::cerr << "value mismatch on |" << s << "|" << std::endl;
+                ++mismatches;
+            }
+        }
+    }
+    BOOST_CHECK(0 == mismatches);
+    BOOST_CHECK(addresses > 1000);
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,144 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "compact_uri.h"
+#include "uri_parser.h"
+
+#include <list>
+#include <vector>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+// uri_t refers to the parsed text, keep every input alive for the checks
+const std::string &keep(const std::string &test)
+{
+    static std::list<std::string> inputs;
+    inputs.push_back(test);
+    return inputs.back();
+}
+
+bool P(uri::uri_t &uri, const std::string &test)
+{
+    const std::string &input = keep(test);
+    const char *first = input.data();
+    const char *last = first + input.size();
+
+    uri = uri::uri_t();
+    uri::uri_parser<const char *> grammar(uri);
+    bool pass = boost::spirit::qi::parse(first, last, grammar) && first == last;
+
+    std::cerr << "TEST: |" << test << "| " << uri.to_string() << std::endl;
+    return pass;
+}
+
+// Every component of the view matches the parsed uri_t.
+void same(const uri::uri_t &a, const uri::uri_t &b)
+{
+    const uri::component_t uri::uri_t::*components[] = {
+        &uri::uri_t::scheme, &uri::uri_t::authority, &uri::uri_t::user_info, &uri::uri_t::host,
+        &uri::uri_t::port, &uri::uri_t::path, &uri::uri_t::query, &uri::uri_t::fragment,
+    };
+    for (std::size_t i = 0; i < sizeof(components) / sizeof(components[0]); ++i) {
+        BOOST_CHECK((a.*components[i]).defined() == (b.*components[i]).defined());
+        BOOST_CHECK((a.*components[i]).raw() == (b.*components[i]).raw());
+    }
+    BOOST_CHECK(a.host_kind == b.host_kind);
+    BOOST_CHECK(a.port_number == b.port_number);
+}
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+    const char *tests[] = {
+        "http://user:pw@makefile.com:8080/a/b?q=1#frag",
+        "http://[fe80::1]:80/",
+        "http://[v1.x]/",
+        "http://makefile.com:",
+        "//makefile.com?q#f",
+        "/a%20b?x%3Dy#%7E",
+        "mailto:joe@makefile.com",
+        "?",
+        "",
+    };
+
+    uri::uri_t uri;
+    for (std::size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); ++i) {
+        BOOST_CHECK(true == P(uri, tests[i]));
+        uri::compact_uri compact(uri);
+        BOOST_CHECK(tests[i] == compact.str());
+        BOOST_CHECK(false == compact.allocated());
+
+        uri::uri_t view = compact.view();
+        same(uri, view);
+        BOOST_CHECK(compact.str().data() <= view.path.raw().data());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(components)
+{
+    uri::uri_t uri;
+    BOOST_CHECK(true == P(uri, "http://makefile.com:8080/a?q"));
+    uri::compact_uri compact(uri);
+
+    BOOST_CHECK("http" == compact.raw(uri::compact_uri::scheme_id));
+    BOOST_CHECK("makefile.com:8080" == compact.raw(uri::compact_uri::authority_id));
+    BOOST_CHECK(false == compact.defined(uri::compact_uri::user_info_id));
+    BOOST_CHECK(false == compact.defined(uri::compact_uri::fragment_id));
+    BOOST_CHECK(true == compact.defined(uri::compact_uri::query_id));
+    BOOST_CHECK(8080 == compact.port_number());
+    BOOST_CHECK(uri::host_reg_name == compact.host_kind());
+
+    uri::compact_uri empty;
+    BOOST_CHECK(empty.str().empty());
+    BOOST_CHECK(false == empty.defined(uri::compact_uri::path_id));
+}
+
+BOOST_AUTO_TEST_CASE(long_uris_take_one_block)
+{
+    uri::uri_t uri;
+    std::string text = "http://makefile.com/" + std::string(200, 'p') + "?q=" + std::string(100, 'q');
+    BOOST_CHECK(true == P(uri, text));
+
+    uri::compact_uri compact(uri);
+    BOOST_CHECK(true == compact.allocated());
+    BOOST_CHECK(text == compact.str());
+    same(uri, compact.view());
+
+    // Copies get their own block, moves take it.
+    uri::compact_uri copy(compact);
+    BOOST_CHECK(copy == compact);
+    BOOST_CHECK(copy.str().data() != compact.str().data());
+
+    const char *data = compact.str().data();
+    uri::compact_uri moved(std::move(compact));
+    BOOST_CHECK(data == moved.str().data());
+    BOOST_CHECK(compact.str().empty());
+
+    std::vector<uri::compact_uri> queue;
+    queue.push_back(moved);
+    queue.push_back(uri::compact_uri(uri));
+    queue.resize(100);
+    BOOST_CHECK(queue[0] == queue[1]);
+    BOOST_CHECK(queue[0] != queue[2]);
+
+    std::string huge = "/" + std::string(uri::compact_uri::max_size, 'x');
+    BOOST_CHECK(true == P(uri, huge));
+    BOOST_CHECK_THROW(uri::compact_uri too_long(uri), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(modified_and_reassigned)
+{
+    uri::uri_t uri;
+    BOOST_CHECK(true == P(uri, "http://user@makefile.com/a"));
+
+    const std::string host("upstream.local");
+    uri.host.assign(host.data(), host.data() + host.size());
+    uri::compact_uri compact(uri);
+    BOOST_CHECK("http://user@upstream.local/a" == compact.str());
+    BOOST_CHECK("user@upstream.local" == compact.raw(uri::compact_uri::authority_id));
+
+    // Assigning from its own view.
+    compact.assign(compact.view());
+    BOOST_CHECK("http://user@upstream.local/a" == compact.str());
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,157 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "cookie.h"
+#include "spirit_parsers.h"
+#include "alloc_counter.h"
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+// Every cookie of a value, as "name=value" strings.
+std::vector<std::string> P(const std::string &test)
+{
+    std::vector<std::string> result;
+    for (const http11::cookie_t &c : http11::cookies(test)) {
+        result.push_back(c.name.to_string() + "=" + c.value.to_string());
+    }
+    std::cerr << "TEST: |" << test << "| " << result.size() << " cookies" << std::endl;
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(semicolon)
+{
+    for (std::size_t size = 0; size < 48; ++size) {
+        for (std::size_t at = 0; at <= size; ++at) {
+            std::string s(size, 'x');
+            if (at < size) {
+                s[at] = ';';
+            }
+            BOOST_CHECK(s.data() + at == http11::scan::semicolon(s.data(), s.data() + size));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(iterate)
+{
+    std::vector<std::string> c = P("SID=31d4d96e407aad42; lang=en-US");
+    BOOST_CHECK(2 == c.size());
+    BOOST_CHECK("SID=31d4d96e407aad42" == c[0]);
+    BOOST_CHECK("lang=en-US" == c[1]);
+
+    // whitespace, quotes, empty values, '=' in a value
+    c = P(" a = 1 ;b=\"quoted value\";\tc=;d=x=y; e =\"\" ");
+    BOOST_CHECK(5 == c.size());
+    BOOST_CHECK("a=1" == c[0]);
+    BOOST_CHECK("b=quoted value" == c[1]);
+    BOOST_CHECK("c=" == c[2]);
+    BOOST_CHECK("d=x=y" == c[3]);
+    BOOST_CHECK("e=" == c[4]);
+
+    // empty elements, elements without a name or '='
+    c = P(";; a=1;;noequals; =nameless;  ;b=2;");
+    BOOST_CHECK(2 == c.size());
+    BOOST_CHECK("a=1" == c[0]);
+    BOOST_CHECK("b=2" == c[1]);
+
+    BOOST_CHECK(0 == P("").size());
+    BOOST_CHECK(0 == P(" ; ;").size());
+    BOOST_CHECK(1 == P("\"=\"").size());
+
+    // long values cross the sixteen byte blocks
+    std::string value;
+    for (int i = 0; i < 100; ++i) {
+        value += (i ? "; c" : "c") + std::to_string(i) + "=" + std::string(i % 37, 'v');
+    }
+    c = P(value);
+    BOOST_CHECK(100 == c.size());
+    BOOST_CHECK("c99=" + std::string(99 % 37, 'v') == c[99]);
+}
+
+BOOST_AUTO_TEST_CASE(lookup)
+{
+    std::string value = "theme=dark; session=abc123; csrf=\"t0k\"; session=shadowed; lang=en";
+    boost::string_ref names[] = { "session", "csrf", "missing" };
+    boost::string_ref values[3];
+
+    BOOST_CHECK(2 == http11::find_cookies(value, names, values, 3));
+    BOOST_CHECK("abc123" == values[0]);
+    BOOST_CHECK("t0k" == values[1]);
+    BOOST_CHECK(0 == values[2].data());
+
+    BOOST_CHECK(2 == http11::find_cookies(value, names, values, 2));
+
+    // names are case sensitive
+    boost::string_ref found;
+    BOOST_CHECK(false == http11::find_cookie(value, "Session", found));
+    BOOST_CHECK(true == http11::find_cookie(value, "lang", found));
+    BOOST_CHECK("en" == found);
+
+    // a name given twice is found twice
+    boost::string_ref twice[] = { "lang", "lang" };
+    BOOST_CHECK(2 == http11::find_cookies(value, twice, values, 2));
+    BOOST_CHECK("en" == values[0]);
+    BOOST_CHECK("en" == values[1]);
+
+    // a found empty value is not a missing one
+    BOOST_CHECK(true == http11::find_cookie("a=; b=1", "a", found));
+    BOOST_CHECK(0 != found.data());
+    BOOST_CHECK(found.empty());
+}
+
+BOOST_AUTO_TEST_CASE(duplicate_headers)
+{
+    std::string head = "GET / HTTP/1.1\r\n"
+                       "Cookie: theme=dark; session=abc123\r\n"
+                       "Host: www.makefile.com\r\n"
+                       "cookie:csrf=t0k\r\n"
+                       "COOKIE: session=shadowed; lang=en\r\n"
+                       "Set-Cookie: not=this\r\n"
+                       "\r\n";
+    const char *first = head.data();
+    const char *last = head.data() + head.size();
+
+    boost::string_ref headers[8];
+    std::size_t n = http11::cookie_headers(first, last, headers, 8);
+    BOOST_CHECK(3 == n);
+    BOOST_CHECK("theme=dark; session=abc123" == headers[0]);
+    BOOST_CHECK("csrf=t0k" == headers[1]);
+    BOOST_CHECK("session=shadowed; lang=en" == headers[2]);
+    BOOST_CHECK(2 == http11::cookie_headers(first, last, headers, 2));
+
+    boost::string_ref names[] = { "session", "csrf", "lang" };
+    boost::string_ref values[3];
+    BOOST_CHECK(3 == http11::find_cookies(headers, n, names, values, 3));
+    BOOST_CHECK("abc123" == values[0]);
+    BOOST_CHECK("t0k" == values[1]);
+    BOOST_CHECK("en" == values[2]);
+
+    // the header map sees the first line only
+    http11::request_t req;
+    const char *cur = first;
+    BOOST_CHECK(true == http11::parse_request(cur, last, req));
+    BOOST_CHECK("theme=dark; session=abc123" == req.headers["Cookie"]);
+
+    // a head that goes bad stops the scan there
+    std::string bad = "GET / HTTP/1.1\r\nCookie: a=1\r\nbroken line\r\nCookie: b=2\r\n\r\n";
+    BOOST_CHECK(1 == http11::cookie_headers(bad.data(), bad.data() + bad.size(), headers, 8));
+    BOOST_CHECK(0 == http11::cookie_headers(head.data(), head.data() + 5, headers, 8));
+}
+
+BOOST_AUTO_TEST_CASE(no_allocations)
+{
+    std::string head = "GET / HTTP/1.1\r\nCookie: theme=dark; session=abc123\r\nCookie: csrf=t0k\r\n\r\n";
+    boost::string_ref names[] = { "session", "csrf" };
+    boost::string_ref headers[4];
+    boost::string_ref values[2];
+
+    std::size_t before = allocations;
+    std::size_t found = 0;
+    for (int i = 0; i < 100; ++i) {
+        std::size_t n = http11::cookie_headers(head.data(), head.data() + head.size(), headers, 4);
+        found += http11::find_cookies(headers, n, names, values, 2);
+    }
+    BOOST_CHECK(200 == found);
+    BOOST_CHECK(0 == allocations - before);
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,203 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "forwarded.h"
+#include "alloc_counter.h"
+
+#include <arpa/inet.h>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+using http11::forwarded_node_t;
+
+uri::ip_address_t A(const char *text)
+{
+    uri::ip_address_t a;
+    uint8_t bytes[16];
+    if (inet_pton(AF_INET, text, bytes) == 1) {
+        a.assign(static_cast<uint32_t>(bytes[0]) << 24 | bytes[1] << 16 | bytes[2] << 8 | bytes[3]);
+    }
+    else if (inet_pton(AF_INET6, text, bytes) == 1) {
+        a.assign(bytes);
+    }
+    return a;
+}
+
+// Parse the whole list, leftmost element first in the result.
+std::vector<forwarded_node_t> P(http11::forwarded_header_t header, const std::string &value)
+{
+    http11::forwarded_list list(header);
+    forwarded_node_t nodes[16];
+    std::size_t count = list.parse(value, nodes, 16);
+    std::cerr << "TEST: |" << value << "| " << count << " elements" << std::endl;
+    return std::vector<forwarded_node_t>(std::reverse_iterator<forwarded_node_t *>(nodes + count),
+                                         std::reverse_iterator<forwarded_node_t *>(nodes));
+}
+
+bool is(const forwarded_node_t &node, const char *address, uint16_t port = 0)
+{
+    return node.kind == forwarded_node_t::node_address && node.address == A(address) && node.port == port;
+}
+
+BOOST_AUTO_TEST_CASE(x_forwarded_for)
+{
+    std::vector<forwarded_node_t> n = P(http11::x_forwarded_for, "203.0.113.7, 198.51.100.23,10.0.0.1");
+    BOOST_CHECK(3 == n.size());
+    BOOST_CHECK(is(n[0], "203.0.113.7"));
+    BOOST_CHECK(is(n[1], "198.51.100.23"));
+    BOOST_CHECK(is(n[2], "10.0.0.1"));
+
+    n = P(http11::x_forwarded_for, "2001:db8:85a3::8a2e:370:7334, [2001:db8::1]:4711, 192.0.2.1:8080, unknown");
+    BOOST_CHECK(4 == n.size());
+    BOOST_CHECK(is(n[0], "2001:db8:85a3::8a2e:370:7334"));
+    BOOST_CHECK(is(n[1], "2001:db8::1", 4711));
+    BOOST_CHECK(is(n[2], "192.0.2.1", 8080));
+    BOOST_CHECK(forwarded_node_t::node_unknown == n[3].kind);
+
+    // empty elements do not count
+    n = P(http11::x_forwarded_for, " , 1.2.3.4 ,, 5.6.7.8 ,");
+    BOOST_CHECK(2 == n.size());
+    BOOST_CHECK(is(n[0], "1.2.3.4"));
+    BOOST_CHECK(is(n[1], "5.6.7.8"));
+
+    BOOST_CHECK(0 == P(http11::x_forwarded_for, "").size());
+    BOOST_CHECK(0 == P(http11::x_forwarded_for, " ").size());
+
+    // parsing stops at the first bad element from the right
+    n = P(http11::x_forwarded_for, "1.2.3.4, example.com, 5.6.7.8");
+    BOOST_CHECK(1 == n.size());
+    BOOST_CHECK(is(n[0], "5.6.7.8"));
+    BOOST_CHECK(0 == P(http11::x_forwarded_for, "1.2.3.4, 256.1.1.1").size());
+    BOOST_CHECK(0 == P(http11::x_forwarded_for, "1.2.3.4 5.6.7.8").size());
+    BOOST_CHECK(0 == P(http11::x_forwarded_for, "1.2.3.4:65536").size());
+    BOOST_CHECK(0 == P(http11::x_forwarded_for, "[1.2.3.4]").size());
+    BOOST_CHECK(0 == P(http11::x_forwarded_for, "\"1.2.3.4\"").size());
+}
+
+BOOST_AUTO_TEST_CASE(forwarded_header)
+{
+    // RFC 7239 section 4 examples
+    std::vector<forwarded_node_t> n = P(http11::forwarded, "for=\"_gazonk\"");
+    BOOST_CHECK(1 == n.size());
+    BOOST_CHECK(forwarded_node_t::node_obfuscated == n[0].kind);
+
+    n = P(http11::forwarded, "For=\"[2001:db8:cafe::17]:4711\"");
+    BOOST_CHECK(1 == n.size());
+    BOOST_CHECK(is(n[0], "2001:db8:cafe::17", 4711));
+
+    n = P(http11::forwarded, "for=192.0.2.60;proto=http;by=203.0.113.43");
+    BOOST_CHECK(1 == n.size());
+    BOOST_CHECK(is(n[0], "192.0.2.60"));
+
+    n = P(http11::forwarded, "for=192.0.2.43, for=198.51.100.17");
+    BOOST_CHECK(2 == n.size());
+    BOOST_CHECK(is(n[0], "192.0.2.43"));
+    BOOST_CHECK(is(n[1], "198.51.100.17"));
+
+    // quoted commas and semicolons, no for=, unknown, obfuscated port
+    n = P(http11::forwarded, "for=unknown;host=\"a,b;c\" , proto=https ; by=\"x\\\",y\", for=\"10.0.0.1:_p1\"");
+    BOOST_CHECK(3 == n.size());
+    BOOST_CHECK(forwarded_node_t::node_unknown == n[0].kind);
+    BOOST_CHECK(forwarded_node_t::node_none == n[1].kind);
+    BOOST_CHECK(is(n[2], "10.0.0.1"));
+
+    // a port or IPv6 must be quoted
+    BOOST_CHECK(0 == P(http11::forwarded, "for=192.0.2.60:80").size());
+    BOOST_CHECK(0 == P(http11::forwarded, "for=[2001:db8::1]").size());
+    BOOST_CHECK(0 == P(http11::forwarded, "for=\"2001:db8::1\"").size());
+    BOOST_CHECK(0 == P(http11::forwarded, "for=example.com").size());
+    BOOST_CHECK(0 == P(http11::forwarded, "for=\"1.2.3.4").size());
+    BOOST_CHECK(0 == P(http11::forwarded, "for").size());
+}
+
+BOOST_AUTO_TEST_CASE(client)
+{
+    http11::forwarded_list xff(http11::x_forwarded_for);
+    forwarded_node_t node;
+
+    // 6.6.6.6 is what the client wrote itself; 203.0.113.7 was appended by
+    // the outermost of three proxies, 10.0.0.2 and 10.0.0.1 by the others.
+    std::string value = "6.6.6.6, 203.0.113.7, 10.0.0.2, 10.0.0.1";
+    BOOST_CHECK(false == xff.client(value, 0, node));
+    BOOST_CHECK(true == xff.client(value, 1, node));
+    BOOST_CHECK(is(node, "10.0.0.1"));
+    BOOST_CHECK(true == xff.client(value, 2, node));
+    BOOST_CHECK(is(node, "10.0.0.2"));
+    BOOST_CHECK(true == xff.client(value, 3, node));
+    BOOST_CHECK(is(node, "203.0.113.7"));
+    BOOST_CHECK(true == xff.client(value, 4, node));
+    BOOST_CHECK(is(node, "6.6.6.6"));
+    BOOST_CHECK(false == xff.client(value, 5, node));
+    BOOST_CHECK(false == xff.client("", 1, node));
+
+    // whatever the client wrote to the left of the trusted hops is not read
+    BOOST_CHECK(true == xff.client("not an address, 203.0.113.7, 10.0.0.1", 1, node));
+    BOOST_CHECK(is(node, "10.0.0.1"));
+    BOOST_CHECK(true == xff.client("not an address, 203.0.113.7, 10.0.0.1", 2, node));
+    BOOST_CHECK(is(node, "203.0.113.7"));
+    BOOST_CHECK(true == xff.client("203.0.113.7, bogus, 10.0.0.1", 1, node));
+    BOOST_CHECK(is(node, "10.0.0.1"));
+    BOOST_CHECK(false == xff.client("203.0.113.7, bogus, 10.0.0.1", 2, node));
+
+    http11::forwarded_list fwd(http11::forwarded);
+    BOOST_CHECK(true == fwd.client("for=192.0.2.43, for=\"[2001:db8::9]\";proto=https, for=10.0.0.1", 2, node));
+    BOOST_CHECK(is(node, "2001:db8::9"));
+}
+
+BOOST_AUTO_TEST_CASE(repeated_header_lines)
+{
+    // The client sent the first line; the proxy in front of us added its
+    // hop as a second one, which the header map drops.
+    std::string head = "GET / HTTP/1.1\r\n"
+                       "X-Forwarded-For: 6.6.6.6\r\n"
+                       "Host: www.makefile.com\r\n"
+                       "Forwarded: for=192.0.2.43\r\n"
+                       "x-forwarded-for: 203.0.113.7, 10.0.0.2\r\n"
+                       "\r\n";
+    const char *first = head.data();
+    const char *last = head.data() + head.size();
+
+    boost::string_ref values[4];
+    std::size_t n = http11::forwarded_headers(first, last, http11::x_forwarded_for, values, 4);
+    BOOST_CHECK(2 == n);
+    BOOST_CHECK("6.6.6.6" == values[0]);
+    BOOST_CHECK("203.0.113.7, 10.0.0.2" == values[1]);
+
+    http11::forwarded_list xff(http11::x_forwarded_for);
+    forwarded_node_t node;
+    BOOST_CHECK(true == xff.client(values, n, 1, node));
+    BOOST_CHECK(is(node, "10.0.0.2"));
+    BOOST_CHECK(true == xff.client(values, n, 2, node));
+    BOOST_CHECK(is(node, "203.0.113.7"));
+    BOOST_CHECK(true == xff.client(values, n, 3, node));
+    BOOST_CHECK(is(node, "6.6.6.6"));
+    BOOST_CHECK(false == xff.client(values, n, 4, node));
+    BOOST_CHECK(false == xff.client(values, 0, 1, node));
+
+    // more lines than room keeps the last ones
+    BOOST_CHECK(1 == http11::forwarded_headers(first, last, http11::x_forwarded_for, values, 1));
+    BOOST_CHECK("203.0.113.7, 10.0.0.2" == values[0]);
+
+    BOOST_CHECK(1 == http11::forwarded_headers(first, last, http11::forwarded, values, 4));
+    BOOST_CHECK("for=192.0.2.43" == values[0]);
+}
+
+BOOST_AUTO_TEST_CASE(no_allocations)
+{
+    http11::forwarded_list xff(http11::x_forwarded_for);
+    http11::forwarded_list fwd(http11::forwarded);
+    std::string value = "2001:db8:85a3:0:0:8a2e:370:7334, [2001:db8:cafe::17]:4711, 203.0.113.7, 10.0.0.1";
+    std::string header = "for=\"[2001:db8:85a3:0:0:8a2e:370:7334]:4711\";proto=https;host=\"www.makefile.com\", for=10.0.0.1";
+    forwarded_node_t nodes[8];
+
+    std::size_t before = allocations;
+    std::size_t parsed = 0;
+    for (int i = 0; i < 100; ++i) {
+        parsed += xff.parse(value, nodes, 8);
+        parsed += fwd.parse(header, nodes, 8);
+    }
+    BOOST_CHECK(600 == parsed);
+    BOOST_CHECK(0 == allocations - before);
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,142 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "header_columns.h"
+#include "http11_parser.h"
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+bool P(http11::header_columns &columns, const std::string &input, const char *&first)
+{
+    first = input.data();
+    bool pass = columns.parse(input.data(), first, input.data() + input.size());
+    std::cerr << "TEST: |" << input << "| " << pass << " rows " << columns.rows() << std::endl;
+    return pass;
+}
+
+BOOST_AUTO_TEST_CASE(registered_headers_only)
+{
+    http11::header_columns columns;
+    std::size_t host = columns.add("Host");
+    std::size_t agent = columns.add("User-Agent");
+    std::size_t referer = columns.add("Referer");
+    BOOST_CHECK(3 == columns.columns());
+    BOOST_CHECK(host == columns.add("host"));
+
+    const std::string input(
+        "GET / HTTP/1.1\r\n"
+        "Host: makefile.com\r\n"
+        "Accept: */*\r\n"
+        "user-agent:   spirit/1.0 (x)\r\n"
+        "Host: ignored.com\r\n"
+        "\r\n");
+    const char *first;
+    BOOST_CHECK(true == P(columns, input, first));
+    BOOST_CHECK("\r\n" == std::string(first, input.data() + input.size()));
+    BOOST_CHECK(1 == columns.rows());
+
+    BOOST_CHECK("makefile.com" == columns.value(input.data(), 0, host));
+    BOOST_CHECK("spirit/1.0 (x)" == columns.value(input.data(), 0, agent));
+    BOOST_CHECK(false == columns.defined(0, referer));
+    BOOST_CHECK(http11::header_columns::npos == columns.offsets(referer)[0]);
+    BOOST_CHECK(22 == columns.offsets(host)[0]);
+    BOOST_CHECK(12 == columns.lengths(host)[0]);
+}
+
+BOOST_AUTO_TEST_CASE(names_fold_letters_only)
+{
+    http11::header_columns columns;
+    std::size_t at = columns.add("X@");
+    BOOST_CHECK(at == columns.add("x@"));
+    BOOST_CHECK(at != columns.add("X`"));
+    BOOST_CHECK(2 == columns.columns());
+}
+
+BOOST_AUTO_TEST_CASE(rows_from_a_batch)
+{
+    const std::string batch(
+        "GET /a HTTP/1.1\r\nHost: a.com\r\n\r\n"
+        "GET /b HTTP/1.1\r\nReferer: http://a.com/\r\n\r\n"
+        "GET /c HTTP/1.0\r\nReferer: http://b.com/\r\nHost: c.com\r\n\r\n");
+
+    http11::header_columns columns;
+    std::size_t host = columns.add("Host");
+    columns.reserve(3);
+
+    const char *first = batch.data();
+    const char *last = first + batch.size();
+    while (first != last && columns.parse(batch.data(), first, last)) {
+        BOOST_REQUIRE(true == http11::scan::literal(first, last, "\r\n", 2));
+    }
+    BOOST_CHECK(first == last);
+    BOOST_CHECK(3 == columns.rows());
+
+    // A column added later is undefined for the earlier rows.
+    std::size_t referer = columns.add("Referer");
+    BOOST_CHECK(false == columns.defined(2, referer));
+    BOOST_CHECK(3 == columns.offsets(referer).size());
+
+    BOOST_CHECK("a.com" == columns.value(batch.data(), 0, host));
+    BOOST_CHECK(false == columns.defined(1, host));
+    BOOST_CHECK("c.com" == columns.value(batch.data(), 2, host));
+
+    columns.clear();
+    BOOST_CHECK(0 == columns.rows());
+    BOOST_CHECK(2 == columns.columns());
+    BOOST_CHECK(0 == columns.offsets(host).size());
+}
+
+BOOST_AUTO_TEST_CASE(bad_heads)
+{
+    http11::header_columns columns;
+    columns.add("Host");
+    const char *first;
+
+    BOOST_CHECK(false == P(columns, "", first));
+    BOOST_CHECK(false == P(columns, "GET / HTTP/1.1", first));
+    BOOST_CHECK(false == P(columns, "GET /\x01 HTTP/1.1\r\n", first));
+    BOOST_CHECK(0 == columns.rows());
+
+    // A header line that does not end in CRLF ends the head and is not
+    // stored. (request_parser stops in the same place, but its map keeps
+    // the value the header rule matched before crlf failed.)
+    const std::string input("GET / HTTP/1.1\r\nHost: broken\nX: y\r\n");
+    BOOST_CHECK(true == P(columns, input, first));
+    BOOST_CHECK(input.data() + 16 == first);
+    BOOST_CHECK(false == columns.defined(0, 0));
+}
+
+// The values agree with the header map request_parser builds.
+BOOST_AUTO_TEST_CASE(same_as_request_parser)
+{
+    const char *tests[] = {
+        "GET / HTTP/1.1\r\nHost: makefile.com\r\nX-Test: goobers\r\n",
+        "GET / HTTP/1.1\r\nHost:makefile.com\r\n\r\n",
+        "GET / HTTP/1.1\r\nX-Test: a\tb\r\nHost: h\r\nHost: i\r\n",
+        "GET / HTTP/1.1\r\nBad Key: x\r\nHost: h\r\n",
+        "GET / HTTP/1.1\r\nHost: \x7f\r\n",
+    };
+
+    for (std::size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); ++i) {
+        const std::string input(tests[i]);
+
+        http11::request_t req;
+        http11::request_parser<const char *> grammar(req);
+        const char *expected = input.data();
+        BOOST_CHECK(true == boost::spirit::qi::parse(expected, input.data() + input.size(), grammar));
+
+        http11::header_columns columns;
+        std::size_t host = columns.add("Host");
+        std::size_t test = columns.add("X-Test");
+        const char *first;
+        BOOST_CHECK(true == P(columns, input, first));
+        BOOST_CHECK(expected == first);
+
+        BOOST_CHECK(req.headers.count("Host") == columns.defined(0, host));
+        BOOST_CHECK(req.headers["Host"] == columns.value(input.data(), 0, host));
+        BOOST_CHECK(req.headers.count("X-Test") == columns.defined(0, test));
+        BOOST_CHECK(req.headers["X-Test"] == columns.value(input.data(), 0, test));
+    }
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
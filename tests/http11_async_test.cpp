@@ -0,0 +1,254 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "http11_async.h"
+
+#include <unistd.h>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+// Run a read that cannot suspend (memory_source) to completion.
+template <typename Reader>
+http11::read_status_t P(Reader &reader, http11::request_t &req)
+{
+    http11::task<http11::read_status_t> t = reader.read(req);
+    t.start();
+    BOOST_REQUIRE(t.done());
+
+    std::cerr << "STATUS: " << t.result() << " " << req.to_string() << std::endl;
+    return t.result();
+}
+
+const std::string pipelined(
+    "GET /a HTTP/1.1\r\nHost: makefile.com\r\nX-Test: goobers\r\n\r\n"
+    "POST /b?q=1 HTTP/1.0\r\nContent-Length: 0\r\n\r\n"
+    "GET http://makefile.com:8080/c HTTP/1.1\r\n\r\n");
+
+void check_pipelined(std::size_t chunk)
+{
+    http11::memory_source source(pipelined.data(), pipelined.data() + pipelined.size(), chunk);
+    http11::async_request_reader<http11::memory_source> reader(source);
+    http11::request_t req;
+
+    BOOST_CHECK(http11::read_ok == P(reader, req));
+    BOOST_CHECK("GET" == req.method);
+    BOOST_CHECK("/a" == req.uri.path);
+    BOOST_CHECK("goobers" == req.headers["X-Test"]);
+
+    BOOST_CHECK(http11::read_ok == P(reader, req));
+    BOOST_CHECK("POST" == req.method);
+    BOOST_CHECK(http11::version_t(1, 0) == req.version);
+    BOOST_CHECK("q=1" == req.uri.query);
+    BOOST_CHECK("0" == req.headers["Content-Length"]);
+
+    BOOST_CHECK(http11::read_ok == P(reader, req));
+    BOOST_CHECK("makefile.com" == req.uri.host);
+    BOOST_CHECK(8080 == req.uri.port_number);
+    BOOST_CHECK(0 == req.headers.size());
+
+    BOOST_CHECK(http11::read_end_of_stream == P(reader, req));
+}
+
+BOOST_AUTO_TEST_CASE(memory_source_whole)
+{
+    check_pipelined(static_cast<std::size_t>(-1));
+}
+
+BOOST_AUTO_TEST_CASE(memory_source_chunks)
+{
+    // Request heads straddle several reads.
+    check_pipelined(pipelined.size() - 1);
+    check_pipelined(64);
+    check_pipelined(5);
+}
+
+BOOST_AUTO_TEST_CASE(bytes_after_the_head)
+{
+    const std::string input("POST / HTTP/1.1\r\nContent-Length: 4\r\n\r\nbodyGET /next HTTP/1.1\r\n\r\n");
+    http11::memory_source source(input.data(), input.data() + input.size());
+    http11::async_request_reader<http11::memory_source> reader(source);
+    http11::request_t req;
+
+    BOOST_CHECK(http11::read_ok == P(reader, req));
+    BOOST_CHECK("bodyGET /next HTTP/1.1\r\n\r\n" == std::string(reader.rest_begin(), reader.rest_end()));
+
+    // The caller takes the body, the next read starts after it.
+    reader.consume(4);
+    BOOST_CHECK(http11::read_ok == P(reader, req));
+    BOOST_CHECK("/next" == req.uri.path);
+}
+
+BOOST_AUTO_TEST_CASE(byte_at_a_time)
+{
+    const std::string input("GET /x HTTP/1.1\r\nHost: makefile.com\r\n\r\n");
+    http11::memory_source source(input.data(), input.data() + input.size(), 1);
+    http11::async_request_reader<http11::memory_source> reader(source);
+    http11::request_t req;
+
+    BOOST_CHECK(http11::read_ok == P(reader, req));
+    BOOST_CHECK("/x" == req.uri.path);
+    BOOST_CHECK("makefile.com" == req.headers["Host"]);
+    BOOST_CHECK(http11::read_end_of_stream == P(reader, req));
+}
+
+BOOST_AUTO_TEST_CASE(errors)
+{
+    http11::request_t req;
+
+    const std::string bad("get / HTTP/1.1\r\n\r\n");
+    http11::memory_source bad_source(bad.data(), bad.data() + bad.size());
+    http11::async_request_reader<http11::memory_source> bad_reader(bad_source);
+    BOOST_CHECK(http11::read_bad_request == P(bad_reader, req));
+
+    const std::string truncated("GET / HTTP/1.1\r\nHost: makefile.com\r\n");
+    http11::memory_source truncated_source(truncated.data(), truncated.data() + truncated.size());
+    http11::async_request_reader<http11::memory_source> truncated_reader(truncated_source);
+    BOOST_CHECK(http11::read_truncated == P(truncated_reader, req));
+
+    std::string large("GET / HTTP/1.1\r\n");
+    for (int i = 0; i < 1000; ++i) {
+        large += "X-Filler: 0123456789012345678901234567890123456789\r\n";
+    }
+    large += "\r\n";
+    http11::memory_source large_source(large.data(), large.data() + large.size());
+    http11::async_request_reader<http11::memory_source> small_reader(large_source, 8192);
+    BOOST_CHECK(http11::read_too_large == P(small_reader, req));
+
+    // The same head fits a larger limit; the buffer grows to hold it.
+    http11::memory_source large_again(large.data(), large.data() + large.size(), 1000);
+    http11::async_request_reader<http11::memory_source> large_reader(large_again);
+    BOOST_CHECK(http11::read_ok == P(large_reader, req));
+    BOOST_CHECK(1 == req.headers.size());
+}
+
+BOOST_AUTO_TEST_CASE(pipe_source_suspends_and_resumes)
+{
+    int fds[2];
+    BOOST_REQUIRE(0 == ::pipe(fds));
+
+    http11::io_loop loop;
+    http11::pipe_source source(fds[0], loop);
+    http11::async_request_reader<http11::pipe_source> reader(source);
+    http11::request_t req;
+
+    const std::string part1("GET /slow HTTP/1.1\r\nHo");
+    const std::string part2("st: makefile.com\r\n\r\n");
+
+    BOOST_REQUIRE(part1.size() == static_cast<std::size_t>(::write(fds[1], part1.data(), part1.size())));
+
+    http11::task<http11::read_status_t> t = reader.read(req);
+    t.start();
+    BOOST_CHECK(false == t.done());
+    BOOST_CHECK(false == loop.idle());
+
+    BOOST_REQUIRE(part2.size() == static_cast<std::size_t>(::write(fds[1], part2.data(), part2.size())));
+    BOOST_CHECK(1 == loop.run_once());
+    BOOST_REQUIRE(true == t.done());
+    BOOST_CHECK(http11::read_ok == t.result());
+    BOOST_CHECK("/slow" == req.uri.path);
+    BOOST_CHECK("makefile.com" == req.headers["Host"]);
+
+    ::close(fds[1]);
+    http11::task<http11::read_status_t> eof = reader.read(req);
+    eof.start();
+    BOOST_REQUIRE(true == eof.done());
+    BOOST_CHECK(http11::read_end_of_stream == eof.result());
+    ::close(fds[0]);
+}
+
+BOOST_AUTO_TEST_CASE(pipe_source_wakeup_without_data)
+{
+    int fds[2];
+    BOOST_REQUIRE(0 == ::pipe(fds));
+
+    // Two readers wait on the same descriptor; the first one resumed takes
+    // the bytes, the other finds nothing and must wait again.
+    http11::io_loop loop;
+    http11::pipe_source source1(fds[0], loop);
+    http11::pipe_source source2(fds[0], loop);
+    http11::async_request_reader<http11::pipe_source> reader1(source1);
+    http11::async_request_reader<http11::pipe_source> reader2(source2);
+    http11::request_t req1, req2;
+
+    http11::task<http11::read_status_t> t1 = reader1.read(req1);
+    http11::task<http11::read_status_t> t2 = reader2.read(req2);
+    t1.start();
+    t2.start();
+
+    const std::string request("GET /once HTTP/1.1\r\n\r\n");
+    BOOST_REQUIRE(request.size() == static_cast<std::size_t>(::write(fds[1], request.data(), request.size())));
+    BOOST_CHECK(2 == loop.run_once());
+    BOOST_REQUIRE(true == t1.done());
+    BOOST_CHECK(http11::read_ok == t1.result());
+    BOOST_CHECK(false == t2.done());
+    BOOST_CHECK(false == loop.idle());
+
+    BOOST_REQUIRE(request.size() == static_cast<std::size_t>(::write(fds[1], request.data(), request.size())));
+    BOOST_CHECK(1 == loop.run_once());
+    BOOST_REQUIRE(true == t2.done());
+    BOOST_CHECK(http11::read_ok == t2.result());
+    BOOST_CHECK("/once" == req2.uri.path);
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+BOOST_AUTO_TEST_CASE(pipe_source_error)
+{
+    int fds[2];
+    BOOST_REQUIRE(0 == ::pipe(fds));
+
+    // Reading the write end fails, which is not the end of the stream.
+    http11::io_loop loop;
+    http11::pipe_source source(fds[1], loop);
+    http11::async_request_reader<http11::pipe_source> reader(source);
+    http11::request_t req;
+
+    http11::task<http11::read_status_t> t = reader.read(req);
+    t.start();
+    BOOST_REQUIRE(true == t.done());
+    BOOST_CHECK(http11::read_error == t.result());
+    BOOST_CHECK(EBADF == source.error());
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+// A connection handler as a server would write it, awaiting each request.
+http11::task<int> serve(http11::async_request_reader<http11::pipe_source> &reader)
+{
+    http11::request_t req;
+    int served = 0;
+    while ((co_await reader.read(req)) == http11::read_ok) {
+        ++served;
+    }
+    co_return served;
+}
+
+BOOST_AUTO_TEST_CASE(awaiting_reads)
+{
+    int fds[2];
+    BOOST_REQUIRE(0 == ::pipe(fds));
+
+    http11::io_loop loop;
+    http11::pipe_source source(fds[0], loop);
+    http11::async_request_reader<http11::pipe_source> reader(source);
+
+    http11::task<int> handler = serve(reader);
+    handler.start();
+    BOOST_CHECK(false == handler.done());
+
+    // Feed three requests a few bytes at a time.
+    const std::string input = pipelined.substr(0, pipelined.find("POST")) + "GET /2 HTTP/1.1\r\n\r\nGET /3 HTTP/1.1\r\n\r\n";
+    for (std::size_t pos = 0; pos < input.size(); pos += 7) {
+        std::size_t n = input.size() - pos < 7 ? input.size() - pos : 7;
+        BOOST_REQUIRE(n == static_cast<std::size_t>(::write(fds[1], input.data() + pos, n)));
+        loop.run_once(0);
+    }
+    ::close(fds[1]);
+    loop.run();
+
+    BOOST_REQUIRE(true == handler.done());
+    BOOST_CHECK(3 == handler.result());
+    ::close(fds[0]);
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
@@ -28,7 +28,10 @@ bool P(http11::request_t &req, const T &test)
 
 bool P(http11::request_t &req, const char *test)
 {
-    return P(req, std::string(test));
+    // req.uri refers to the parsed text, keep it alive for the checks
+    static std::string input;
+    input = test;
+    return P(req, input);
 }
 
 BOOST_AUTO_TEST_CASE(all_methods_without_headers)
@@ -71,6 +74,27 @@ BOOST_AUTO_TEST_CASE(unknown_method)
     BOOST_CHECK(false == P(req, "THISMETHODISTOOMANYCHARACTERSINLENGTH / HTTP/1.1\r\nHost: makefile.com"));
 }
 
+BOOST_AUTO_TEST_CASE(versions)
+{
+    http11::request_t req;
+
+    BOOST_CHECK(true == P(req, "GET / HTTP/1.1\r\n"));
+    BOOST_CHECK(http11::version_t(1, 1) == req.version);
+    BOOST_CHECK(true == P(req, "GET / HTTP/1.0\r\n"));
+    BOOST_CHECK(http11::version_t(1, 0) == req.version);
+
+    // Less common versions go through the general rule.
+    BOOST_CHECK(true == P(req, "GET / HTTP/2.0\r\n"));
+    BOOST_CHECK(http11::version_t(2, 0) == req.version);
+    BOOST_CHECK(true == P(req, "GET / HTTP/1.10\r\n"));
+    BOOST_CHECK(http11::version_t(1, 10) == req.version);
+    BOOST_CHECK("1.10" == req.version.to_string());
+
+    BOOST_CHECK(false == P(req, "GET / HTTP/1.256\r\n"));
+    BOOST_CHECK(false == P(req, "GET / HTTP/1\r\n"));
+    BOOST_CHECK(false == P(req, "GET / HTTP/1.1x\r\n"));
+}
+
 BOOST_AUTO_TEST_CASE(uri_correctness)
 {
     http11::request_t req;
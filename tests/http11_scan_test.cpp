@@ -0,0 +1,161 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "http11_parser.h"
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+// Length of the field value at the start of test, checking that the pointer
+// and the generic scanners agree.
+std::size_t P(const std::string &test)
+{
+    const char *first = test.data();
+    const char *last = first + test.size();
+
+    std::size_t fast = http11::scan::field_value(first, last) - first;
+    std::size_t slow = http11::scan::field_value(test.begin(), test.end()) - test.begin();
+
+    std::cerr << "TEST: |" << test << "| " << fast << " / " << slow << std::endl;
+    BOOST_CHECK(fast == slow);
+    return fast;
+}
+
+BOOST_AUTO_TEST_CASE(field_value_runs)
+{
+    BOOST_CHECK(0  == P(""));
+    BOOST_CHECK(3  == P("abc"));
+    BOOST_CHECK(3  == P("abc\r\n"));
+    BOOST_CHECK(26 == P("text/html; charset=utf-8\t \r\nNext: header"));
+    BOOST_CHECK(0  == P("\r\nabc"));
+}
+
+BOOST_AUTO_TEST_CASE(field_value_stops_at_every_control)
+{
+    // Put each byte that ends a value at every offset of a long printable run,
+    // so it lands both inside a word and in the byte at a time tail.
+    const char stops[] = { '\0', '\x01', '\n', '\r', '\x1f', '\x7f', '\x80', '\xff' };
+    for (std::size_t s = 0; s < sizeof(stops); ++s) {
+        for (std::size_t pos = 0; pos < 20; ++pos) {
+            std::string test(20, 'x');
+            test[pos] = stops[s];
+            BOOST_CHECK(pos == P(test));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(field_value_keeps_tabs)
+{
+    for (std::size_t pos = 0; pos < 20; ++pos) {
+        std::string test(20, '~');
+        test[pos] = '\t';
+        BOOST_CHECK(20 == P(test));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(literal_match)
+{
+    const std::string input("HTTP/1.1");
+
+    const char *first = input.data();
+    BOOST_CHECK(true == http11::scan::literal(first, input.data() + input.size(), "HTTP/", 5));
+    BOOST_CHECK(input.data() + 5 == first);
+
+    std::string::const_iterator cur = input.begin();
+    BOOST_CHECK(true == http11::scan::literal(cur, input.end(), "HTTP/", 5));
+    BOOST_CHECK(input.begin() + 5 == cur);
+
+    // A short or mismatching input leaves first untouched.
+    first = input.data();
+    BOOST_CHECK(false == http11::scan::literal(first, input.data() + 3, "HTTP/", 5));
+    BOOST_CHECK(input.data() == first);
+    cur = input.begin();
+    BOOST_CHECK(false == http11::scan::literal(cur, input.end(), "HTTPS", 5));
+    BOOST_CHECK(input.begin() == cur);
+}
+
+// Version recognised by the fast path at the start of test, checking that
+// the pointer and the generic scanners agree; 0.0 when it is not taken.
+http11::version_t V(const std::string &test)
+{
+    http11::version_t fast, slow;
+    const char *first = test.data();
+    std::string::const_iterator cur = test.begin();
+
+    bool fast_hit = http11::scan::common_version(first, test.data() + test.size(), fast);
+    bool slow_hit = http11::scan::common_version(cur, test.end(), slow);
+
+    BOOST_CHECK(fast_hit == slow_hit);
+    BOOST_CHECK(fast == slow);
+    BOOST_CHECK(first - test.data() == cur - test.begin());
+    return fast;
+}
+
+BOOST_AUTO_TEST_CASE(common_versions)
+{
+    BOOST_CHECK(http11::version_t(1, 1) == V("HTTP/1.1"));
+    BOOST_CHECK(http11::version_t(1, 1) == V("HTTP/1.1\r\n"));
+    BOOST_CHECK(http11::version_t(1, 0) == V("HTTP/1.0\r\n"));
+
+    BOOST_CHECK(http11::version_t() == V("HTTP/1.10\r\n"));
+    BOOST_CHECK(http11::version_t() == V("HTTP/1.2\r\n"));
+    BOOST_CHECK(http11::version_t() == V("HTTP/2.0\r\n"));
+    BOOST_CHECK(http11::version_t() == V("http/1.1\r\n"));
+    BOOST_CHECK(http11::version_t() == V("HTTP/1."));
+}
+
+BOOST_AUTO_TEST_CASE(method_tokens)
+{
+    std::string twenty(20, 'X');
+    BOOST_CHECK(twenty.end() == http11::scan::method(twenty.begin(), twenty.end()));
+
+    std::string too_long(21, 'X');
+    BOOST_CHECK(too_long.begin() == http11::scan::method(too_long.begin(), too_long.end()));
+
+    std::string get("GET /");
+    BOOST_CHECK(get.begin() + 3 == http11::scan::method(get.begin(), get.end()));
+
+    std::string lower("get /");
+    BOOST_CHECK(lower.begin() == http11::scan::method(lower.begin(), lower.end()));
+}
+
+BOOST_AUTO_TEST_CASE(head_lines)
+{
+    const std::string input("GET /a HTTP/1.1\r\nHost: makefile.com\r\nX-A:\t b\r\n\r\n");
+    const char *first = input.data();
+    const char *last = first + input.size();
+
+    BOOST_CHECK(true == http11::scan::request_line(first, last));
+    boost::string_ref key, value;
+    BOOST_CHECK(true == http11::scan::header_line(first, last, key, value));
+    BOOST_CHECK("Host" == key);
+    BOOST_CHECK("makefile.com" == value);
+    BOOST_CHECK(true == http11::scan::header_line(first, last, key, value));
+    BOOST_CHECK("X-A" == key);
+    BOOST_CHECK("b" == value);
+
+    // the blank line ends the head
+    BOOST_CHECK(false == http11::scan::header_line(first, last, key, value));
+    BOOST_CHECK(last - 2 == first);
+
+    const std::string bad("Host makefile.com\r\n");
+    first = bad.data();
+    BOOST_CHECK(false == http11::scan::header_line(first, bad.data() + bad.size(), key, value));
+    BOOST_CHECK(bad.data() + 4 == first);
+}
+
+BOOST_AUTO_TEST_CASE(request_over_pointers)
+{
+    const char *input = "GET /a HTTP/1.1\r\nHost: makefile.com\r\nUser-Agent: x\ty\r\n";
+    const char *first = input;
+    const char *last = input + std::strlen(input);
+
+    http11::request_t req;
+    http11::request_parser<const char *> grammar(req);
+    BOOST_CHECK(true == boost::spirit::qi::parse(first, last, grammar));
+    BOOST_CHECK(last == first);
+    BOOST_CHECK(http11::version_t(1, 1) == req.version);
+    BOOST_CHECK("makefile.com" == req.headers["Host"]);
+    BOOST_CHECK("x\ty" == req.headers["User-Agent"]);
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,123 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "http11_parser.h"
+#include "http11_writer.h"
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+bool P(http11::request_t &req, const std::string &input)
+{
+    const char *first = input.data();
+    const char *last = first + input.size();
+
+    req = http11::request_t();
+    http11::request_parser<const char *> grammar(req);
+    bool pass = boost::spirit::qi::parse(first, last, grammar) && first == last - 2;
+
+    std::cerr << "TEST: |" << input << "| " << req.to_string() << std::endl;
+    return pass;
+}
+
+std::string W(const http11::request_t &req)
+{
+    char buf[512];
+    http11::buffer_writer out(buf, sizeof(buf));
+    http11::write(out, req);
+    BOOST_REQUIRE(false == out.overflow());
+    return std::string(out.data(), out.size());
+}
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+    // Headers come out in the map's order.
+    const char *tests[] = {
+        "GET / HTTP/1.1\r\n\r\n",
+        "POST /a?q=1 HTTP/1.0\r\nContent-Length: 0\r\nHost: makefile.com\r\n\r\n",
+        "GET http://[::1]:8080/x HTTP/1.1\r\nX-Test: a\tb\r\n\r\n",
+        "GET / HTTP/2.0\r\n\r\n",
+        "GET / HTTP/1.12\r\n\r\n",
+    };
+
+    http11::request_t req;
+    for (std::size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); ++i) {
+        const std::string input(tests[i]);
+        BOOST_CHECK(true == P(req, input));
+        BOOST_CHECK(input == W(req));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(normalised)
+{
+    http11::request_t req;
+    const std::string input("GET / HTTP/1.1\r\nHost:makefile.com\r\n\r\n");
+    BOOST_CHECK(true == P(req, input));
+    BOOST_CHECK("GET / HTTP/1.1\r\nHost: makefile.com\r\n\r\n" == W(req));
+}
+
+BOOST_AUTO_TEST_CASE(forwarding_with_iovecs)
+{
+    http11::request_t req;
+    const std::string input("GET /search?q=spirit HTTP/1.1\r\nHost: makefile.com\r\n\r\n");
+    BOOST_CHECK(true == P(req, input));
+
+    // A proxy rewriting one header.
+    req.headers["Host"] = "upstream.local";
+
+    iovec iov[16];
+    http11::iovec_writer out(iov, 16, input.data(), input.data() + input.size());
+    http11::write(out, req);
+    BOOST_CHECK(false == out.overflow());
+
+    // method, " ", the rest of the request line and the unchanged key
+    // with its ": " straight from the input, then value, CRLF and the
+    // final CRLF
+    BOOST_CHECK(6 == out.count());
+    BOOST_CHECK(input.data() + 4 == iov[2].iov_base);
+    BOOST_CHECK(std::string("/search?q=spirit HTTP/1.1\r\nHost: ").size() == iov[2].iov_len);
+
+    std::string joined;
+    for (std::size_t i = 0; i < out.count(); ++i) {
+        joined.append(static_cast<const char *>(iov[i].iov_base), iov[i].iov_len);
+    }
+    BOOST_CHECK("GET /search?q=spirit HTTP/1.1\r\nHost: upstream.local\r\n\r\n" == joined);
+    BOOST_CHECK(joined.size() == out.size());
+}
+
+BOOST_AUTO_TEST_CASE(unmodified_headers_from_input)
+{
+    http11::request_t req;
+    const std::string input("GET /a HTTP/1.1\r\nHost: makefile.com\r\nAccept: */*\r\nX-Long: " + std::string(200, 'x') + "\r\n\r\n");
+    BOOST_CHECK(true == P(req, input));
+
+    // method, " ", then the rest of the head straight from the input
+    iovec iov[16];
+    http11::iovec_writer out(iov, 16, input.data(), input.data() + input.size());
+    http11::write(out, req);
+    BOOST_CHECK(3 == out.count());
+    BOOST_CHECK(input.data() + 4 == iov[2].iov_base);
+    BOOST_CHECK(input.size() - 4 == iov[2].iov_len);
+
+    // a changed value is written from req.headers, its key still from the input
+    req.headers["Accept"] = "text/html";
+    http11::iovec_writer changed(iov, 16, input.data(), input.data() + input.size());
+    http11::write(changed, req);
+    BOOST_CHECK(input.data() + 4 == iov[2].iov_base);
+    BOOST_CHECK(std::string("/a HTTP/1.1\r\nHost: makefile.com\r\nAccept: ").size() == iov[2].iov_len);
+    BOOST_CHECK(req.headers["Accept"].data() == iov[3].iov_base);
+
+    std::string joined;
+    for (std::size_t i = 0; i < changed.count(); ++i) {
+        joined.append(static_cast<const char *>(iov[i].iov_base), iov[i].iov_len);
+    }
+    BOOST_CHECK("GET /a HTTP/1.1\r\nHost: makefile.com\r\nAccept: text/html\r\nX-Long: " + std::string(200, 'x') + "\r\n\r\n" == joined);
+}
+
+BOOST_AUTO_TEST_CASE(to_string_output)
+{
+    http11::request_t req;
+    BOOST_CHECK(true == P(req, "GET / HTTP/1.1\r\nHost: makefile.com\r\n\r\n"));
+    BOOST_CHECK(std::string::npos != req.to_string().find("headers:"));
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,145 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "http_date.h"
+
+#include <cstdlib>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+bool P(const std::string &test, std::time_t &out)
+{
+    bool result = http11::parse_http_date(test, out);
+    std::cerr << "TEST: |" << test << "| " << (result ? "valid" : "invalid") << std::endl;
+    return result;
+}
+
+bool P(const std::string &test)
+{
+    std::time_t out;
+    return P(test, out);
+}
+
+BOOST_AUTO_TEST_CASE(formats)
+{
+    // RFC 7231 section 7.1.1.1, all the same instant
+    std::time_t t = 0;
+    BOOST_CHECK(true == P("Sun, 06 Nov 1994 08:49:37 GMT", t));
+    BOOST_CHECK(784111777 == t);
+    t = 0;
+    BOOST_CHECK(true == P("Sunday, 06-Nov-94 08:49:37 GMT", t));
+    BOOST_CHECK(784111777 == t);
+    t = 0;
+    BOOST_CHECK(true == P("Sun Nov  6 08:49:37 1994", t));
+    BOOST_CHECK(784111777 == t);
+    BOOST_CHECK(true == P("Sun Nov 16 08:49:37 1994", t));
+    BOOST_CHECK(784111777 + 10 * 86400 == t);
+
+    BOOST_CHECK(true == P("Thu, 01 Jan 1970 00:00:00 GMT", t));
+    BOOST_CHECK(0 == t);
+    BOOST_CHECK(true == P("Fri, 31 Dec 1999 23:59:59 GMT", t));
+    BOOST_CHECK(946684799 == t);
+    BOOST_CHECK(true == P("Tue, 29 Feb 2000 12:00:00 GMT", t));
+    BOOST_CHECK(951825600 == t);
+    BOOST_CHECK(true == P("Wed, 01 Jan 2100 00:00:00 GMT \t", t));
+    BOOST_CHECK(4102444800 == t);
+
+    // a leap second runs into the next minute
+    BOOST_CHECK(true == P("Wed, 31 Dec 2008 23:59:60 GMT", t));
+    BOOST_CHECK(1230768000 == t);
+}
+
+BOOST_AUTO_TEST_CASE(invalid)
+{
+    BOOST_CHECK(false == P(""));
+    BOOST_CHECK(false == P("Sun, 6 Nov 1994 08:49:37 GMT"));
+    BOOST_CHECK(false == P("Sun, 06 Nov 94 08:49:37 GMT"));
+    BOOST_CHECK(false == P("Sun, 06 nov 1994 08:49:37 GMT"));
+    BOOST_CHECK(false == P("sun, 06 Nov 1994 08:49:37 GMT"));
+    BOOST_CHECK(false == P("Sun, 06 Nov 1994 08:49:37 gmt"));
+    BOOST_CHECK(false == P("Sun, 06 Nov 1994 08:49:37 UTC"));
+    BOOST_CHECK(false == P("Sun, 06 Nov 1994 08:49:37 +0000"));
+    BOOST_CHECK(false == P("Sun,  06 Nov 1994 08:49:37 GMT"));
+    BOOST_CHECK(false == P(" Sun, 06 Nov 1994 08:49:37 GMT"));
+    BOOST_CHECK(false == P("Sun, 06 Nov 1994 08:49:37 GMTx"));
+    BOOST_CHECK(false == P("Sun, 06 Nov 1994 08:49 GMT"));
+    BOOST_CHECK(false == P("Sun, 06 Nov 1994 24:00:00 GMT"));
+    BOOST_CHECK(false == P("Sun, 06 Nov 1994 08:60:00 GMT"));
+    BOOST_CHECK(false == P("Sun, 06 Nov 1994 08:49:61 GMT"));
+    BOOST_CHECK(false == P("Sun, 00 Nov 1994 08:49:37 GMT"));
+    BOOST_CHECK(false == P("Sun, 31 Nov 1994 08:49:37 GMT"));
+    BOOST_CHECK(false == P("Sun, 29 Feb 1900 08:49:37 GMT"));
+    BOOST_CHECK(false == P("Sun, 29 Feb 2100 08:49:37 GMT"));
+    BOOST_CHECK(false == P("Sun, 06 Nov 1994 08:49:37 GMT; length=1234"));
+    BOOST_CHECK(false == P("Sun, 06-Nov-94 08:49:37 GMT"));
+    BOOST_CHECK(false == P("Sunday, 06-Nov-1994 08:49:37 GMT"));
+    BOOST_CHECK(false == P("Sun Nov 6 08:49:37 1994"));
+    BOOST_CHECK(false == P("Sun Nov  6 08:49:37 1994 GMT"));
+    BOOST_CHECK(false == P("784111777"));
+}
+
+BOOST_AUTO_TEST_CASE(rfc850_year)
+{
+    // a two digit year is at most 50 years ahead of this one
+    std::time_t now = std::time(0);
+    std::tm utc;
+    gmtime_r(&now, &utc);
+    int this_year = utc.tm_year + 1900;
+
+    for (int yy = 0; yy < 100; ++yy) {
+        char value[64];
+        std::snprintf(value, sizeof(value), "Monday, 01-Jan-%02d 00:00:00 GMT", yy);
+        std::time_t t;
+        BOOST_CHECK(true == P(value, t));
+        std::tm parsed;
+        gmtime_r(&t, &parsed);
+        int year = parsed.tm_year + 1900;
+        BOOST_CHECK(yy == year % 100);
+        BOOST_CHECK(year <= this_year + 50);
+        BOOST_CHECK(year > this_year + 50 - 100);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(matches_gmtime)
+{
+    // formatted by strftime, as servers write Last-Modified
+    std::srand(48);
+    for (int i = 0; i < 2000; ++i) {
+        std::time_t expected = static_cast<std::time_t>(std::rand()) * 2 % 4102444800LL;
+        std::tm utc;
+        gmtime_r(&expected, &utc);
+        char imf[64], asctime[64];
+        std::strftime(imf, sizeof(imf), "%a, %d %b %Y %H:%M:%S GMT", &utc);
+        std::strftime(asctime, sizeof(asctime), "%a %b %e %H:%M:%S %Y", &utc);
+
+        std::time_t t = -1;
+        BOOST_CHECK(true == http11::parse_http_date(imf, t));
+        BOOST_CHECK(expected == t);
+        t = -1;
+        BOOST_CHECK(true == http11::parse_http_date(asctime, t));
+        BOOST_CHECK(expected == t);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cache)
+{
+    // a repeat is answered from the cache, a different value is not
+    std::time_t t;
+    BOOST_CHECK(true == P("Sun, 06 Nov 1994 08:49:37 GMT", t));
+    BOOST_CHECK(true == P("Sun, 06 Nov 1994 08:49:37 GMT", t));
+    BOOST_CHECK(784111777 == t);
+    BOOST_CHECK(true == P("Sun, 06 Nov 1994 08:49:38 GMT", t));
+    BOOST_CHECK(784111778 == t);
+    BOOST_CHECK(true == P("Sun Nov  6 08:49:37 1994", t));
+    BOOST_CHECK(784111777 == t);
+    BOOST_CHECK(true == P("Sun, 06 Nov 1994 08:49:38 GMT", t));
+    BOOST_CHECK(784111778 == t);
+
+    // an invalid value of the same length does not touch the cache
+    BOOST_CHECK(false == P("Sun, 06 Nov 1994 08:49:99 GMT", t));
+    BOOST_CHECK(784111778 == t);
+    BOOST_CHECK(true == P("Sun, 06 Nov 1994 08:49:38 GMT", t));
+    BOOST_CHECK(784111778 == t);
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
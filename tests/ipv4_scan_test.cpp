@@ -0,0 +1,205 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "ipv4_address.h"
+#include "ipv4_scan.h"
+
+#include <arpa/inet.h>
+
+#include <cstdlib>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+namespace qi = boost::spirit::qi;
+
+// Bytes ipv4_address consumes at the start of test, -1 when it fails.
+int P(const std::string &test)
+{
+    static uri::ipv4_address<const char *> grammar;
+
+    const char *first = test.data();
+    std::string parsed;
+    if (!qi::parse(first, test.data() + test.size(), grammar, parsed)) {
+        return -1;
+    }
+    return static_cast<int>(first - test.data());
+}
+
+// Bytes scan::ipv4 consumes at the start of test, -1 when it fails.
+int S(const std::string &test, uint32_t &addr)
+{
+    const char *first = test.data();
+    if (!uri::scan::ipv4(first, test.data() + test.size(), addr)) {
+        return -1;
+    }
+    return static_cast<int>(first - test.data());
+}
+
+// Octets around every edge of the dec_octet alternation.
+std::vector<std::string> inputs()
+{
+    const char *octets[] = {
+        "", "0", "00", "000", "0000", "1", "09", "2", "24", "25", "99", "199",
+        "249", "250", "255", "256", "260", "299", "300", "1000", "a"
+    };
+    const char *suffixes[] = { "", "a", "5", ".", "/24" };
+    const std::size_t n = sizeof(octets) / sizeof(octets[0]);
+
+    std::vector<std::string> all;
+    for (std::size_t a = 0; a < n; ++a) {
+        for (std::size_t b = 0; b < n; ++b) {
+            for (std::size_t c = 0; c < n; ++c) {
+                for (std::size_t d = 0; d < n; ++d) {
+                    std::string s = std::string(octets[a]) + '.' + octets[b] + '.' + octets[c] + '.' + octets[d];
+                    for (std::size_t x = 0; x < sizeof(suffixes) / sizeof(suffixes[0]); ++x) {
+                        all.push_back(s + suffixes[x]);
+                    }
+                }
+            }
+        }
+    }
+
+    // and noise, mostly dots and digits
+    std::srand(44);
+    const char alphabet[] = "0123459..a ";
+    for (int i = 0; i < 100000; ++i) {
+        std::string s(std::rand() % 17, ' ');
+        for (std::size_t j = 0; j < s.size(); ++j) {
+            s[j] = alphabet[std::rand() % (sizeof(alphabet) - 1)];
+        }
+        all.push_back(s);
+    }
+    return all;
+}
+
+BOOST_AUTO_TEST_CASE(scan_matches_the_grammar)
+{
+    std::vector<std::string> all = inputs();
+    std::size_t mismatches = 0;
+    std::size_t addresses = 0;
+    for (std::size_t i = 0; i < all.size(); ++i) {
+        const std::string &s = all[i];
+        int expected = P(s);
+
+        uint32_t addr = 0;
+        int got = S(s, addr);
+        if (got != expected) {
+            std::cerr << "scan::ipv4 mismatch on |" << s << "|: " << got << " vs " << expected << std::endl;
+            ++mismatches;
+        }
+
+        bool whole = expected == static_cast<int>(s.size());
+        uint32_t fast = 0;
+        if (uri::parse_ipv4(s.data(), s.data() + s.size(), fast) != whole) {
+            std::cerr << "parse_ipv4 mismatch on |" << s << "|" << std::endl;
+            ++mismatches;
+        }
+        uint32_t slow = 0;
+        if (uri::scan::detail::ipv4_scalar(s.data(), s.data() + s.size(), slow) != whole) {
+            std::cerr << "ipv4_scalar mismatch on |" << s << "|" << std::endl;
+            ++mismatches;
+        }
+        if (whole) {
+            ++addresses;
+            if (fast != addr || slow != addr) {
+                std::cerr << "value mismatch on |" << s << "|" << std::endl;
+                ++mismatches;
+            }
+        }
+    }
+    BOOST_CHECK(0 == mismatches);
+    BOOST_CHECK(addresses > 10000);
+}
+
+BOOST_AUTO_TEST_CASE(values)
+{
+    const char *tests[] = { "0.0.0.0", "255.255.255.255", "1.2.3.4", "10.20.30.40", "199.255.39.49", "192.168.100.1" };
+    for (std::size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); ++i) {
+        std::string s = tests[i];
+        in_addr expected;
+        BOOST_CHECK(1 == inet_pton(AF_INET, s.c_str(), &expected));
+
+        uint32_t addr = 0;
+        BOOST_CHECK(true == uri::parse_ipv4(s.data(), s.data() + s.size(), addr));
+        BOOST_CHECK(ntohl(expected.s_addr) == addr);
+    }
+
+    uint32_t addr = 0;
+    std::string zeros = "001.002.003.004";
+    BOOST_CHECK(true == uri::parse_ipv4(zeros.data(), zeros.data() + zeros.size(), addr));
+    BOOST_CHECK(0x01020304 == addr);
+}
+
+BOOST_AUTO_TEST_CASE(spans)
+{
+    std::vector<std::string> all = inputs();
+    all.resize(200);  // over three bit set words
+
+    std::vector<boost::string_ref> spans;
+    for (std::size_t i = 0; i < all.size(); ++i) {
+        spans.push_back(all[i]);
+    }
+    std::vector<uint32_t> addrs(all.size());
+    std::vector<uint64_t> valid((all.size() + 63) / 64);
+
+    std::size_t found = uri::parse_ipv4(spans.data(), spans.size(), addrs.data(), valid.data());
+
+    std::size_t expected = 0;
+    for (std::size_t i = 0; i < all.size(); ++i) {
+        bool whole = P(all[i]) == static_cast<int>(all[i].size());
+        expected += whole;
+        BOOST_CHECK(whole == bool(valid[i / 64] >> (i % 64) & 1));
+    }
+    BOOST_CHECK(expected == found);
+    BOOST_CHECK(0x00000000 == addrs[0] || !(valid[0] & 1));
+}
+
+BOOST_AUTO_TEST_CASE(delimited)
+{
+    std::string buffer = "1.2.3.4\n255.255.255.255\n256.1.1.1\n\n10.0.0.1\n001.02.3.4\n1.2.3.4a\n192.168.0.1";
+    const char *first = buffer.data();
+    const char *last = buffer.data() + buffer.size();
+
+    uint32_t addrs[8];
+    uint64_t valid[1];
+    BOOST_CHECK(3 == uri::parse_ipv4(first, last, '\n', addrs, valid, 3));
+    BOOST_CHECK(0x3 == valid[0]);
+    BOOST_CHECK(0x01020304 == addrs[0]);
+    BOOST_CHECK(0xffffffff == addrs[1]);
+    BOOST_CHECK(first == buffer.data() + buffer.find("\n\n") + 1);
+
+    BOOST_CHECK(5 == uri::parse_ipv4(first, last, '\n', addrs, valid, 8));
+    BOOST_CHECK(0x16 == valid[0]);
+    BOOST_CHECK(0x0a000001 == addrs[1]);
+    BOOST_CHECK(0x01020304 == addrs[2]);
+    BOOST_CHECK(0xc0a80001 == addrs[4]);
+    BOOST_CHECK(first == last);
+
+    // a trailing delimiter ends the last field
+    std::string lines = "1.2.3.4\n5.6.7.8\n";
+    first = lines.data();
+    BOOST_CHECK(2 == uri::parse_ipv4(first, lines.data() + lines.size(), '\n', addrs, valid, 8));
+    BOOST_CHECK(0x3 == valid[0]);
+    BOOST_CHECK(0x05060708 == addrs[1]);
+}
+
+BOOST_AUTO_TEST_CASE(delimited_many)
+{
+    std::string buffer;
+    for (int i = 0; i < 150; ++i) {
+        buffer += "10.0." + std::to_string(i / 10) + "." + std::to_string(i) + (i % 7 == 3 ? "0" : "") + ",";
+    }
+    const char *first = buffer.data();
+    std::vector<uint32_t> addrs(150);
+    std::vector<uint64_t> valid(3);
+    BOOST_CHECK(150 == uri::parse_ipv4(first, buffer.data() + buffer.size(), ',', addrs.data(), valid.data(), 150));
+    for (int i = 0; i < 150; ++i) {
+        int octet = i * (i % 7 == 3 ? 10 : 1);
+        BOOST_CHECK((octet <= 255) == bool(valid[i / 64] >> (i % 64) & 1));
+        if (octet <= 255) {
+            BOOST_CHECK(static_cast<uint32_t>(0x0a000000 | (i / 10) << 8 | octet) == addrs[i]);
+        }
+    }
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,130 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "parser_pool.h"
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+template <typename Pool>
+bool P(typename Pool::lease &parser, const std::string &input)
+{
+    const char *first = input.data();
+    const char *last = first + input.size();
+    return parser.parse(first, last) && first == last;
+}
+
+BOOST_AUTO_TEST_CASE(sequential_checkouts_reuse_a_slot)
+{
+    uri::uri_pool pool;
+    BOOST_CHECK(0 == pool.size());
+
+    const std::string input("http://makefile.com:8080/a?q#f");
+    for (int i = 0; i < 10; ++i) {
+        uri::uri_pool::lease parser = pool.checkout();
+        BOOST_CHECK(true == P<uri::uri_pool>(parser, input));
+        BOOST_CHECK("makefile.com" == parser.result().host);
+        BOOST_CHECK(8080 == parser.result().port_number);
+    }
+    BOOST_CHECK(1 == pool.size());
+
+    // The result is reset between parses.
+    const std::string relative("/b");
+    uri::uri_pool::lease parser = pool.checkout();
+    BOOST_CHECK(true == P<uri::uri_pool>(parser, relative));
+    BOOST_CHECK(false == parser.result().host.defined());
+    BOOST_CHECK(0 == parser.result().port_number);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_leases_get_their_own_grammar)
+{
+    http11::request_pool pool(2);
+    BOOST_CHECK(2 == pool.size());
+
+    http11::request_pool::lease a = pool.checkout();
+    http11::request_pool::lease b = pool.checkout();
+    // (the grammars are proto expressions, so no unary &)
+    BOOST_CHECK(boost::addressof(a.grammar()) != boost::addressof(b.grammar()));
+    BOOST_CHECK(2 == pool.size());
+
+    {
+        http11::request_pool::lease c = pool.checkout();
+        BOOST_CHECK(3 == pool.size());
+    }
+
+    // Returned leases are handed out again rather than building a new one.
+    http11::request_pool::lease d = pool.checkout();
+    BOOST_CHECK(3 == pool.size());
+
+    http11::request_pool::lease moved(std::move(d));
+    const std::string input("GET / HTTP/1.1\r\n");
+    BOOST_CHECK(true == P<http11::request_pool>(moved, input));
+    BOOST_CHECK("GET" == moved.result().method);
+}
+
+BOOST_AUTO_TEST_CASE(returned_on_another_thread)
+{
+    // Whichever CPU's list a grammar went back to, a checkout finds it
+    // before building another.
+    uri::uri_pool pool;
+    for (int i = 0; i < 4; ++i) {
+        std::thread([&pool] { pool.checkout(); }).join();
+        uri::uri_pool::lease parser = pool.checkout();
+    }
+    BOOST_CHECK(1 == pool.size());
+
+    uri::uri_pool preallocated(3);
+    {
+        uri::uri_pool::lease a = preallocated.checkout();
+        uri::uri_pool::lease b = preallocated.checkout();
+        uri::uri_pool::lease c = preallocated.checkout();
+    }
+    BOOST_CHECK(3 == preallocated.size());
+}
+
+BOOST_AUTO_TEST_CASE(threads)
+{
+    http11::request_pool pool;
+
+    const int thread_count = 8;
+    const int requests = 2000;
+    std::vector<int> failures(thread_count, 0);
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < thread_count; ++t) {
+        workers.push_back(std::thread([&pool, &failures, t] {
+            char input[128];
+            for (int i = 0; i < requests; ++i) {
+                int n = std::sprintf(input, "GET /t%d/%d HTTP/1.1\r\nHost: host%d.makefile.com\r\n", t, i, t);
+                const char *first = input;
+                const char *last = input + n;
+
+                // One checkout per request, the worst case for contention.
+                http11::request_pool::lease parser = pool.checkout();
+                char path[32], host[32];
+                std::sprintf(path, "/t%d/%d", t, i);
+                std::sprintf(host, "host%d.makefile.com", t);
+                if (!parser.parse(first, last) || first != last
+                    || parser.result().uri.path != path
+                    || parser.result().headers["Host"] != host) {
+                    ++failures[t];
+                }
+            }
+        }));
+    }
+    for (int t = 0; t < thread_count; ++t) {
+        workers[t].join();
+    }
+
+    for (int t = 0; t < thread_count; ++t) {
+        BOOST_CHECK(0 == failures[t]);
+    }
+    // Never more grammars than threads using them at once.
+    BOOST_CHECK(pool.size() >= 1);
+    BOOST_CHECK(pool.size() <= static_cast<std::size_t>(thread_count));
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,167 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "prefix_table.h"
+
+#include <cstdlib>
+#include <cstring>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+uri::cidr_t V4(uint32_t address, unsigned length)
+{
+    uri::cidr_t c;
+    c.assign(address, length);
+    return c;
+}
+
+uri::cidr_t V6(const char *text, unsigned length)
+{
+    uri::cidr_t c;
+    uint8_t bytes[16];
+    uri::parse_ipv6(text, text + std::strlen(text), bytes);
+    c.assign(uri::cidr_t::family_ipv6, bytes, length);
+    return c;
+}
+
+uint32_t M6(const uri::prefix_table &table, const char *text)
+{
+    uint8_t bytes[16];
+    uri::parse_ipv6(text, text + std::strlen(text), bytes);
+    return table.match(bytes);
+}
+
+// What the table must agree with: the longest of the prefixes holding it.
+struct reference_t
+{
+    std::vector<std::pair<uri::cidr_t, uint32_t> > prefixes;
+
+    uint32_t match(uint32_t address) const
+    {
+        int best = -1;
+        uint32_t value = uri::prefix_table::no_match;
+        for (std::size_t i = 0; i < prefixes.size(); ++i) {
+            const uri::cidr_t &c = prefixes[i].first;
+            uint32_t mask = c.length ? ~uint32_t(0) << (32 - c.length) : 0;
+            if ((address & mask) == c.ipv4() && static_cast<int>(c.length) >= best) {
+                best = c.length;
+                value = prefixes[i].second;
+            }
+        }
+        return value;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(empty)
+{
+    uri::prefix_table table;
+    BOOST_CHECK(0 == table.size());
+    BOOST_CHECK(uri::prefix_table::no_match == table.match(0x0a000001));
+    BOOST_CHECK(uri::prefix_table::no_match == M6(table, "::1"));
+}
+
+BOOST_AUTO_TEST_CASE(ipv4_longest_prefix)
+{
+    uri::prefix_table table;
+    table.add(V4(0x0a000000, 8), 1);    // 10/8
+    table.add(V4(0x0a010000, 16), 2);   // 10.1/16
+    table.add(V4(0x0a010200, 24), 3);   // 10.1.2/24
+    table.add(V4(0x0a010203, 32), 4);   // 10.1.2.3/32
+    table.add(V4(0x0a010280, 25), 5);   // 10.1.2.128/25
+    table.add(V4(0xc0a80000, 16), 6);   // 192.168/16
+    table.build();
+
+    BOOST_CHECK(6 == table.size());
+    BOOST_CHECK(1 == table.match(0x0a000001));
+    BOOST_CHECK(1 == table.match(0x0aff0001));
+    BOOST_CHECK(2 == table.match(0x0a01ff01));
+    BOOST_CHECK(3 == table.match(0x0a010201));
+    BOOST_CHECK(4 == table.match(0x0a010203));
+    BOOST_CHECK(3 == table.match(0x0a010204));
+    BOOST_CHECK(5 == table.match(0x0a010281));
+    BOOST_CHECK(6 == table.match(0xc0a8ffff));
+    BOOST_CHECK(uri::prefix_table::no_match == table.match(0x0b000000));
+    BOOST_CHECK(uri::prefix_table::no_match == table.match(0xc0a90000));
+
+    // not visible until built again
+    table.add(V4(0, 0), 7);
+    BOOST_CHECK(uri::prefix_table::no_match == table.match(0x0b000000));
+    table.build();
+    BOOST_CHECK(7 == table.match(0x0b000000));
+    BOOST_CHECK(4 == table.match(0x0a010203));
+
+    // replacing a value
+    table.add(V4(0x0a010200, 24), 8);
+    table.build();
+    BOOST_CHECK(7 == table.size());
+    BOOST_CHECK(8 == table.match(0x0a010201));
+
+    table.clear();
+    BOOST_CHECK(0 == table.size());
+    BOOST_CHECK(uri::prefix_table::no_match == table.match(0x0a010201));
+}
+
+BOOST_AUTO_TEST_CASE(ipv6_longest_prefix)
+{
+    uri::prefix_table table;
+    table.add(V6("2001:db8::", 32), 1);
+    table.add(V6("2001:db8:1::", 48), 2);
+    table.add(V6("2001:db8:1:2::", 64), 3);
+    table.add(V6("2001:db8:1:2::1", 128), 4);
+    table.add(V6("fe80::", 10), 5);
+    table.add(V4(0x0a000000, 8), 6);
+    table.build();
+
+    BOOST_CHECK(6 == table.size());
+    BOOST_CHECK(1 == M6(table, "2001:db8:ffff::1"));
+    BOOST_CHECK(2 == M6(table, "2001:db8:1:ffff::1"));
+    BOOST_CHECK(3 == M6(table, "2001:db8:1:2::2"));
+    BOOST_CHECK(4 == M6(table, "2001:db8:1:2::1"));
+    BOOST_CHECK(5 == M6(table, "febf::1"));
+    BOOST_CHECK(uri::prefix_table::no_match == M6(table, "fec0::1"));
+    BOOST_CHECK(uri::prefix_table::no_match == M6(table, "2001:db9::1"));
+    BOOST_CHECK(6 == table.match(0x0a000001));
+    BOOST_CHECK(uri::prefix_table::no_match == M6(table, "::ffff:10.0.0.1"));
+}
+
+BOOST_AUTO_TEST_CASE(ipv4_against_reference)
+{
+    std::srand(45);
+    reference_t reference;
+    uri::prefix_table table;
+    for (int i = 0; i < 3000; ++i) {
+        // clustered, so prefixes nest
+        uint32_t address = (0x0a000000 | (std::rand() & 0xffff) << 8 | (std::rand() & 0xff)) ^ (std::rand() % 4) << 30;
+        unsigned length = std::rand() % 33;
+        uri::cidr_t c = V4(address, length);
+        uint32_t value = std::rand() % 1000;
+
+        bool replaced = false;
+        for (std::size_t j = 0; j < reference.prefixes.size(); ++j) {
+            if (reference.prefixes[j].first == c) {
+                reference.prefixes[j].second = value;
+                replaced = true;
+            }
+        }
+        if (!replaced) {
+            reference.prefixes.push_back(std::make_pair(c, value));
+        }
+        table.add(c, value);
+    }
+    table.build();
+    BOOST_CHECK(reference.prefixes.size() == table.size());
+
+    std::size_t mismatches = 0;
+    for (int i = 0; i < 20000; ++i) {
+        uint32_t address = (0x0a000000 | (std::rand() & 0xffff) << 8 | (std::rand() & 0xff)) ^ (std::rand() % 4) << 30;
+        if (i % 2) {
+            address = reference.prefixes[i % reference.prefixes.size()].first.ipv4() | (std::rand() & 0x3f);
+        }
+        if (table.match(address) != reference.match(address)) {
+            ++mismatches;
+        }
+    }
+    BOOST_CHECK(0 == mismatches);
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,195 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "proxy_protocol.h"
+#include "spirit_parsers.h"
+
+#include <arpa/inet.h>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+using http11::proxy_header_t;
+
+http11::proxy_status_t P(const std::string &test, proxy_header_t &out, std::size_t &consumed)
+{
+    const char *first = test.data();
+    http11::proxy_status_t status = http11::parse_proxy_header(first, test.data() + test.size(), out);
+    consumed = first - test.data();
+    return status;
+}
+
+http11::proxy_status_t P(const std::string &test)
+{
+    proxy_header_t out;
+    std::size_t consumed;
+    return P(test, out, consumed);
+}
+
+uri::ip_address_t A(const char *text)
+{
+    uri::ip_address_t a;
+    uint8_t bytes[16];
+    if (inet_pton(AF_INET, text, bytes) == 1) {
+        a.assign(static_cast<uint32_t>(bytes[0]) << 24 | bytes[1] << 16 | bytes[2] << 8 | bytes[3]);
+    }
+    else if (inet_pton(AF_INET6, text, bytes) == 1) {
+        a.assign(bytes);
+    }
+    return a;
+}
+
+const char request[] = "GET /index.html HTTP/1.1\r\nHost: www.makefile.com\r\n\r\n";
+
+BOOST_AUTO_TEST_CASE(version_1)
+{
+    proxy_header_t h;
+    std::size_t consumed;
+
+    std::string tcp4 = "PROXY TCP4 192.0.2.1 198.51.100.2 56324 443\r\n";
+    BOOST_CHECK(http11::proxy_ok == P(tcp4 + request, h, consumed));
+    BOOST_CHECK(tcp4.size() == consumed);
+    BOOST_CHECK(tcp4.size() == h.size);
+    BOOST_CHECK(1 == h.version);
+    BOOST_CHECK(proxy_header_t::command_proxy == h.command);
+    BOOST_CHECK(proxy_header_t::transport_stream == h.transport);
+    BOOST_CHECK(A("192.0.2.1") == h.source);
+    BOOST_CHECK(A("198.51.100.2") == h.destination);
+    BOOST_CHECK(56324 == h.source_port);
+    BOOST_CHECK(443 == h.destination_port);
+
+    std::string tcp6 = "PROXY TCP6 2001:db8:85a3::8a2e:370:7334 ::1 0 65535\r\n";
+    BOOST_CHECK(http11::proxy_ok == P(tcp6, h, consumed));
+    BOOST_CHECK(tcp6.size() == consumed);
+    BOOST_CHECK(A("2001:db8:85a3::8a2e:370:7334") == h.source);
+    BOOST_CHECK(A("::1") == h.destination);
+    BOOST_CHECK(0 == h.source_port);
+    BOOST_CHECK(65535 == h.destination_port);
+
+    BOOST_CHECK(http11::proxy_ok == P("PROXY UNKNOWN\r\n", h, consumed));
+    BOOST_CHECK(proxy_header_t::transport_unspec == h.transport);
+    BOOST_CHECK(uri::ip_address_t::family_none == h.source.family);
+    BOOST_CHECK(http11::proxy_ok == P("PROXY UNKNOWN ffff:f...f:ffff 1.2.3.4 65535 65535\r\n"));
+
+    BOOST_CHECK(http11::proxy_bad == P("PROXY TCP4 192.0.2.1 198.51.100.2 56324 65536\r\n"));
+    BOOST_CHECK(http11::proxy_bad == P("PROXY TCP4 192.0.2.1 198.51.100.2 056324 443\r\n"));
+    BOOST_CHECK(http11::proxy_bad == P("PROXY TCP4 2001:db8::1 198.51.100.2 56324 443\r\n"));
+    BOOST_CHECK(http11::proxy_bad == P("PROXY TCP6 192.0.2.1 198.51.100.2 56324 443\r\n"));
+    BOOST_CHECK(http11::proxy_bad == P("PROXY TCP4 192.0.2.1  198.51.100.2 56324 443\r\n"));
+    BOOST_CHECK(http11::proxy_bad == P("PROXY TCP4 192.0.2.1 198.51.100.2 56324 443\n"));
+    BOOST_CHECK(http11::proxy_bad == P("PROXY TCP4 192.0.2.1 198.51.100.2 56324 443 \r\n"));
+    BOOST_CHECK(http11::proxy_bad == P("PROXY UDP4 192.0.2.1 198.51.100.2 56324 443\r\n"));
+    BOOST_CHECK(http11::proxy_bad == P("PROXY UNKNOWN " + std::string(100, 'x') + "\r\n"));
+    BOOST_CHECK(http11::proxy_bad == P("PROXY " + std::string(120, 'x')));
+}
+
+BOOST_AUTO_TEST_CASE(incomplete_and_none)
+{
+    std::string tcp4 = "PROXY TCP4 192.0.2.1 198.51.100.2 56324 443\r\n";
+    for (std::size_t i = 0; i < tcp4.size(); ++i) {
+        BOOST_CHECK(http11::proxy_incomplete == P(tcp4.substr(0, i)));
+    }
+
+    BOOST_CHECK(http11::proxy_none == P(request));
+    BOOST_CHECK(http11::proxy_none == P("PROXYTCP4"));
+    BOOST_CHECK(http11::proxy_none == P("\r\nGET / HTTP/1.1\r\n\r\n"));
+}
+
+// A version 2 header: signature, version and command, family and
+// transport, then the address block and TLVs.
+std::string V2(unsigned char command, unsigned char family, const std::string &body)
+{
+    std::string h("\r\n\r\n\0\r\nQUIT\n", 12);
+    h += static_cast<char>(0x20 | command);
+    h += static_cast<char>(family);
+    h += static_cast<char>(body.size() >> 8);
+    h += static_cast<char>(body.size() & 0xff);
+    return h + body;
+}
+
+BOOST_AUTO_TEST_CASE(version_2)
+{
+    proxy_header_t h;
+    std::size_t consumed;
+
+    // TCP over IPv4 with an ALPN and an authority TLV
+    std::string inet("\xc0\x00\x02\x01" "\xc6\x33\x64\x02" "\xdc\x04" "\x01\xbb", 12);
+    std::string tlvs = std::string("\x01\x00\x02" "h2", 5) + std::string("\x02\x00\x10" "www.makefile.com", 19);
+    std::string v2 = V2(1, 0x11, inet + tlvs);
+    BOOST_CHECK(http11::proxy_ok == P(v2 + request, h, consumed));
+    BOOST_CHECK(v2.size() == consumed);
+    BOOST_CHECK(2 == h.version);
+    BOOST_CHECK(proxy_header_t::command_proxy == h.command);
+    BOOST_CHECK(proxy_header_t::transport_stream == h.transport);
+    BOOST_CHECK(A("192.0.2.1") == h.source);
+    BOOST_CHECK(A("198.51.100.2") == h.destination);
+    BOOST_CHECK(56324 == h.source_port);
+    BOOST_CHECK(443 == h.destination_port);
+
+    boost::string_ref rest = h.tlvs;
+    http11::proxy_tlv_t tlv;
+    BOOST_CHECK(true == http11::next_tlv(rest, tlv));
+    BOOST_CHECK(0x01 == tlv.type);
+    BOOST_CHECK("h2" == tlv.value);
+    BOOST_CHECK(true == http11::next_tlv(rest, tlv));
+    BOOST_CHECK(0x02 == tlv.type);
+    BOOST_CHECK("www.makefile.com" == tlv.value);
+    BOOST_CHECK(false == http11::next_tlv(rest, tlv));
+
+    // UDP over IPv6
+    std::string inet6(36, '\0');
+    inet6[0] = 0x20; inet6[1] = 0x01; inet6[2] = 0x0d; inet6[3] = static_cast<char>(0xb8); inet6[15] = 1;
+    inet6[31] = 1;
+    inet6[32] = 0x00; inet6[33] = 0x35; inet6[34] = 0x30; inet6[35] = 0x39;
+    BOOST_CHECK(http11::proxy_ok == P(V2(1, 0x22, inet6), h, consumed));
+    BOOST_CHECK(proxy_header_t::transport_dgram == h.transport);
+    BOOST_CHECK(A("2001:db8::1") == h.source);
+    BOOST_CHECK(A("::1") == h.destination);
+    BOOST_CHECK(53 == h.source_port);
+    BOOST_CHECK(12345 == h.destination_port);
+    BOOST_CHECK(h.tlvs.empty());
+
+    // AF_UNIX
+    std::string paths(216, '\0');
+    paths.replace(0, 13, "/run/lb.sock1");
+    paths.replace(108, 13, "/run/lb.sock2");
+    BOOST_CHECK(http11::proxy_ok == P(V2(1, 0x31, paths), h, consumed));
+    BOOST_CHECK("/run/lb.sock1" == h.source_path);
+    BOOST_CHECK("/run/lb.sock2" == h.destination_path);
+    BOOST_CHECK(uri::ip_address_t::family_none == h.source.family);
+
+    // LOCAL, from the proxy itself, with no addresses
+    BOOST_CHECK(http11::proxy_ok == P(V2(0, 0x00, "") + request, h, consumed));
+    BOOST_CHECK(16 == consumed);
+    BOOST_CHECK(proxy_header_t::command_local == h.command);
+
+    // every prefix is incomplete
+    for (std::size_t i = 0; i < v2.size(); ++i) {
+        BOOST_CHECK(http11::proxy_incomplete == P(v2.substr(0, i)));
+    }
+
+    BOOST_CHECK(http11::proxy_bad == P(V2(2, 0x11, inet)));
+    BOOST_CHECK(http11::proxy_bad == P(V2(1, 0x41, inet)));
+    BOOST_CHECK(http11::proxy_bad == P(V2(1, 0x13, inet)));
+    BOOST_CHECK(http11::proxy_bad == P(V2(1, 0x21, inet)));
+    std::string version3 = V2(1, 0x11, inet);
+    version3[12] = 0x31;
+    BOOST_CHECK(http11::proxy_bad == P(version3));
+}
+
+BOOST_AUTO_TEST_CASE(request_follows)
+{
+    std::string input = "PROXY TCP4 192.0.2.1 198.51.100.2 56324 443\r\n" + std::string(request);
+    const char *first = input.data();
+    const char *last = input.data() + input.size();
+
+    proxy_header_t proxy;
+    BOOST_CHECK(http11::proxy_ok == http11::parse_proxy_header(first, last, proxy));
+
+    http11::request_t req;
+    BOOST_CHECK(true == http11::parse_request(first, last, req));
+    BOOST_CHECK("\r\n" == std::string(first, last));  // the grammar leaves the blank line
+    BOOST_CHECK("GET" == req.method);
+    BOOST_CHECK("/index.html" == req.uri.path.raw());
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
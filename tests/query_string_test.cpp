@@ -0,0 +1,152 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "query_string.h"
+
+#include <vector>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+typedef std::vector<uri::query_param_t> params_t;
+
+params_t P(const std::string &test, int flags = 0)
+{
+    uri::query_string qs(boost::string_ref(test), flags);
+    params_t params(qs.begin(), qs.end());
+
+    std::cerr << "TEST: |" << test << "| " << params.size() << " pairs" << std::endl;
+    return params;
+}
+
+BOOST_AUTO_TEST_CASE(split_pairs)
+{
+    std::string query("foo=1&goo=2&flag&empty=");
+    params_t params = P(query);
+    BOOST_REQUIRE(4 == params.size());
+
+    BOOST_CHECK("foo"   == params[0].key);
+    BOOST_CHECK("1"     == params[0].value);
+    BOOST_CHECK(true    == params[0].has_value);
+    BOOST_CHECK("goo"   == params[1].key);
+    BOOST_CHECK("2"     == params[1].value);
+    BOOST_CHECK("flag"  == params[2].key);
+    BOOST_CHECK(false   == params[2].has_value);
+    BOOST_CHECK("empty" == params[3].key);
+    BOOST_CHECK(""      == params[3].value);
+    BOOST_CHECK(true    == params[3].has_value);
+
+    // pairs point into the original bytes
+    BOOST_CHECK(query.data() == params[0].key.data());
+}
+
+BOOST_AUTO_TEST_CASE(empty_pairs_are_skipped)
+{
+    BOOST_CHECK(0 == P("").size());
+    BOOST_CHECK(0 == P("&").size());
+    BOOST_CHECK(0 == P("&&&").size());
+    BOOST_CHECK(2 == P("&a=1&&b=2&").size());
+}
+
+BOOST_AUTO_TEST_CASE(encoded_ampersand_stays_in_value)
+{
+    std::string query("q=salt%26pepper&x=1");
+    params_t params = P(query);
+    BOOST_REQUIRE(2 == params.size());
+    BOOST_CHECK("salt%26pepper" == params[0].value);
+
+    uri::query_string qs(query.data(), query.data() + query.size());
+    std::string scratch;
+    BOOST_CHECK("salt&pepper" == qs.decode(params[0].value, scratch));
+}
+
+BOOST_AUTO_TEST_CASE(decode_shares_raw_bytes)
+{
+    std::string query("name=plain");
+    uri::query_string qs(query.data(), query.data() + query.size());
+    std::string scratch;
+    boost::string_ref value = qs.decode(qs.begin()->value, scratch);
+    BOOST_CHECK("plain" == value);
+    BOOST_CHECK(query.data() + 5 == value.data());
+    BOOST_CHECK(scratch.empty());
+}
+
+BOOST_AUTO_TEST_CASE(plus_as_space)
+{
+    std::string query("q=hello+world%21");
+    std::string scratch;
+
+    uri::query_string plain(query.data(), query.data() + query.size());
+    BOOST_CHECK("hello+world!" == plain.decode(plain.begin()->value, scratch));
+
+    uri::query_string form(query.data(), query.data() + query.size(), uri::query_string::plus_as_space);
+    BOOST_CHECK("hello world!" == form.decode(form.begin()->value, scratch));
+}
+
+BOOST_AUTO_TEST_CASE(malformed_escapes_pass_through)
+{
+    std::string out;
+    std::string raw("100%+%zz%4");
+    uri::percent_decode(raw.data(), raw.data() + raw.size(), out);
+    BOOST_CHECK("100%+%zz%4" == out);
+}
+
+BOOST_AUTO_TEST_CASE(find_single_key)
+{
+    std::string query("a=1&b=2&c=3");
+    uri::query_string qs(query.data(), query.data() + query.size());
+    uri::query_param_t found;
+
+    BOOST_CHECK(true  == qs.find("b", found));
+    BOOST_CHECK("2"   == found.value);
+    BOOST_CHECK(false == qs.find("d", found));
+    BOOST_CHECK(false == qs.find("", found));
+}
+
+BOOST_AUTO_TEST_CASE(find_many_keys_in_one_pass)
+{
+    std::string query("utm_source=mail&id=42&session%5Fid=abc&id=43&lang=en");
+    uri::query_string qs(query.data(), query.data() + query.size());
+
+    boost::string_ref keys[] = { "lang", "session_id", "id", "missing" };
+    uri::query_param_t found[4];
+
+    BOOST_CHECK(3    == qs.find(keys, 4, found));
+    BOOST_CHECK("en" == found[0].value);
+    BOOST_CHECK("abc"== found[1].value);
+    BOOST_CHECK("42" == found[2].value);  // first one wins
+    BOOST_CHECK(found[3].key.empty());
+}
+
+BOOST_AUTO_TEST_CASE(find_repeated_and_many_keys)
+{
+    std::string query("a=1&b=2");
+    uri::query_string qs(query.data(), query.data() + query.size());
+
+    boost::string_ref keys[70] = { "b", "a", "b" };
+    uri::query_param_t found[70];
+    BOOST_CHECK(3   == qs.find(keys, 3, found));
+    BOOST_CHECK("2" == found[0].value);
+    BOOST_CHECK("1" == found[1].value);
+    BOOST_CHECK("2" == found[2].value);
+
+    // keys past the 64th are not looked up
+    for (std::size_t i = 0; i < 70; ++i) {
+        keys[i] = i == 68 ? "b" : "a";
+        found[i] = uri::query_param_t();
+    }
+    BOOST_CHECK(64  == qs.find(keys, 70, found));
+    BOOST_CHECK("1" == found[63].value);
+    BOOST_CHECK(found[68].key.empty());
+}
+
+BOOST_AUTO_TEST_CASE(decoded_key_compare)
+{
+    BOOST_CHECK(true  == uri::decoded_equals("a%20b", "a b"));
+    BOOST_CHECK(true  == uri::decoded_equals("a+b", "a b", true));
+    BOOST_CHECK(false == uri::decoded_equals("a+b", "a b", false));
+    BOOST_CHECK(false == uri::decoded_equals("a%20", "a b"));
+    BOOST_CHECK(false == uri::decoded_equals("a%20bc", "a b"));
+    BOOST_CHECK(true  == uri::decoded_equals("", ""));
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
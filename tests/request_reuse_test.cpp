@@ -0,0 +1,160 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "http11_parser.h"
+#include "spirit_parsers.h"
+#include "alloc_counter.h"
+
+#include <type_traits>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+// Requests of a keep-alive connection, with values too long for the short
+// string buffer and a repeated header.
+const char *requests[] = {
+    "GET /search?q=spirit+parsers&page=3 HTTP/1.1\r\n"
+    "Host: www.makefile.com\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:49.0) Gecko/20100101 Firefox/49.0\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+    "Cookie: session_id=4f9c2a1be0d34c58; theme=dark; tz=America%2FNew_York\r\n"
+    "\r\n",
+
+    "POST /api/v1/users?notify=true HTTP/1.1\r\n"
+    "Host: api.makefile.com\r\n"
+    "Content-Type: application/json\r\n"
+    "Content-Length: 42\r\n"
+    "X-Forwarded-For: 203.0.113.7\r\n"
+    "X-Forwarded-For: 198.51.100.23\r\n"
+    "\r\n",
+
+    "GET http://[2001:db8::1]:8080/a%20b HTTP/1.0\r\n"
+    "\r\n",
+};
+const std::size_t request_count = sizeof(requests) / sizeof(requests[0]);
+
+template <typename Parse>
+std::size_t P(Parse parse, int rounds)
+{
+    std::size_t before = allocations;
+    for (int round = 0; round < rounds; ++round) {
+        for (std::size_t i = 0; i < request_count; ++i) {
+            const char *first = requests[i];
+            const char *last = first + std::strlen(first);
+            BOOST_REQUIRE(true == parse(first, last));
+            BOOST_REQUIRE(first == last - 2);
+        }
+    }
+    std::size_t made = allocations - before;
+    std::cerr << "TEST: " << rounds << " rounds, " << made << " allocations" << std::endl;
+    return made;
+}
+
+BOOST_AUTO_TEST_CASE(clear_keeps_contents_out)
+{
+    http11::request_t req;
+    http11::request_parser<const char *> grammar(req);
+    const char *first = requests[1];
+    BOOST_CHECK(true == boost::spirit::qi::parse(first, first + std::strlen(first), grammar));
+    BOOST_CHECK(4 == req.headers.size());
+    BOOST_CHECK("203.0.113.7" == req.headers["X-Forwarded-For"]);
+
+    req.clear();
+    BOOST_CHECK(req.method.empty());
+    BOOST_CHECK(http11::version_t() == req.version);
+    BOOST_CHECK(false == req.uri.path.defined());
+    BOOST_CHECK(0 == req.headers.size());
+    BOOST_CHECK(0 == req.headers.count("Host"));
+    BOOST_CHECK(req.headers.begin() == req.headers.end());
+}
+
+BOOST_AUTO_TEST_CASE(moved_from_is_reusable)
+{
+    http11::request_t a;
+    const char *first = requests[1];
+    BOOST_CHECK(true == http11::parse_request(first, first + std::strlen(first), a));
+    BOOST_CHECK(4 == a.headers.size());
+
+    http11::request_t b = std::move(a);
+    BOOST_CHECK(4 == b.headers.size());
+    BOOST_CHECK("203.0.113.7" == b.headers["X-Forwarded-For"]);
+    BOOST_CHECK(0 == a.headers.size());
+    BOOST_CHECK(a.headers.begin() == a.headers.end());
+
+    a.clear();
+    first = requests[0];
+    BOOST_CHECK(true == http11::parse_request(first, first + std::strlen(first), a));
+    BOOST_CHECK(4 == a.headers.size());
+    BOOST_CHECK("www.makefile.com" == a.headers["Host"]);
+
+    b = std::move(a);
+    BOOST_CHECK(4 == b.headers.size());
+    BOOST_CHECK(0 == a.headers.size());
+
+    // so that a growing std::vector<request_t> moves rather than copies
+    BOOST_CHECK(true == std::is_nothrow_move_constructible<http11::request_t>::value);
+    BOOST_CHECK(true == std::is_nothrow_move_assignable<http11::request_t>::value);
+}
+
+BOOST_AUTO_TEST_CASE(header_container)
+{
+    http11::header_container_t headers;
+    BOOST_CHECK(true == headers.insert(std::make_pair(std::string("B"), std::string("1"))).second);
+    BOOST_CHECK(true == headers.insert(std::make_pair(std::string("A"), std::string("2"))).second);
+    BOOST_CHECK(false == headers.insert(std::make_pair(std::string("B"), std::string("3"))).second);
+    BOOST_CHECK("1" == headers["B"]);
+    BOOST_CHECK(2 == headers.size());
+
+    // In the order added.
+    BOOST_CHECK("B" == headers.begin()->first);
+    headers["C"] = "4";
+    BOOST_CHECK(3 == headers.size());
+    BOOST_CHECK("C" == (headers.end() - 1)->first);
+
+    headers.clear();
+    BOOST_CHECK(true == headers.empty());
+    BOOST_CHECK(headers.end() == headers.find("B"));
+    BOOST_CHECK(headers["B"].empty());
+}
+
+BOOST_AUTO_TEST_CASE(header_references_stay_valid)
+{
+    // As with std::map, a reference outlives later insertions.
+    http11::header_container_t headers;
+    std::string &host = headers["Host"];
+    const std::string *address = &host;
+    for (int i = 0; i < 100; ++i) {
+        headers["X-" + std::to_string(i)] = "v";
+    }
+    host = "makefile.com";
+    BOOST_CHECK(address == &headers["Host"]);
+    BOOST_CHECK("makefile.com" == headers["Host"]);
+    BOOST_CHECK(101 == headers.size());
+}
+
+BOOST_AUTO_TEST_CASE(steady_state_grammar)
+{
+    http11::request_t req;
+    http11::request_parser<const char *> grammar(req);
+    auto parse = [&](const char *&first, const char *last) {
+        req.clear();
+        return boost::spirit::qi::parse(first, last, grammar);
+    };
+
+    // The first round sizes the buffers, after that nothing is allocated.
+    P(parse, 1);
+    BOOST_CHECK(0 == P(parse, 100));
+    BOOST_CHECK(0 == req.headers.size());
+}
+
+BOOST_AUTO_TEST_CASE(steady_state_facade)
+{
+    http11::request_t req;
+    auto parse = [&](const char *&first, const char *last) {
+        return http11::parse_request(first, last, req);
+    };
+
+    P(parse, 1);
+    BOOST_CHECK(0 == P(parse, 100));
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
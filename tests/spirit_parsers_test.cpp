@@ -0,0 +1,92 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "spirit_parsers.h"
+
+#include <cstring>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+BOOST_AUTO_TEST_CASE(uri_from_pointers)
+{
+    const char *input = "http://user@makefile.com:8080/a/b?q=1#top";
+    const char *first = input;
+    const char *last = input + std::strlen(input);
+
+    uri::uri_t uri;
+    BOOST_CHECK(true == uri::parse_uri(first, last, uri));
+    BOOST_CHECK(first == last);
+    BOOST_CHECK("http" == uri.scheme);
+    BOOST_CHECK("user" == uri.user_info);
+    BOOST_CHECK("makefile.com" == uri.host);
+    BOOST_CHECK("8080" == uri.port);
+    BOOST_CHECK("/a/b" == uri.path);
+    BOOST_CHECK("q=1" == uri.query);
+    BOOST_CHECK("top" == uri.fragment);
+}
+
+BOOST_AUTO_TEST_CASE(uri_from_string)
+{
+    std::string input = "/some/%66ile";
+    std::string::const_iterator first = input.begin();
+
+    uri::uri_t uri;
+    BOOST_CHECK(true == uri::parse_uri(first, input.end(), uri));
+    BOOST_CHECK("/some/file" == uri.path);
+    BOOST_CHECK(false == uri.scheme.defined());
+
+    // Nothing from a previous parse leaks into the next one.
+    std::string other = "http://makefile.com";
+    first = other.begin();
+    BOOST_CHECK(true == uri::parse_uri(first, other.end(), uri));
+    BOOST_CHECK("makefile.com" == uri.host);
+    BOOST_CHECK("" == uri.path);
+    BOOST_CHECK(false == uri.query.defined());
+}
+
+BOOST_AUTO_TEST_CASE(addresses)
+{
+    std::string parsed;
+
+    const char *v4 = "192.168.0.1";
+    const char *first = v4;
+    BOOST_CHECK(true == uri::parse_ipv4_address(first, v4 + std::strlen(v4), parsed));
+    BOOST_CHECK("192.168.0.1" == parsed);
+
+    const char *bad = "256.0.0.1";
+    first = bad;
+    BOOST_CHECK(false == uri::parse_ipv4_address(first, bad + std::strlen(bad), parsed));
+
+    std::string v6 = "fe80::1:2";
+    std::string::const_iterator cur = v6.begin();
+    BOOST_CHECK(true == uri::parse_ipv6_address(cur, v6.end(), parsed));
+    BOOST_CHECK("fe80::1:2" == parsed);
+}
+
+BOOST_AUTO_TEST_CASE(request)
+{
+    std::string input = "GET /index.html HTTP/1.1\r\nHost: makefile.com\r\nX-Test: goobers\r\n";
+    std::string::const_iterator first = input.begin();
+
+    http11::request_t req;
+    BOOST_CHECK(true == http11::parse_request(first, input.end(), req));
+    BOOST_CHECK("GET" == req.method);
+    BOOST_CHECK(http11::version_t(1, 1) == req.version);
+    BOOST_CHECK("/index.html" == req.uri.path);
+    BOOST_CHECK("makefile.com" == req.headers["Host"]);
+    BOOST_CHECK("goobers" == req.headers["X-Test"]);
+
+    const char *next = "POST / HTTP/1.0\r\nHost: other\r\n";
+    const char *cur = next;
+    BOOST_CHECK(true == http11::parse_request(cur, next + std::strlen(next), req));
+    BOOST_CHECK("POST" == req.method);
+    BOOST_CHECK(http11::version_t(1, 0) == req.version);
+    BOOST_CHECK(1 == req.headers.size());
+    BOOST_CHECK("other" == req.headers["Host"]);
+
+    const char *lower = "get / HTTP/1.1\r\n";
+    cur = lower;
+    BOOST_CHECK(false == http11::parse_request(cur, lower + std::strlen(lower), req));
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
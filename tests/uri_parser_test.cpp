@@ -29,7 +29,10 @@ bool P(uri::uri_t &uri, const T &test)
 
 bool P(uri::uri_t &uri, const char *test)
 {
-    return P(uri, std::string(test));
+    // uri_t refers to the parsed text, keep it alive for the checks
+    static std::string input;
+    input = test;
+    return P(uri, input);
 }
 
 BOOST_AUTO_TEST_CASE(opaque_uri)
@@ -56,6 +59,101 @@ BOOST_AUTO_TEST_CASE(abs_uri_pct_encoded_host)
     BOOST_CHECK("makefile.com" == uri.host);
 }
 
+BOOST_AUTO_TEST_CASE(raw_and_decoded_components)
+{
+    uri::uri_t uri;
+    BOOST_CHECK(true == P(uri, "http://j%6fe@%6dakefile.com:80/a%20b?q=salt%26pepper#f%21"));
+    BOOST_CHECK("j%6fe@%6dakefile.com:80"   == uri.authority.raw());
+    BOOST_CHECK("j%6fe"                     == uri.user_info.raw());
+    BOOST_CHECK("joe"                       == uri.user_info);
+    BOOST_CHECK("%6dakefile.com"            == uri.host.raw());
+    BOOST_CHECK("makefile.com"              == uri.host);
+    BOOST_CHECK("/a%20b"                    == uri.path.raw());
+    BOOST_CHECK("/a b"                      == uri.path);
+    BOOST_CHECK("q=salt%26pepper"           == uri.query.raw());
+    BOOST_CHECK("q=salt&pepper"             == uri.query);
+    BOOST_CHECK("f%21"                      == uri.fragment.raw());
+    BOOST_CHECK("f!"                        == uri.fragment);
+}
+
+BOOST_AUTO_TEST_CASE(unescaped_components_share_input)
+{
+    uri::uri_t uri;
+    std::string text("http://makefile.com/index.html?x=1");
+    BOOST_CHECK(true == P(uri, text));
+    BOOST_CHECK(false == uri.host.escaped());
+    BOOST_CHECK(text.data() + 7  == uri.host.decoded().data());
+    BOOST_CHECK(text.data() + 19 == uri.path.decoded().data());
+    BOOST_CHECK(text.data() + 31 == uri.query.decoded().data());
+}
+
+BOOST_AUTO_TEST_CASE(component_presence)
+{
+    uri::uri_t uri;
+    BOOST_CHECK(true == P(uri, "http://makefile.com/?"));
+    BOOST_CHECK(true  == uri.authority.defined());
+    BOOST_CHECK(true  == uri.query.defined());
+    BOOST_CHECK(true  == uri.query.empty());
+    BOOST_CHECK(false == uri.fragment.defined());
+
+    BOOST_CHECK(true == P(uri, "/a#"));
+    BOOST_CHECK(false == uri.scheme.defined());
+    BOOST_CHECK(false == uri.authority.defined());
+    BOOST_CHECK(false == uri.query.defined());
+    BOOST_CHECK(true  == uri.fragment.defined());
+
+    BOOST_CHECK(true == P(uri, "https://[FFFF:1:2::10.0.0.1]:443/"));
+    BOOST_CHECK("FFFF:1:2::10.0.0.1"        == uri.host.raw());
+    BOOST_CHECK("[FFFF:1:2::10.0.0.1]:443"  == uri.authority.raw());
+}
+
+BOOST_AUTO_TEST_CASE(failed_authority_leaves_no_components)
+{
+    uri::uri_t uri;
+    BOOST_CHECK(true == P(uri, "http://joe@/x"));
+    BOOST_CHECK("http"  == uri.scheme);
+    BOOST_CHECK(false   == uri.authority.defined());
+    BOOST_CHECK(false   == uri.user_info.defined());
+    BOOST_CHECK("/"     == uri.path);
+}
+
+BOOST_AUTO_TEST_CASE(numeric_port)
+{
+    uri::uri_t uri;
+    BOOST_CHECK(true == P(uri, "http://makefile.com:8080/"));
+    BOOST_CHECK(8080 == uri.port_number);
+    BOOST_CHECK(uri::port_present == uri.port_state());
+
+    BOOST_CHECK(true == P(uri, "http://makefile.com:65535/"));
+    BOOST_CHECK(65535 == uri.port_number);
+
+    BOOST_CHECK(true == P(uri, "http://makefile.com:0080/"));
+    BOOST_CHECK(80 == uri.port_number);
+    BOOST_CHECK("0080" == uri.port.raw());
+
+    BOOST_CHECK(true == P(uri, "http://makefile.com:/"));
+    BOOST_CHECK(0 == uri.port_number);
+    BOOST_CHECK(uri::port_empty == uri.port_state());
+
+    BOOST_CHECK(true == P(uri, "http://makefile.com/"));
+    BOOST_CHECK(0 == uri.port_number);
+    BOOST_CHECK(uri::port_absent == uri.port_state());
+
+    BOOST_CHECK(true == P(uri, "http://[::1]:443/"));
+    BOOST_CHECK(443 == uri.port_number);
+
+    // Too large: the port is rejected and the authority ends at the host,
+    // leaving ":65536/" unparsed.
+    BOOST_CHECK(true == P(uri, "http://makefile.com:65536/"));
+    BOOST_CHECK("makefile.com" == uri.authority.raw());
+    BOOST_CHECK(uri::port_absent == uri.port_state());
+    BOOST_CHECK(0 == uri.port_number);
+    BOOST_CHECK("" == uri.path);
+
+    BOOST_CHECK(true == P(uri, "http://makefile.com:99999999999999999999/"));
+    BOOST_CHECK(uri::port_absent == uri.port_state());
+}
+
 BOOST_AUTO_TEST_CASE(abs_uri_components)
 {
     uri::uri_t uri;
@@ -0,0 +1,165 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "uri_resolve.h"
+
+#include <list>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+// uri_t refers to the text it was parsed from, keep every input alive.
+const std::string &keep(const std::string &text)
+{
+    static std::list<std::string> inputs;
+    inputs.push_back(text);
+    return inputs.back();
+}
+
+bool parse(uri::uri_t &uri, const std::string &input)
+{
+    const std::string &text = keep(input);
+    using boost::spirit::qi::parse;
+
+    std::string::const_iterator begin = text.begin();
+    std::string::const_iterator end = text.end();
+
+    uri::uri_t new_uri;
+    uri = new_uri;
+
+    uri::uri_parser<std::string::const_iterator> grammar(uri);
+    return parse(begin, end, grammar) && begin == end;
+}
+
+std::string R(const std::string &ref)
+{
+    uri::uri_t base;
+    uri::uri_t rel;
+    BOOST_REQUIRE(parse(base, "http://a/b/c/d;p?q"));
+    BOOST_REQUIRE(parse(rel, ref));
+
+    std::string out = uri::resolve(base, rel);
+    std::cerr << "RESOLVE: |" << ref << "| -> |" << out << "|" << std::endl;
+    return out;
+}
+
+std::string D(const std::string &path)
+{
+    std::string out(path);
+    uri::remove_dot_segments(out);
+    return out;
+}
+
+BOOST_AUTO_TEST_CASE(remove_dot_segments)
+{
+    BOOST_CHECK("/a/g"      == D("/a/b/c/./../../g"));
+    BOOST_CHECK("mid/6"     == D("mid/content=5/../6"));
+    BOOST_CHECK("/"         == D("/."));
+    BOOST_CHECK("/"         == D("/.."));
+    BOOST_CHECK(""          == D("."));
+    BOOST_CHECK(""          == D(".."));
+    BOOST_CHECK("/a/"       == D("/a/b/.."));
+    BOOST_CHECK("/a/b/"     == D("/a/b/."));
+    BOOST_CHECK("/a/b"      == D("/a/b"));
+    BOOST_CHECK(""          == D(""));
+}
+
+BOOST_AUTO_TEST_CASE(remove_dot_segments_leaves_prefix)
+{
+    std::string out("http://a/b/../c");
+    uri::remove_dot_segments(out, 8);
+    BOOST_CHECK("http://a/c" == out);
+}
+
+// RFC 3986 section 5.4.1
+BOOST_AUTO_TEST_CASE(normal_examples)
+{
+    BOOST_CHECK("g:h"                   == R("g:h"));
+    BOOST_CHECK("http://a/b/c/g"        == R("g"));
+    BOOST_CHECK("http://a/b/c/g"        == R("./g"));
+    BOOST_CHECK("http://a/b/c/g/"       == R("g/"));
+    BOOST_CHECK("http://a/g"            == R("/g"));
+    BOOST_CHECK("http://g"              == R("//g"));
+    BOOST_CHECK("http://a/b/c/d;p?y"    == R("?y"));
+    BOOST_CHECK("http://a/b/c/g?y"      == R("g?y"));
+    BOOST_CHECK("http://a/b/c/d;p?q#s"  == R("#s"));
+    BOOST_CHECK("http://a/b/c/g#s"      == R("g#s"));
+    BOOST_CHECK("http://a/b/c/g?y#s"    == R("g?y#s"));
+    BOOST_CHECK("http://a/b/c/;x"       == R(";x"));
+    BOOST_CHECK("http://a/b/c/g;x"      == R("g;x"));
+    BOOST_CHECK("http://a/b/c/g;x?y#s"  == R("g;x?y#s"));
+    BOOST_CHECK("http://a/b/c/d;p?q"    == R(""));
+    BOOST_CHECK("http://a/b/c/"         == R("."));
+    BOOST_CHECK("http://a/b/c/"         == R("./"));
+    BOOST_CHECK("http://a/b/"           == R(".."));
+    BOOST_CHECK("http://a/b/"           == R("../"));
+    BOOST_CHECK("http://a/b/g"          == R("../g"));
+    BOOST_CHECK("http://a/"             == R("../.."));
+    BOOST_CHECK("http://a/"             == R("../../"));
+    BOOST_CHECK("http://a/g"            == R("../../g"));
+}
+
+// RFC 3986 section 5.4.2
+BOOST_AUTO_TEST_CASE(abnormal_examples)
+{
+    BOOST_CHECK("http://a/g"            == R("../../../g"));
+    BOOST_CHECK("http://a/g"            == R("../../../../g"));
+
+    BOOST_CHECK("http://a/g"            == R("/./g"));
+    BOOST_CHECK("http://a/g"            == R("/../g"));
+    BOOST_CHECK("http://a/b/c/g."       == R("g."));
+    BOOST_CHECK("http://a/b/c/.g"       == R(".g"));
+    BOOST_CHECK("http://a/b/c/g.."      == R("g.."));
+    BOOST_CHECK("http://a/b/c/..g"      == R("..g"));
+
+    BOOST_CHECK("http://a/b/g"          == R("./../g"));
+    BOOST_CHECK("http://a/b/c/g/"       == R("./g/."));
+    BOOST_CHECK("http://a/b/c/g/h"      == R("g/./h"));
+    BOOST_CHECK("http://a/b/c/h"        == R("g/../h"));
+    BOOST_CHECK("http://a/b/c/g;x=1/y"  == R("g;x=1/./y"));
+    BOOST_CHECK("http://a/b/c/y"        == R("g;x=1/../y"));
+
+    BOOST_CHECK("http://a/b/c/g?y/./x"  == R("g?y/./x"));
+    BOOST_CHECK("http://a/b/c/g?y/../x" == R("g?y/../x"));
+    BOOST_CHECK("http://a/b/c/g#s/./x"  == R("g#s/./x"));
+    BOOST_CHECK("http://a/b/c/g#s/../x" == R("g#s/../x"));
+
+    BOOST_CHECK("http:g"                == R("http:g"));
+}
+
+BOOST_AUTO_TEST_CASE(authority_recomposition)
+{
+    uri::uri_t base;
+    uri::uri_t rel;
+    BOOST_REQUIRE(parse(base, "https://joe:letmein@[FFFF:1:2::10.0.0.1]:8443/a/b"));
+    BOOST_REQUIRE(parse(rel, "../c?x=1"));
+    BOOST_CHECK("https://joe:letmein@[FFFF:1:2::10.0.0.1]:8443/c?x=1" == uri::resolve(base, rel));
+
+    BOOST_REQUIRE(parse(rel, "d%20e?x=a%26b#f%21"));
+    BOOST_CHECK("https://joe:letmein@[FFFF:1:2::10.0.0.1]:8443/a/d%20e?x=a%26b#f%21" == uri::resolve(base, rel));
+
+    BOOST_REQUIRE(parse(base, "http://makefile.com"));
+    BOOST_REQUIRE(parse(rel, "index.html"));
+    BOOST_CHECK("http://makefile.com/index.html" == uri::resolve(base, rel));
+}
+
+BOOST_AUTO_TEST_CASE(output_buffer_is_reused)
+{
+    uri::uri_t base;
+    uri::uri_t rel;
+    BOOST_REQUIRE(parse(base, "http://a/b/c/d;p?q"));
+
+    std::string out;
+    out.reserve(256);
+    const char *storage = out.data();
+
+    BOOST_REQUIRE(parse(rel, "../../g"));
+    uri::resolve(base, rel, out);
+    BOOST_CHECK("http://a/g" == out);
+
+    BOOST_REQUIRE(parse(rel, "g;x?y#s"));
+    uri::resolve(base, rel, out);
+    BOOST_CHECK("http://a/b/c/g;x?y#s" == out);
+    BOOST_CHECK(storage == out.data());
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
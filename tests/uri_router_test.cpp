@@ -0,0 +1,162 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "uri_parser.h"
+#include "uri_router.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+uri::route_match_t P(const uri::router &routes, const char *path)
+{
+    uri::route_match_t m = routes.match(boost::string_ref(path));
+    std::cerr << "TEST: |" << path << "| route " << m.route << " captures " << m.captures << std::endl;
+    return m;
+}
+
+BOOST_AUTO_TEST_CASE(literals_and_captures)
+{
+    uri::router routes;
+    int root = routes.add("/");
+    int users = routes.add("/users");
+    int user = routes.add("/users/{id}");
+    int post = routes.add("/users/{id}/posts/{slug}");
+    int me = routes.add("/users/me");
+    BOOST_CHECK(5 == routes.size());
+
+    BOOST_CHECK(root == P(routes, "/").route);
+    BOOST_CHECK(root == P(routes, "").route);
+    BOOST_CHECK(users == P(routes, "/users").route);
+    BOOST_CHECK(me == P(routes, "/users/me").route);
+
+    uri::route_match_t m = P(routes, "/users/42");
+    BOOST_CHECK(user == m.route);
+    BOOST_CHECK(1 == m.captures);
+    BOOST_CHECK("42" == m.capture[0]);
+
+    const std::string path("/users/42/posts/hello%20world");
+    m = routes.match(boost::string_ref(path));
+    BOOST_CHECK(post == m.route);
+    BOOST_CHECK(2 == m.captures);
+    BOOST_CHECK("42" == routes.capture(m, "id"));
+    BOOST_CHECK("hello%20world" == routes.capture(m, "slug"));
+    BOOST_CHECK(path.data() + 16 == routes.capture(m, "slug").data());
+    BOOST_CHECK(routes.capture(m, "nope").empty());
+    BOOST_CHECK("slug" == routes.captures(post)[1]);
+
+    // Literal "me" wins over {id} for good, even where only the
+    // placeholder leads anywhere.
+    m = P(routes, "/users/me/posts/x");
+    BOOST_CHECK(false == m.matched());
+    BOOST_CHECK(0 == m.captures);
+
+    BOOST_CHECK(false == P(routes, "/users/").matched());
+    BOOST_CHECK(false == P(routes, "/users//posts/x").matched());
+    BOOST_CHECK(false == P(routes, "/users/42/posts").matched());
+    BOOST_CHECK(false == P(routes, "/Users").matched());
+    BOOST_CHECK(false == P(routes, "users").matched());
+}
+
+BOOST_AUTO_TEST_CASE(bad_patterns)
+{
+    uri::router routes;
+    BOOST_CHECK(0 == routes.add("/a/{x}"));
+    BOOST_CHECK(-1 == routes.add("/a/{y}"));  // same route
+    BOOST_CHECK(-1 == routes.add("a"));
+    BOOST_CHECK(-1 == routes.add(""));
+    BOOST_CHECK(-1 == routes.add("/a b"));
+    BOOST_CHECK(-1 == routes.add("/a?b"));
+    BOOST_CHECK(-1 == routes.add("/%zz"));
+    BOOST_CHECK(-1 == routes.add("/{a}/{b}/{c}/{d}/{e}/{f}/{g}/{h}/{i}"));
+    BOOST_CHECK(1 == routes.add("/{a}/{b}/{c}/{d}/{e}/{f}/{g}/{h}"));
+    BOOST_CHECK(2 == routes.add("/a/%7E/"));
+    BOOST_CHECK(3 == routes.size());
+}
+
+BOOST_AUTO_TEST_CASE(trailing_slash_and_depth)
+{
+    uri::router routes;
+    int dir = routes.add("/files/");
+    int file = routes.add("/files/{name}");
+
+    BOOST_CHECK(dir == P(routes, "/files/").route);
+    BOOST_CHECK(file == P(routes, "/files/a").route);
+    BOOST_CHECK(false == P(routes, "/files").matched());
+
+    std::string deep;
+    for (int i = 0; i < uri::router::max_segments + 1; ++i) {
+        deep += "/x";
+    }
+    BOOST_CHECK(false == routes.match(boost::string_ref(deep)).matched());
+}
+
+BOOST_AUTO_TEST_CASE(literal_and_placeholder_at_every_depth)
+{
+    // Route i is i "a" segments, a placeholder, then "b" segments up to the
+    // full depth, so every level has both a literal and a placeholder
+    // child; a walk that went back from a failed literal branch would try
+    // the placeholder at every level of a path that misses.
+    const int depth = uri::router::max_segments;
+    uri::router routes;
+    std::vector<std::string> as(1), bs(1);
+    for (int i = 1; i < depth; ++i) {
+        as.push_back(as.back() + "/a");
+        bs.push_back(bs.back() + "/b");
+    }
+    for (int i = 0; i < depth; ++i) {
+        BOOST_CHECK(i == routes.add(as[i] + "/{p}" + bs[depth - 1 - i]));
+    }
+
+    for (int i = 0; i < depth; ++i) {
+        const std::string path = as[i] + "/x" + bs[depth - 1 - i];
+        uri::route_match_t m = routes.match(boost::string_ref(path));
+        BOOST_CHECK(i == m.route);
+        BOOST_CHECK("x" == m.capture[0]);
+    }
+
+    // An "a" where route i has its placeholder is the literal of route i + 1.
+    const std::string literal = as[3] + "/a" + bs[depth - 4];
+    uri::route_match_t m = routes.match(boost::string_ref(literal));
+    BOOST_CHECK(4 == m.route);
+    BOOST_CHECK("b" == m.capture[0]);
+
+    const std::string miss = as[depth - 2] + "/x/c";
+    BOOST_CHECK(false == routes.match(boost::string_ref(miss)).matched());
+}
+
+BOOST_AUTO_TEST_CASE(parsed_paths)
+{
+    uri::router routes;
+    int item = routes.add("/api/v1/items/{id}");
+
+    const std::string input("http://makefile.com/api/v1/items/7?full=1");
+    uri::uri_t uri;
+    uri::uri_parser<std::string::const_iterator> grammar(uri);
+    std::string::const_iterator first = input.begin();
+    BOOST_CHECK(true == boost::spirit::qi::parse(first, input.end(), grammar));
+
+    uri::route_match_t m = routes.match(uri.path);
+    BOOST_CHECK(item == m.route);
+    BOOST_CHECK("7" == m.capture[0]);
+}
+
+BOOST_AUTO_TEST_CASE(many_routes)
+{
+    uri::router routes;
+    char pattern[64], path[64];
+    for (int i = 0; i < 3000; ++i) {
+        std::sprintf(pattern, "/api/r%d/{id}", i);
+        BOOST_CHECK(i == routes.add(pattern));
+    }
+    for (int i = 0; i < 3000; i += 97) {
+        std::sprintf(path, "/api/r%d/x%d", i, i);
+        uri::route_match_t m = routes.match(boost::string_ref(path));
+        BOOST_CHECK(i == m.route);
+        BOOST_CHECK(std::string(path + std::strlen(path) - m.capture[0].size()) == m.capture[0]);
+    }
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "uri_parser.h"
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+namespace qi = boost::spirit::qi;
+
+typedef std::string::const_iterator iterator_t;
+
+// Bytes consumed by rule at the start of test, -1 when it fails.
+int P(const qi::rule<iterator_t> &rule, const std::string &test)
+{
+    iterator_t first = test.begin();
+    if (!boost::spirit::qi::parse(first, test.end(), rule)) {
+        return -1;
+    }
+    return static_cast<int>(first - test.begin());
+}
+
+template <typename Rule>
+int P(const Rule &rule, const std::string &test)
+{
+    qi::rule<iterator_t> r = rule;
+    return P(r, test);
+}
+
+// Every string of up to four characters from an alphabet covering each
+// character class the path rules care about.
+std::vector<std::string> inputs()
+{
+    const char alphabet[] = "/a:%4G?#[@";
+    const std::size_t n = sizeof(alphabet) - 1;
+
+    std::vector<std::string> all(1, std::string());
+    for (std::size_t begin = 0, end = 1, len = 1; len <= 4; ++len) {
+        for (std::size_t i = begin; i < end; ++i) {
+            for (std::size_t c = 0; c < n; ++c) {
+                all.push_back(all[i] + alphabet[c]);
+            }
+        }
+        begin = end;
+        end = all.size();
+    }
+    return all;
+}
+
+BOOST_AUTO_TEST_CASE(paths_match_the_segment_rules)
+{
+    uri::uri_t uri;
+    uri::uri_parser<iterator_t> g(uri);
+
+    // The definitions the scanners replaced.
+    qi::rule<iterator_t> segment       = *g.pchar;
+    qi::rule<iterator_t> segment_nz    = +g.pchar;
+    qi::rule<iterator_t> segment_nz_nc = +(g.unreserved_char | g.pct_enc_char | g.sub_delims | qi::char_('@'));
+    qi::rule<iterator_t> abempty  = *(g.path_char >> segment);
+    qi::rule<iterator_t> absolute = g.path_char >> -(segment_nz >> *(g.path_char >> segment));
+    qi::rule<iterator_t> noscheme = segment_nz_nc >> *(g.path_char >> segment);
+    qi::rule<iterator_t> rootless = segment_nz >> *(g.path_char >> segment);
+    qi::rule<iterator_t> query    = *(g.pchar | qi::char_("/?"));
+
+    std::vector<std::string> tests = inputs();
+    std::size_t failures = 0;
+    for (std::size_t i = 0; i < tests.size(); ++i) {
+        const std::string &t = tests[i];
+        failures += P(abempty, t) != P(g.path_abempty, t);
+        failures += P(absolute, t) != P(g.path_absolute, t);
+        failures += P(noscheme, t) != P(g.path_noscheme, t);
+        failures += P(rootless, t) != P(g.path_rootless, t);
+        failures += P(query, t) != P(g.query_attr, t);
+    }
+    BOOST_CHECK(0 == failures);
+}
+
+BOOST_AUTO_TEST_CASE(dispatch_matches_the_alternatives)
+{
+    uri::uri_t old_uri, new_uri;
+    uri::uri_parser<iterator_t> old_grammar(old_uri), new_grammar(new_uri);
+    qi::rule<iterator_t> old_start = old_grammar.abs_uri | old_grammar.rel_uri | qi::string("*");
+
+    std::vector<std::string> tests = inputs();
+    const char *more[] = {
+        "http://makefile.com/a?q#f", "//makefile.com/x", "//joe@/x", "a:b", "a+b.c-d:x", "1a:b",
+        "makefile.com:443", "*", "/a//b", "?q", "#f", "", "http:", "[::1]",
+    };
+    tests.insert(tests.end(), more, more + sizeof(more) / sizeof(more[0]));
+
+    std::size_t failures = 0;
+    for (std::size_t i = 0; i < tests.size(); ++i) {
+        const std::string &t = tests[i];
+        old_uri = uri::uri_t();
+        new_uri = uri::uri_t();
+        int consumed = P(old_start, t);
+        if (consumed != P(new_grammar, t)
+            || old_uri.scheme.raw() != new_uri.scheme.raw()
+            || old_uri.authority.defined() != new_uri.authority.defined()
+            || old_uri.host.raw() != new_uri.host.raw()
+            || old_uri.path.raw() != new_uri.path.raw()
+            || old_uri.query.defined() != new_uri.query.defined()
+            || old_uri.query.raw() != new_uri.query.raw()
+            || old_uri.fragment.raw() != new_uri.fragment.raw()) {
+            std::cerr << "MISMATCH: |" << t << "| " << old_uri.to_string() << " / " << new_uri.to_string() << std::endl;
+            ++failures;
+        }
+    }
+    BOOST_CHECK(0 == failures);
+}
+
+//BOOST_AUTO_TEST_SUITE_END()
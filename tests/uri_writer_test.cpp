@@ -0,0 +1,155 @@
+#define BOOST_TEST_MODULE ParserTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "uri_parser.h"
+#include "uri_writer.h"
+
+#include <list>
+
+//BOOST_AUTO_TEST_SUITE(test_suite)
+
+// uri_t refers to the parsed text, keep every input alive for the checks
+const std::string &keep(const char *test)
+{
+    static std::list<std::string> inputs;
+    inputs.push_back(test);
+    return inputs.back();
+}
+
+bool P(uri::uri_t &uri, const char *test)
+{
+    const std::string &input = keep(test);
+    const char *first = input.data();
+    const char *last = first + input.size();
+
+    uri = uri::uri_t();
+    uri::uri_parser<const char *> grammar(uri);
+    bool pass = boost::spirit::qi::parse(first, last, grammar) && first == last;
+
+    std::cerr << "TEST: |" << test << "| " << uri.to_string() << std::endl;
+    return pass;
+}
+
+std::string W(const uri::uri_t &uri)
+{
+    char buf[256];
+    uri::buffer_writer out(buf, sizeof(buf));
+    uri::write(out, uri);
+    BOOST_REQUIRE(false == out.overflow());
+    return std::string(out.data(), out.size());
+}
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+    const char *tests[] = {
+        "http://makefile.com",
+        "http://makefile.com:",
+        "http://user:pw@makefile.com:8080/a/b?q=1&r#frag",
+        "http://[fe80::1]:80/",
+        "http://[v1.x]/",
+        "http://1.2.3.4/",
+        "//makefile.com?q#f",
+        "/a%20b?x%3Dy#%7E",
+        "relative/path",
+        "?q",
+        "#f",
+        "mailto:joe@makefile.com",
+        "",
+    };
+
+    uri::uri_t uri;
+    for (std::size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); ++i) {
+        BOOST_CHECK(true == P(uri, tests[i]));
+        BOOST_CHECK(tests[i] == W(uri));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(modified_components)
+{
+    uri::uri_t uri;
+    BOOST_CHECK(true == P(uri, "http://user@makefile.com:8080/a?q"));
+
+    const std::string host("upstream.local");
+    uri.host.assign(host.data(), host.data() + host.size());
+    uri.user_info.clear();
+    BOOST_CHECK("http://upstream.local:8080/a?q" == W(uri));
+
+    uri.port.clear();
+    uri.query.clear();
+    BOOST_CHECK("http://upstream.local/a" == W(uri));
+}
+
+BOOST_AUTO_TEST_CASE(buffer_too_small)
+{
+    uri::uri_t uri;
+    BOOST_CHECK(true == P(uri, "http://makefile.com/abc"));
+
+    char buf[8];
+    uri::buffer_writer out(buf, sizeof(buf));
+    uri::write(out, uri);
+    BOOST_CHECK(true == out.overflow());
+    BOOST_CHECK(23 == out.size());
+}
+
+BOOST_AUTO_TEST_CASE(iovecs)
+{
+    uri::uri_t uri;
+    BOOST_CHECK(true == P(uri, "http://user@makefile.com:8080/a?q#f"));
+    const std::string &input = keep("http://user@makefile.com:8080/a?q#f");
+
+    iovec iov[16];
+
+    // Without the source every separator is a literal.
+    uri::iovec_writer pieces(iov, 16);
+    uri::write(pieces, uri);
+    BOOST_CHECK(false == pieces.overflow());
+    BOOST_CHECK(input.size() == pieces.size());
+    BOOST_CHECK(12 == pieces.count());
+
+    // With it, the unmodified URI is one iovec over the input.
+    const char *source = uri.scheme.raw().data();
+    uri::iovec_writer merged(iov, 16, source, source + input.size());
+    uri::write(merged, uri);
+    BOOST_CHECK(1 == merged.count());
+    BOOST_CHECK(source == iov[0].iov_base);
+    BOOST_CHECK(input.size() == iov[0].iov_len);
+
+    // A replaced host splits it around the new bytes.
+    const std::string host("upstream.local");
+    uri.host.assign(host.data(), host.data() + host.size());
+    uri::iovec_writer modified(iov, 16, source, source + input.size());
+    uri::write(modified, uri);
+    BOOST_CHECK(4 == modified.count());
+    std::string joined;
+    for (std::size_t i = 0; i < modified.count(); ++i) {
+        joined.append(static_cast<const char *>(iov[i].iov_base), iov[i].iov_len);
+    }
+    BOOST_CHECK("http://user@upstream.local:8080/a?q#f" == joined);
+
+    // Too few iovecs: the count and size are still those needed.
+    uri::iovec_writer small(iov, 2, source, source + input.size());
+    uri::write(small, uri);
+    BOOST_CHECK(true == small.overflow());
+    BOOST_CHECK(4 == small.count());
+    BOOST_CHECK(joined.size() == small.size());
+
+    uri::iovec_writer one(iov, 1);
+    uri::write(one, uri);
+    BOOST_CHECK(true == one.overflow());
+    BOOST_CHECK(12 == one.count());
+    BOOST_CHECK(joined.size() == one.size());
+}
+
+BOOST_AUTO_TEST_CASE(iovec_numbers)
+{
+    // Numbers past the scratch buffer overflow, but their bytes count.
+    iovec iov[16];
+    uri::iovec_writer out(iov, 16);
+    for (int i = 0; i < 10; ++i) {
+        out.number(4294967295u);
+    }
+    BOOST_CHECK(true == out.overflow());
+    BOOST_CHECK(100 == out.size());
+}
+
+//BOOST_AUTO_TEST_SUITE_END()